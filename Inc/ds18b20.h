@@ -26,17 +26,19 @@
 /** Include error type */
 #include "errors.h"
 
+/** Include sample ring */
+#include "ds18b20_ring.h"
+
+/** Include debug messages, log_ds18b20 */
+#include "ds18b20_log.h"
+
+/** Include bus statistics */
+#include "ds18b20_stats.h"
+
 /******************************* INCLUDES END ********************************************** */
 
 /******************************* DEFINE BEGIN ********************************************** */
 
-// Debug DS18B20
-#ifdef DEBUG_DS18B20
-#include "console.h"
-#define log_ds18b20(...)  printf(__VA_ARGS__)
-#else
-#define log_ds18b20(...)
-#endif
 
 
 //DS18B20 ROM Commands
@@ -55,10 +57,90 @@
 #define RECALL_EE			0xB8
 #define READ_PWR_SUPPLY		0xB4
 
+// Family codes of the supported temperature sensors (first byte of the ROM code)
+#define DS18B20_FAMILY_DS18S20		0x10
+#define DS18B20_FAMILY_DS1822		0x22
+#define DS18B20_FAMILY_DS18B20		0x28
+#define DS18B20_FAMILY_MAX31850		0x3B
+
+// Fault bits of a MAX31850, in byte 2 of its scratchpad
+#define DS18B20_MAX31850_OC			0x01U	// Thermocouple open circuit
+#define DS18B20_MAX31850_SCG		0x02U	// Thermocouple short to GND
+#define DS18B20_MAX31850_SCV		0x04U	// Thermocouple short to VDD
+#define DS18B20_MAX31850_FAULTS		0x07U
+
+// Value of a free slot in a ROM codes array, which remains terminated by 0.
+// This is not a valid ROM code (family 0xFF does not exist).
+#define DS18B20_FREE_SLOT		0xFFFFFFFFFFFFFFFFULL
+
+// Scratchpad
+#define DS18B20_SCRATCHPAD_SIZE		9U		// 8 data bytes + CRC
+
+// Conversion time at 12-bit resolution, in ms, according to datasheet
+#define DS18B20_CONVERSION_TIMEOUT_MS	750U
+
+// Maximum duration of a COPY_SCRATCHPAD, in ms, according to datasheet
+#define DS18B20_COPY_TIME_MS			10U
+
+// Maximum current drawn by a parasite-powered sensor during a conversion, in µA
+#define DS18B20_CONVERSION_CURRENT_UA	1500U
+
+// Cost of a search in 1-Wire time slots, to budget DS18B20_SearchStep
+#define DS18B20_SEARCH_START_SLOTS		24U		// Reset and presence (16 slots) + SEARCH_ROM command
+#define DS18B20_SEARCH_BIT_SLOTS		3U		// Bit, complement and chosen direction
+
+// Resolution, in bits (9 to 12), and its encoding in the configuration register
+#define DS18B20_RESOLUTION_DEFAULT		12U
+#define DS18B20_RESOLUTION_TO_CONFIG(bits)	((uint8_t)((((bits) - 9U) << 5) | 0x1FU))
+
+// Power-on value of the temperature register (85°C, Q12.4), read if no conversion was done
+#define DS18B20_POWER_ON_VALUE			0x0550
+#define DS18B20_POWER_ON_MARGIN			32		// Q12.4, a last value this close makes 85°C plausible
+
+// Number of times a suspect value is converted and read again before it is marked invalid
+#define DS18B20_SANITY_RETRIES			1U
+
 /*********************************** DEFINE END ******************************************** */
 
 /******************************** TYPEDEF BEGIN ******************************************** */
 
+/* State kept for each sensor of a bus, indexed like the slots of its samples */
+typedef struct
+{
+	// Shadow of the TH, TL and configuration registers, updated on every scratchpad read
+	uint8_t th;
+	uint8_t tl;
+	uint8_t config;
+	bool shadow_valid;			// False until the first read, or after a write of unknown result
+
+	// Change detection of DS18B20_Deadband_Deliver, all 0 to deliver every sample
+	uint16_t deadband;			// Smallest change delivered, Q12.4 (16 = 1°C)
+	uint16_t hysteresis;		// Added to the deadband when the change reverses direction, Q12.4
+	uint32_t heartbeat_ms;		// A sample is delivered at least this often, 0 for never
+
+	// Last sample delivered
+	int16_t reported;
+	uint8_t reported_status;
+	int8_t trend;				// Direction of the last change delivered: -1, 0 or +1
+	uint32_t reported_at;		// Timestamp of the sample
+	bool reported_valid;		// False until the first delivery
+
+	// Filtering of DS18B20_Filter_Deliver, both 0 to deliver the raw values
+	bool median;				// Median of the last 3 values, rejects a single spike
+	uint8_t ema_shift;			// Exponential moving average, weight of a new value 1/2^ema_shift
+	int16_t previous[2];		// Last two raw values, newest first, Q12.4
+	uint8_t previous_count;		// Number of previous values known (0 to 2)
+	bool ema_valid;				// False until the first value
+	int32_t ema;				// Average, Q12.4 << ema_shift
+
+	// Sanity checks of DS18B20_ReadSample
+	uint16_t max_rate;			// Largest plausible change, Q12.4 per second, 0 for no check
+	int16_t accepted;			// Last value that passed the checks, Q12.4
+	uint32_t accepted_at;		// Timestamp of its sample
+	bool accepted_valid;		// False until the first value
+
+} DS18B20_Channel_t;
+
 /* DS18B20 structure */
 typedef struct
 {
@@ -70,8 +152,60 @@ typedef struct
     uint16_t gpio_pin;          // GPIO Pin number for the onewire of the sensor
     void (*gpio_clk_enable)(void);   // Pointer to the clock enable function for the chosen pin for the onewire
 
+    uint8_t resolution;         // Resolution of the sensors in bits (9 to 12), 0 means 12 bits
+
+    // Optional hook called to wait for the end of a conversion instead of polling the bus,
+    // e.g. DS18B20_SleepWait or DS18B20_StopWait. The timer is re-armed when it returns.
+    void (*conversion_wait)(void *context, uint32_t ms);
+    void *wait_context;         // Argument given to conversion_wait
+
+    // Strong pull-up for parasite-powered sensors. If pullup_port is NULL, the onewire pin
+    // itself is switched to push-pull high during conversions and EEPROM copies; otherwise
+    // pullup_pin drives the gate of a MOSFET between the bus and VDD.
+    GPIO_TypeDef * pullup_port;
+    uint16_t pullup_pin;
+    bool pullup_active_low;     // True for a P-channel MOSFET (gate low = pull-up on)
+
+    uint32_t pullup_current_ua; // Current the strong pull-up can supply, in µA, 0 if unlimited
+
+    bool parasite;              // Set by DS18B20_Init if a parasite-powered sensor is on the bus
+    bool pullup_on;             // Strong pull-up currently enabled
+
+    uint8_t bus_id;             // Identifies the bus in the traces
+    uint32_t reset_count;       // Number of reset pulses sent, lets a paused search detect other transactions
+
+    // Optional state of each sensor, one channel per slot of the ROM codes array
+    DS18B20_Channel_t *channels;
+    uint16_t channel_count;
+
+    DS18B20_Stats_t *stats;     // Optional counters of the bus, NULL if not needed
+
 } DS18B20_t;
 
+/* Result of a search step */
+typedef enum
+{
+	DS18B20_SEARCH_FOUND = 0,	// A device was found, its ROM code is valid
+	DS18B20_SEARCH_DONE,		// No more device on the bus
+	DS18B20_SEARCH_CRC_ERROR,	// A device was found, but its ROM code is not valid
+	DS18B20_SEARCH_BUS_ERROR,	// No device answered during the search, or no presence pulse after
+								// the first device: the search shall be started again
+	DS18B20_SEARCH_IN_PROGRESS,	// Slot budget used up, call DS18B20_SearchStep again
+
+} DS18B20_SearchStatus_t;
+
+/* Temperatures of a MAX31850 thermocouple interface */
+typedef struct
+{
+	int16_t temperature;		// Thermocouple temperature in Q12.4 format (0.25°C steps)
+	int16_t cold_junction;		// Cold-junction temperature in Q12.4 format
+	uint8_t faults;				// DS18B20_MAX31850_xxx fault bits, 0 if OK
+
+} DS18B20_Thermocouple_t;
+
+/* Function receiving the samples of a sweep */
+typedef void (*DS18B20_Deliver_t)(void *context, const DS18B20_Sample_t *sample);
+
 /* Search state structure */
 typedef struct {
 
@@ -87,6 +221,16 @@ typedef struct {
     // During a search this is overwritten LSB-first with a new address.
     uint8_t address[8];
 
+    // Progress of the device being searched, so that a search can be paused between two bits
+    bool in_progress;                   // Reset and SEARCH_ROM sent, bits left to walk
+    uint8_t bit_position;               // Next bit of the address to walk (0 to 63)
+    int8_t local_last_zero_branch;      // Last zero branch met so far by this device
+    uint32_t reset_count;               // Value of sensor->reset_count when the device search started
+    bool walked;                        // A device was walked to its last bit since DS18B20_SearchInit
+
+    // Family code searched, 0 to search all the devices
+    uint8_t family;
+
 } onewire_search_state_t;
 
 /* ROM Code Address structure */
@@ -107,11 +251,70 @@ error_t DS18B20_Init(DS18B20_t* sensor);
 
 uint8_t DS18B20_Search(DS18B20_t* sensor, uint64_t ROM_Codes_array[]);
 
+uint8_t DS18B20_SearchFamily(DS18B20_t *sensor, uint8_t family, uint64_t ROM_codes_array[]);
+
+uint8_t DS18B20_CRC(const uint8_t data[], uint8_t length);
+
+bool DS18B20_IsSensor(uint64_t ROM_code);
+
+void DS18B20_SearchInit(onewire_search_state_t *state);
+
+void DS18B20_SearchInitFamily(onewire_search_state_t *state, uint8_t family);
+
+uint8_t DS18B20_SearchNext(DS18B20_t *sensor, onewire_search_state_t *state, uint64_t *ROM_code);
+
+uint8_t DS18B20_SearchStep(DS18B20_t *sensor, onewire_search_state_t *state, uint16_t max_slots,
+                           uint64_t *ROM_code);
+
 //int DS18B20_GetTemp(DS18B20_t *sensor, ROM_Code_Address_t *p_ROM_code_address,
  //                 uint16_t *temperature);
 
 uint8_t DS18B20_GetTemp(DS18B20_t *sensor, const uint64_t ROM_Codes_array[], uint16_t *temperature);
 
+uint8_t DS18B20_StartConversion(DS18B20_t *sensor, uint64_t ROM_code);
+
+uint8_t DS18B20_WaitConversion(DS18B20_t *sensor, uint32_t timeout_ms);
+
+uint8_t DS18B20_ReadScratchpad(DS18B20_t *sensor, uint64_t ROM_code, uint8_t scratchpad[]);
+
+uint8_t DS18B20_ReadTemperature(DS18B20_t *sensor, uint64_t ROM_code, int16_t *value);
+
+void DS18B20_ReadSample(DS18B20_t *sensor, uint64_t ROM_code, DS18B20_Sample_t *sample);
+
+uint16_t DS18B20_SlotID(uint64_t ROM_code, const uint8_t scratchpad[]);
+
+uint8_t DS18B20_WriteSlotID(DS18B20_t *sensor, uint64_t ROM_code, uint16_t id);
+
+uint8_t DS18B20_Decode(uint64_t ROM_code, const uint8_t scratchpad[], int16_t *value);
+
+uint8_t DS18B20_DecodeMAX31850(const uint8_t scratchpad[], DS18B20_Thermocouple_t *thermocouple);
+
+uint8_t DS18B20_WriteScratchpad(DS18B20_t *sensor, uint64_t ROM_code, uint8_t th, uint8_t tl, uint8_t config);
+
+uint8_t DS18B20_CopyScratchpad(DS18B20_t *sensor, uint64_t ROM_code);
+
+DS18B20_Channel_t *DS18B20_Channel(DS18B20_t *sensor, uint16_t slot);
+
+void DS18B20_Channel_Reset(DS18B20_t *sensor, uint16_t slot);
+
+error_t DS18B20_Provision(DS18B20_t *sensor, const uint64_t ROM_codes_array[], uint8_t th, uint8_t tl,
+                          uint8_t config, bool persist);
+
+uint32_t DS18B20_ConversionTime(const DS18B20_t *sensor);
+
+uint32_t DS18B20_ResolutionTime(uint8_t resolution);
+
+bool DS18B20_ReadPowerSupply(DS18B20_t *sensor);
+
+uint16_t DS18B20_GroupSize(const DS18B20_t *sensor);
+
+bool DS18B20_Staggered(const DS18B20_t *sensor, const uint64_t ROM_codes_array[]);
+
+error_t DS18B20_Sweep(DS18B20_t *sensor, const uint64_t ROM_codes_array[],
+                      DS18B20_Deliver_t deliver, void *context);
+
+error_t DS18B20_Acquire(DS18B20_t *sensor, const uint64_t ROM_codes_array[], DS18B20_Ring_t *ring);
+
 /************************** FUNCTION PROTOTYPES END **************************************** */
 
  #endif /* INC_DS18B20_H_ */
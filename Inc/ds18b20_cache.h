@@ -0,0 +1,67 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_cache.h                                                                           */
+/*                                                                                           */
+/* Per-sensor result cache with a maximum age, shared by all the readers of a bus            */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_CACHE_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_CACHE_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Cached result of one sensor */
+typedef struct
+{
+	uint32_t timestamp;		// HAL tick (ms) of the conversion
+	int16_t value;			// Temperature in Q12.4 format
+	uint8_t status;			// DS18B20_SampleStatus_t
+	bool valid;				// False until the first sweep
+
+} DS18B20_CacheEntry_t;
+
+/* Cache of one bus */
+typedef struct
+{
+	DS18B20_t *sensor;					// Bus of the cached sensors
+	const uint64_t *ROM_codes_array;	// ROM codes of the sensors, terminated by 0
+	DS18B20_CacheEntry_t *entries;		// One entry per ROM code
+	uint16_t entry_count;				// Set by DS18B20_Cache_Init: length of ROM_codes_array
+	uint32_t max_age_ms;				// Results older than this are converted again
+
+	uint32_t hits;						// Number of reads served from the cache
+	uint32_t sweeps;					// Number of broadcast conversions done
+
+} DS18B20_Cache_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_Cache_Init(DS18B20_Cache_t *cache, DS18B20_t *sensor, const uint64_t ROM_codes_array[],
+                           DS18B20_CacheEntry_t entries[], uint32_t max_age_ms);
+
+bool DS18B20_Cache_Lookup(DS18B20_Cache_t *cache, uint16_t slot, int16_t *value, uint8_t *status);
+
+void DS18B20_Cache_Store(DS18B20_Cache_t *cache, const DS18B20_Sample_t *sample);
+
+uint8_t DS18B20_Cache_Refresh(DS18B20_Cache_t *cache);
+
+uint8_t DS18B20_Cache_Get(DS18B20_Cache_t *cache, uint16_t slot, int16_t *value);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_CACHE_H_ */
+
+/********************************** END OF FILE ******************************************** */
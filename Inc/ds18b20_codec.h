@@ -0,0 +1,92 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_codec.h                                                                           */
+/*                                                                                           */
+/* Compact encoding of DS18B20 samples: per-sensor deltas, zigzag varints and keyframes      */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_CODEC_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_CODEC_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+//!\ Each sample is encoded against the previous sample of the same slot (value) and the
+//!\ previous sample of the stream (timestamp and slot). A sample of the next slot, at the
+//!\ same timestamp and with an OK status, is only its value delta: one byte for a change
+//!\ of less than 2°C. The other samples start with a control byte telling which fields follow.
+//!\ A keyframe resets all the references, so that a stream can be decoded from any keyframe.
+
+//!\ Short form: varint(zigzag(value delta) << 1)
+//!\ Long form:  varint(flags << 1 | 1), [varint(timestamp) if KEY], [varint(zigzag(timestamp
+//!\             delta)) if TIME], [varint(slot) if SLOT], [varint(zigzag(value delta)) if OK]
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Flags of the long form
+#define DS18B20_CODEC_KEY			0x01U	// Keyframe: references reset, absolute timestamp
+#define DS18B20_CODEC_TIME			0x02U	// Timestamp delta follows
+#define DS18B20_CODEC_SLOT			0x04U	// Slot follows, otherwise the slot after the previous one
+#define DS18B20_CODEC_STATUS_SHIFT	3U		// DS18B20_SampleStatus_t, no value if not OK
+#define DS18B20_CODEC_STATUS_MASK	0x07U
+
+// Largest encoded sample, in bytes: control, timestamp, slot and value
+#define DS18B20_CODEC_MAX_SIZE		12U
+
+// Size of a sample without encoding, to compute the compression ratio: value and timestamp
+#define DS18B20_CODEC_RAW_SIZE		6U
+
+// Default number of samples between two keyframes
+#define DS18B20_CODEC_KEY_INTERVAL	1024U
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* State of an encoder, or of a decoder */
+//!\ An encoder and its decoder shall have references for the same number of slots.
+typedef struct
+{
+	int16_t *references;		// Previous value of each slot, Q12.4
+	uint16_t capacity;			// Number of references, the other slots are encoded absolute
+	uint16_t key_interval;		// Samples between two keyframes (encoder only)
+
+	uint16_t slot;				// Slot of the previous sample
+	uint32_t timestamp;			// Timestamp of the previous sample
+	uint16_t since_key;			// Samples since the last keyframe, key_interval to start with one
+
+	// Statistics of the encoder
+	uint32_t samples;			// Samples encoded
+	uint32_t bytes;				// Bytes produced
+	uint32_t keyframes;			// Keyframes produced
+	uint32_t cycles;			// CPU cycles spent encoding, with DS18B20_CODEC_PROFILE only
+
+} DS18B20_Codec_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_Codec_Init(DS18B20_Codec_t *codec, int16_t references[], uint16_t capacity, uint16_t key_interval);
+
+void DS18B20_Codec_Key(DS18B20_Codec_t *codec);
+
+uint8_t DS18B20_Codec_Encode(DS18B20_Codec_t *codec, const DS18B20_Sample_t *sample, uint8_t data[]);
+
+uint8_t DS18B20_Codec_Decode(DS18B20_Codec_t *codec, const uint8_t data[], uint32_t length, DS18B20_Sample_t *sample);
+
+uint32_t DS18B20_Codec_Ratio(const DS18B20_Codec_t *codec);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_CODEC_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,51 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_deadband.h                                                                        */
+/*                                                                                           */
+/* Deadband, hysteresis and heartbeat per sensor, to deliver only the changed samples        */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_DEADBAND_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_DEADBAND_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Stage of the delivery path, between a sweep and the final delivery function */
+typedef struct
+{
+	DS18B20_t *sensor;			// Bus whose channels hold the settings and the last values
+	DS18B20_Deliver_t deliver;	// Receives the samples that pass
+	void *context;				// Argument given to deliver
+
+	uint32_t delivered;			// Number of samples passed to deliver
+	uint32_t suppressed;		// Number of samples dropped as unchanged
+
+} DS18B20_Deadband_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_Deadband_Init(DS18B20_Deadband_t *deadband, DS18B20_t *sensor, DS18B20_Deliver_t deliver,
+                              void *context);
+
+void DS18B20_Deadband_Deliver(void *context, const DS18B20_Sample_t *sample);
+
+bool DS18B20_Deadband_Changed(DS18B20_Channel_t *channel, const DS18B20_Sample_t *sample);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_DEADBAND_H_ */
+
+/********************************** END OF FILE ******************************************** */
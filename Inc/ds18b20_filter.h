@@ -0,0 +1,56 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_filter.h                                                                          */
+/*                                                                                           */
+/* Median-of-3 spike rejection and exponential moving average per sensor                     */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_FILTER_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_FILTER_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Largest ema_shift: the average of int16 values, shifted, still fits an int32
+#define DS18B20_FILTER_EMA_SHIFT_MAX	15U
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Stage of the delivery path, between a sweep and the final delivery function */
+typedef struct
+{
+	DS18B20_t *sensor;			// Bus whose channels hold the settings and the filter states
+	DS18B20_Deliver_t deliver;	// Receives the filtered samples
+	void *context;				// Argument given to deliver
+
+	uint32_t spikes;			// Number of values replaced by the median
+
+} DS18B20_Filter_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_Filter_Init(DS18B20_Filter_t *filter, DS18B20_t *sensor, DS18B20_Deliver_t deliver, void *context);
+
+void DS18B20_Filter_Deliver(void *context, const DS18B20_Sample_t *sample);
+
+bool DS18B20_Filter_Apply(DS18B20_Channel_t *channel, DS18B20_Sample_t *sample);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_FILTER_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,130 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_flashlog.h                                                                        */
+/*                                                                                           */
+/* Append-only log of encoded samples in a ring of flash sectors                             */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_FLASHLOG_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_FLASHLOG_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+/** Include sample encoding */
+#include "ds18b20_codec.h"
+
+//!\ The log only uses the flash through DS18B20_Flash_t, so that it can run on the
+//!\ internal flash of the STM32H7 (DS18B20_FlashH7_xxx below), on an external memory, or
+//!\ on a file-backed emulator on a host computer.
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// First bytes of a valid page ("DSLG")
+#define DS18B20_FLASHLOG_MAGIC			0x474C5344UL
+
+// Page header, little-endian: magic (uint32), CRC16 (uint16) of the rest of the page up to the
+// end of the data, length of the data (uint16), sequence number (uint32)
+#define DS18B20_FLASHLOG_HEADER_SIZE	12U
+
+// Program unit of the internal flash of the STM32H7 (flash word): a page is a multiple of it
+#define DS18B20_FLASHLOG_WORD_SIZE		(FLASH_NB_32BITWORD_IN_FLASHWORD * 4U)
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Flash memory used by a log, addresses relative to the start of its region */
+//!\ The functions return 0 if OK, 1 otherwise. An erased byte reads 0xFF, and a page is
+//!\ only programmed once between two erases of its sector.
+typedef struct
+{
+	uint8_t (*read)(void *context, uint32_t address, uint8_t data[], uint32_t length);
+	uint8_t (*program)(void *context, uint32_t address, const uint8_t data[], uint32_t length);
+	uint8_t (*erase)(void *context, uint16_t sector);
+	void *context;						// Argument given to the functions
+
+	uint32_t sector_size;				// Bytes of an erase unit
+	uint16_t sector_count;				// Sectors of the region, at least 2
+	uint16_t page_size;					// Bytes of a page, a multiple of DS18B20_FLASHLOG_WORD_SIZE
+
+} DS18B20_Flash_t;
+
+/* Append-only log */
+typedef struct
+{
+	const DS18B20_Flash_t *flash;
+	uint8_t *page;						// Page being filled, page_size bytes aligned on 4 bytes
+	uint16_t fill;						// Bytes of data in this page
+	uint32_t position;					// Index of this page in the region
+	uint32_t sequence;					// Sequence number of this page
+
+	DS18B20_Codec_t *codec;				// Encoder of DS18B20_FlashLog_Deliver, NULL if not used
+
+	uint32_t page_count;				// Pages of the region
+	uint32_t sector_pages;				// Pages of a sector
+
+	// Statistics
+	uint32_t pages;						// Pages programmed
+	uint32_t erases;					// Sectors erased
+	uint32_t skipped;					// Torn pages skipped by the recovery
+	uint32_t program_errors;			// Pages that could not be programmed
+	uint32_t errors;					// Failed erases, and data dropped
+
+} DS18B20_FlashLog_t;
+
+/* Position of a reader in the log */
+typedef struct
+{
+	uint32_t position;					// Next page to read
+	uint32_t remaining;					// Pages left to read
+	uint32_t sequence;					// Sequence number of the last page read, 0 for none
+
+} DS18B20_FlashCursor_t;
+
+/* Region of the internal flash of the STM32H7, context of DS18B20_FlashH7_xxx */
+typedef struct
+{
+	uint32_t address;					// Address of the first sector of the region
+	uint32_t bank;						// FLASH_BANK_1 or FLASH_BANK_2
+	uint32_t first_sector;				// Number of the first sector in its bank
+
+} DS18B20_FlashH7_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_FlashLog_Init(DS18B20_FlashLog_t *log, const DS18B20_Flash_t *flash, uint8_t page[],
+                              DS18B20_Codec_t *codec);
+
+uint8_t DS18B20_FlashLog_Append(DS18B20_FlashLog_t *log, const uint8_t data[], uint16_t length);
+
+uint8_t DS18B20_FlashLog_Flush(DS18B20_FlashLog_t *log);
+
+void DS18B20_FlashLog_Deliver(void *context, const DS18B20_Sample_t *sample);
+
+void DS18B20_FlashLog_Rewind(const DS18B20_FlashLog_t *log, DS18B20_FlashCursor_t *cursor);
+
+uint8_t DS18B20_FlashLog_Read(const DS18B20_FlashLog_t *log, DS18B20_FlashCursor_t *cursor, uint8_t data[],
+                              uint16_t *length);
+
+uint8_t DS18B20_FlashH7_Read(void *context, uint32_t address, uint8_t data[], uint32_t length);
+
+uint8_t DS18B20_FlashH7_Program(void *context, uint32_t address, const uint8_t data[], uint32_t length);
+
+uint8_t DS18B20_FlashH7_Erase(void *context, uint16_t sector);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_FLASHLOG_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,125 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_history.h                                                                         */
+/*                                                                                           */
+/* Per-sensor history: raw samples and minute / hour min, mean and max                       */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_HISTORY_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_HISTORY_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+//!\ The buffers are given by the application, so that each sensor can keep as much
+//!\ history as needed: 4 bytes per raw sample, 12 bytes per minute or hour.
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Delta of a raw sample whose time since the previous one is unknown or too long
+#define DS18B20_HISTORY_GAP			0xFFFFU
+
+// Longest delta stored in ms. Above, the delta holds DS18B20_HISTORY_SECONDS and the second
+// of the previous sample modulo DS18B20_HISTORY_SECONDS_MOD, which never gives the gap value
+#define DS18B20_HISTORY_MS_MAX		0x7FFFU
+#define DS18B20_HISTORY_SECONDS		0x8000U
+#define DS18B20_HISTORY_SECONDS_MOD	32767UL
+
+// Longest time between two samples whose timestamps are kept, about 9.1 hours
+#define DS18B20_HISTORY_SPAN_MS		((DS18B20_HISTORY_SECONDS_MOD - 1UL) * 1000UL)
+
+// Timestamp of a raw sample older than a gap
+#define DS18B20_HISTORY_NO_TIME		UINT32_MAX
+
+// Length of the aggregation periods, in ms
+#define DS18B20_HISTORY_MINUTE_MS	60000UL
+#define DS18B20_HISTORY_HOUR_MS		3600000UL
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Aggregate of the valid samples of one period */
+typedef struct
+{
+	uint32_t period;		// Index of the period: timestamp / length of the period
+	int16_t min;			// Q12.4
+	int16_t mean;			// Q12.4, rounded
+	int16_t max;			// Q12.4
+	uint16_t count;			// Number of samples, 0 if none was valid
+
+} DS18B20_Aggregate_t;
+
+/* Aggregates of one period length */
+typedef struct
+{
+	DS18B20_Aggregate_t *buffer;	// Closed periods, ring
+	uint16_t capacity;
+	uint16_t head;					// Next aggregate to write
+	uint16_t count;					// Closed periods kept
+	uint32_t period_ms;
+
+	DS18B20_Aggregate_t current;	// Period in progress, its mean is only set when closed
+	int32_t sum;					// Sum of the samples of the period in progress
+
+} DS18B20_HistoryLevel_t;
+
+/* History of one sensor */
+typedef struct
+{
+	// Raw samples, ring
+	int16_t *values;				// Q12.4
+	uint16_t *deltas;				// Time since the previous sample, see DS18B20_HISTORY_MS_MAX
+	uint16_t capacity;
+	uint16_t head;					// Next sample to write
+	uint16_t count;					// Samples kept
+	uint32_t last_timestamp;		// Timestamp of the newest sample
+	bool gap;						// The previous sample was missing
+
+	DS18B20_HistoryLevel_t minutes;
+	DS18B20_HistoryLevel_t hours;
+
+} DS18B20_History_t;
+
+/* Delivery stage storing the samples of a bus, one history per slot */
+typedef struct
+{
+	DS18B20_History_t *histories;
+	uint16_t count;					// Number of histories, the other slots are not stored
+
+	DS18B20_Deliver_t deliver;		// Optional next stage, NULL if none
+	void *context;					// Argument given to deliver
+
+} DS18B20_Histories_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_History_Init(DS18B20_History_t *history, int16_t values[], uint16_t deltas[], uint16_t capacity,
+                             DS18B20_Aggregate_t minutes[], uint16_t minute_capacity,
+                             DS18B20_Aggregate_t hours[], uint16_t hour_capacity);
+
+void DS18B20_History_Add(DS18B20_History_t *history, const DS18B20_Sample_t *sample);
+
+bool DS18B20_History_Get(const DS18B20_History_t *history, uint16_t index, int16_t *value, uint32_t *timestamp);
+
+bool DS18B20_History_Minute(const DS18B20_History_t *history, uint16_t index, DS18B20_Aggregate_t *aggregate);
+
+bool DS18B20_History_Hour(const DS18B20_History_t *history, uint16_t index, DS18B20_Aggregate_t *aggregate);
+
+void DS18B20_History_Deliver(void *context, const DS18B20_Sample_t *sample);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_HISTORY_H_ */
+
+/********************************** END OF FILE ******************************************** */
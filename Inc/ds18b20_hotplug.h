@@ -0,0 +1,79 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_hotplug.h                                                                         */
+/*                                                                                           */
+/* Background detection of the sensors added to or removed from a bus                        */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_HOTPLUG_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_HOTPLUG_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+#include "ds18b20_romtable.h"
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Number of 32-bit words of the seen bitmap for a given capacity
+#define DS18B20_HOTPLUG_SEEN_WORDS(capacity)	(((capacity) + 31U) / 32U)
+
+// Passes started again after a ROM code CRC error, before the device is skipped
+#define DS18B20_HOTPLUG_RESTARTS				3U
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Event sent for each change of the ROM codes array */
+typedef enum
+{
+	DS18B20_DEVICE_ADDED = 0,	// New device, stored in a free slot
+	DS18B20_DEVICE_REMOVED,		// Device not found by a whole search, its slot is now free
+	DS18B20_DEVICE_NO_SLOT,		// New device, but the array is full
+
+} DS18B20_HotplugEvent_t;
+
+/* Function receiving the events */
+typedef void (*DS18B20_HotplugCallback_t)(void *context, DS18B20_HotplugEvent_t event,
+                                          uint16_t slot, uint64_t ROM_code);
+
+/* Hot-plug detection structure */
+typedef struct
+{
+	DS18B20_t *sensor;					// Bus to watch
+	DS18B20_RomTable_t *table;			// Full table initialized by DS18B20_RomTable_Init, a slot is a handle
+	uint32_t *seen;						// DS18B20_HOTPLUG_SEEN_WORDS(table->capacity) words
+	DS18B20_HotplugCallback_t callback;	// Optional
+	void *context;						// Argument given to callback
+	uint16_t max_slots;					// Search time slots per step, 0 to search a whole device
+
+	// Managed by DS18B20_Hotplug_Step
+	onewire_search_state_t search;
+	bool pass_active;					// A search pass is in progress
+	uint8_t restarts;					// Restarts after a CRC error since the last complete pass
+	uint32_t skipped;					// Devices skipped after DS18B20_HOTPLUG_RESTARTS restarts
+	uint32_t passes;					// Number of complete search passes
+
+} DS18B20_Hotplug_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_Hotplug_Init(DS18B20_Hotplug_t *hotplug);
+
+bool DS18B20_Hotplug_Step(DS18B20_Hotplug_t *hotplug);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_HOTPLUG_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,125 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_log.h                                                                             */
+/*                                                                                           */
+/* Debug messages of the DS18B20 driver, printed at once or deferred as binary records       */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_LOG_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_LOG_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include standard libraries */
+#include <stdatomic.h>		// Required for the producer / consumer indexes
+#include <stdint.h> 		// Required to use uint8_t and uint32_t
+
+//!\ Each message of the driver has an ID in DS18B20_LOG_FORMATS, and its format in
+//!\ <ID>_FMT. With DEBUG_DS18B20, log_ds18b20 prints the message through the console,
+//!\ with the format as a literal so that the compiler checks the arguments. With DS18B20_LOG_DEFERRED as
+//!\ well, it only stores the ID, the HAL tick and the arguments in a RAM ring, and the
+//!\ ring is sent later by DS18B20_Log_Drain, from the idle loop. The binary records are
+//!\ decoded on the host by Tools/ds18b20_logdecode.py, which reads the formats below.
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Messages of the driver, in the order of their IDs
+#define DS18B20_LOG_FORMATS(X) \
+	X(DS18B20_LOG_PARASITE) \
+	X(DS18B20_LOG_SEARCHING) \
+	X(DS18B20_LOG_ROM_CODE) \
+	X(DS18B20_LOG_ROM_INVALID) \
+	X(DS18B20_LOG_PROVISIONING) \
+	X(DS18B20_LOG_TEMPERATURE) \
+	X(DS18B20_LOG_SAMPLE) \
+	X(DS18B20_LOG_HOTPLUG)
+
+// Format of each message (arguments of at most 32 bits each)
+#define DS18B20_LOG_PARASITE_FMT		"Parasite power: %u\n\r"
+#define DS18B20_LOG_SEARCHING_FMT		"Searching devices...\n\r"
+#define DS18B20_LOG_ROM_CODE_FMT		"ROM Code for sensor %u: %08lx%08lx\n\r"
+#define DS18B20_LOG_ROM_INVALID_FMT		"Received ROM code not valid !\n\r"
+#define DS18B20_LOG_PROVISIONING_FMT	"Provisioning: %u of %u sensors to write\n\r"
+#define DS18B20_LOG_TEMPERATURE_FMT		"Temperature of sensor %i: %d\n\r"
+#define DS18B20_LOG_SAMPLE_FMT			"Temperature of sensor %u: %d/16\n\r"
+#define DS18B20_LOG_HOTPLUG_FMT			"Hot-plug event %u on slot %u\n\r"
+
+// Number of 32-bit words of the deferred ring (power of two)
+#ifndef DS18B20_LOG_SIZE
+#define DS18B20_LOG_SIZE		512U
+#endif
+
+// Top byte of the first word of a record, to find the records in the stream
+#define DS18B20_LOG_SYNC		0xDBU
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* ID of a message */
+#define DS18B20_LOG_ENUM(id)	id,
+typedef enum
+{
+	DS18B20_LOG_FORMATS(DS18B20_LOG_ENUM)
+	DS18B20_LOG_COUNT
+
+} DS18B20_LogId_t;
+#undef DS18B20_LOG_ENUM
+
+/* Deferred ring, records are: sync | count | ID, HAL tick, count arguments */
+typedef struct
+{
+	// Written by the producer only
+	atomic_uint_least32_t head;
+
+	// Written by the consumer only
+	atomic_uint_least32_t tail;
+
+	uint32_t words[DS18B20_LOG_SIZE];
+	uint32_t dropped;			// Number of records dropped because the ring was full
+
+} DS18B20_Log_t;
+
+_Static_assert((DS18B20_LOG_SIZE & (DS18B20_LOG_SIZE - 1U)) == 0U, "DS18B20_LOG_SIZE shall be a power of two");
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+extern const char *const DS18B20_log_formats[DS18B20_LOG_COUNT];
+
+extern DS18B20_Log_t DS18B20_log;
+
+void DS18B20_Log_Write(uint8_t id, const uint32_t *arguments, uint8_t count);
+
+uint32_t DS18B20_Log_Drain(uint8_t buffer[], uint32_t size);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Debug DS18B20
+#if defined(DEBUG_DS18B20) && defined(DS18B20_LOG_DEFERRED)
+// The arguments are packed after a leading 0, so that a message may have none
+#define log_ds18b20(id, ...) \
+	DS18B20_Log_Write((id), (const uint32_t[]){0, ##__VA_ARGS__}, \
+	                  (uint8_t)(sizeof((const uint32_t[]){0, ##__VA_ARGS__}) / sizeof(uint32_t) - 1U))
+#elif defined(DEBUG_DS18B20)
+#include "console.h"
+// The ID shall be written as is: its name gives the name of its format
+#define log_ds18b20(id, ...)  printf(id##_FMT, ##__VA_ARGS__)
+#else
+#define log_ds18b20(...)
+#endif
+
+/*********************************** DEFINE END ******************************************** */
+
+#endif /* INC_DS18B20_LOG_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,57 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_lowpower.h                                                                        */
+/*                                                                                           */
+/* Low-power waits for the DS18B20 conversions (Sleep or Stop mode)                          */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_LOWPOWER_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_LOWPOWER_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Longest LPTIM timeout of one Stop period, in LPTIM ticks. The 16-bit counter runs up to
+// 0xFFFF: the margin lets it be read after the wake-up before it wraps.
+#define DS18B20_LPTIM_TIMEOUT_MAX	0xF000U
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Low-power wait structure, given as wait_context of the DS18B20_t */
+typedef struct
+{
+	LPTIM_HandleTypeDef *hlptim;	// Stop mode only: LPTIM clocked by LSE or LSI, running in Stop mode
+	uint32_t lptim_clock_hz;		// Stop mode only: LPTIM counter frequency, after its prescaler
+	void (*clock_restore)(void);	// Stop mode only: restores the system clock, e.g. SystemClock_Config
+
+	volatile bool wakeup;			// Set by DS18B20_LowPower_WakeUp
+
+} DS18B20_LowPower_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+void DS18B20_SleepWait(void *context, uint32_t ms);
+
+void DS18B20_StopWait(void *context, uint32_t ms);
+
+void DS18B20_LowPower_WakeUp(DS18B20_LowPower_t *low_power);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_LOWPOWER_H_ */
+
+/********************************** END OF FILE ******************************************** */
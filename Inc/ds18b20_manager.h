@@ -0,0 +1,78 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_manager.h                                                                         */
+/*                                                                                           */
+/* Manager of several DS18B20 buses with overlapped conversions                              */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_MANAGER_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_MANAGER_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* State of a bus in the manager */
+typedef enum
+{
+	DS18B20_BUS_IDLE = 0,		// Next poll starts a conversion
+	DS18B20_BUS_CONVERTING,		// Waiting for the end of the conversion
+	DS18B20_BUS_READOUT,		// Reading the sensors one by one
+
+} DS18B20_BusState_t;
+
+/* One bus of the manager */
+typedef struct
+{
+	DS18B20_t *sensor;					// Bus, with its own pin and timer
+	const uint64_t *ROM_codes_array;	// ROM codes of the sensors of this bus, terminated by 0
+
+	// Managed by DS18B20_Manager_Poll
+	uint8_t state;						// DS18B20_BusState_t
+	uint16_t next_slot;					// Next sensor to read out
+	bool staggered;						// Sensors converted one at a time in this cycle, see DS18B20_Staggered
+	bool start_failed;					// No presence pulse at the last start, tried again later
+	uint8_t conversion_status;			// DS18B20_SampleStatus_t of the conversion being read out
+	uint32_t cycle_start;				// HAL tick (ms) of the start of the cycle
+	uint32_t conversion_start;			// HAL tick (ms) of the start of the conversion
+	uint32_t conversion_end;			// HAL tick (ms) of the end of the conversion
+
+	// Statistics
+	uint32_t cycle_time_ms;				// Duration of the last conversion and readout
+	uint32_t cycles;					// Number of complete cycles
+
+} DS18B20_Bus_t;
+
+/* Manager structure */
+typedef struct
+{
+	DS18B20_Bus_t *buses;		// Array of buses
+	uint8_t bus_count;			// Number of buses
+	uint8_t current;			// Bus read out at the previous poll (round robin)
+	DS18B20_Ring_t *ring;		// Samples of all the buses
+
+} DS18B20_Manager_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_Manager_Init(DS18B20_Manager_t *manager, DS18B20_Bus_t buses[], uint8_t bus_count,
+                             DS18B20_Ring_t *ring);
+
+uint8_t DS18B20_Manager_Poll(DS18B20_Manager_t *manager);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_MANAGER_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,95 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_ring.h                                                                            */
+/*                                                                                           */
+/* Lock-free single-producer / single-consumer ring of DS18B20 samples                       */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_RING_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_RING_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include standard libraries */
+#include <stdatomic.h>		// Required for the producer / consumer indexes
+#include <stdbool.h> 		// Required to use booleans
+#include <stddef.h>			// Required to use NULL
+#include <stdint.h> 		// Required to use uint8_t and uint16_t
+
+//!\ This module does not depend on the HAL, so that it can be built on a host
+//!\ computer as well as on the target.
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Size of a data cache line of the Cortex-M7 core, in bytes.
+// The producer and consumer indexes are placed on different lines so that
+// the two sides never write to the same line.
+#define DS18B20_CACHE_LINE	32U
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Status of a sample */
+typedef enum
+{
+	DS18B20_SAMPLE_OK = 0,			// Valid temperature
+	DS18B20_SAMPLE_NO_PRESENCE,		// No presence pulse on the bus
+	DS18B20_SAMPLE_CRC_ERROR,		// Scratchpad CRC does not match
+	DS18B20_SAMPLE_TIMEOUT,			// Conversion did not complete in time
+	DS18B20_SAMPLE_INVALID,			// Request or value rejected by the driver
+	DS18B20_SAMPLE_FAULT,			// Sensor reports a fault (MAX31850 thermocouple)
+
+} DS18B20_SampleStatus_t;
+
+/* Sample record delivered by the acquisition engine */
+typedef struct
+{
+	uint32_t timestamp;		// HAL tick (ms) at the end of the conversion
+	uint16_t slot;			// Index of the sensor in the ROM codes array
+	int16_t value;			// Temperature in Q12.4 format (1 LSB = 1/16 °C)
+	uint8_t status;			// DS18B20_SampleStatus_t
+	uint8_t bus;			// Index of the bus in the manager, 0 for a single bus
+	uint16_t id;			// Slot ID stored in the sensor (TH/TL), see DS18B20_WriteSlotID
+
+} DS18B20_Sample_t;
+
+/* Ring structure */
+typedef struct
+{
+	// Written by the producer only
+	_Alignas(DS18B20_CACHE_LINE) atomic_uint_least32_t head;
+
+	// Written by the consumer only
+	_Alignas(DS18B20_CACHE_LINE) atomic_uint_least32_t tail;
+
+	// Read-only after DS18B20_Ring_Init, except overruns (producer only)
+	_Alignas(DS18B20_CACHE_LINE) DS18B20_Sample_t *buffer;
+	uint32_t mask;			// Number of records - 1 (size is a power of two)
+	uint32_t overruns;		// Number of samples dropped because the ring was full
+
+} DS18B20_Ring_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+bool DS18B20_Ring_Init(DS18B20_Ring_t *ring, DS18B20_Sample_t buffer[], uint32_t size);
+
+bool DS18B20_Ring_Push(DS18B20_Ring_t *ring, const DS18B20_Sample_t *sample);
+
+bool DS18B20_Ring_Pop(DS18B20_Ring_t *ring, DS18B20_Sample_t *sample);
+
+uint32_t DS18B20_Ring_Count(DS18B20_Ring_t *ring);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_RING_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,74 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_romtable.h                                                                        */
+/*                                                                                           */
+/* Table of ROM codes with stable handles and a sorted index for fast lookups                */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_ROMTABLE_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_ROMTABLE_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Handle returned when a ROM code is not in the table, or when the table is full
+#define DS18B20_ROMTABLE_NONE		0xFFFFU
+
+// Size of a serial number in a compact table, in bytes
+#define DS18B20_SERIAL_SIZE			6U
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* ROM table structure */
+typedef struct
+{
+	// Full table: capacity + 1 ROM codes, usable as a ROM codes array by the rest of the driver
+	// (free handles hold DS18B20_FREE_SLOT and the last entry is 0). NULL in a compact table.
+	uint64_t *ROM_codes;
+
+	// Compact table: capacity serial numbers (bytes 1 to 6 of the ROM code), all the sensors
+	// have the same family and the CRC is computed again. NULL in a full table.
+	uint8_t (*serials)[DS18B20_SERIAL_SIZE];
+	uint8_t family;
+
+	uint16_t *index;			// capacity handles, sorted in search order
+	uint16_t capacity;			// Number of handles
+	uint16_t count;				// Number of ROM codes in the table (used entries of index)
+
+} DS18B20_RomTable_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_RomTable_Init(DS18B20_RomTable_t *table, uint64_t ROM_codes[], uint16_t index[],
+                              uint16_t capacity);
+
+error_t DS18B20_RomTable_InitCompact(DS18B20_RomTable_t *table, uint8_t serials[][DS18B20_SERIAL_SIZE],
+                                     uint16_t index[], uint16_t capacity, uint8_t family);
+
+uint16_t DS18B20_RomTable_Find(const DS18B20_RomTable_t *table, uint64_t ROM_code);
+
+uint16_t DS18B20_RomTable_Add(DS18B20_RomTable_t *table, uint64_t ROM_code);
+
+bool DS18B20_RomTable_Remove(DS18B20_RomTable_t *table, uint16_t handle);
+
+uint64_t DS18B20_RomTable_Get(const DS18B20_RomTable_t *table, uint16_t handle);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_ROMTABLE_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,107 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_rtos.h                                                                            */
+/*                                                                                           */
+/* FreeRTOS integration of the DS18B20 driver: one task owns the bus                         */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_RTOS_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_RTOS_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+#include <stdatomic.h>		// Required for the sequence counter
+
+/** Include FreeRTOS */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+#include "ds18b20_cache.h"
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Slot value of a request addressing all the sensors of the bus
+#define DS18B20_ALL_SLOTS	0xFFFFU
+
+// Notification value of a done request: its sequence number (12 bits), its status (4 bits,
+// the first error met, DS18B20_SampleStatus_t) and, for a single sensor, its value in Q12.4
+#define DS18B20_RTOS_SEQUENCE_MASK	0x0FFFU
+#define DS18B20_RTOS_NOTIFICATION(sequence, status, value) \
+	((((uint32_t)(sequence) & DS18B20_RTOS_SEQUENCE_MASK) << 20) | (((uint32_t)(status) & 0x0FU) << 16) \
+	 | (uint32_t)(uint16_t)(value))
+#define DS18B20_RTOS_SEQUENCE(notification)	((uint16_t)((notification) >> 20))
+#define DS18B20_RTOS_STATUS(notification)	((uint8_t)(((notification) >> 16) & 0x0FU))
+#define DS18B20_RTOS_VALUE(notification)	((int16_t)(uint16_t)(notification))
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Type of request */
+typedef enum
+{
+	DS18B20_REQUEST_READ = 0,	// Convert and read one sensor or all of them
+	DS18B20_REQUEST_CONFIG,		// Write resolution and alarms of one sensor or all of them
+
+} DS18B20_RequestType_t;
+
+/* Request posted by a client task to the driver task */
+typedef struct
+{
+	DS18B20_RequestType_t type;
+	TaskHandle_t client;		// Task notified once the request is done, may be NULL
+	uint16_t sequence;			// Given back in the notification, 12 bits, see DS18B20_RTOS_NOTIFICATION
+	uint16_t slot;				// Index in the ROM codes array, or DS18B20_ALL_SLOTS
+
+	// READ: one value per addressed sensor, in Q12.4 format, and its DS18B20_SampleStatus_t.
+	// Optional, they shall stay valid until the request is done, even after a timeout.
+	int16_t *value;
+	uint8_t *status;
+
+	// CONFIG: new register values
+	uint8_t resolution;			// 9 to 12 bits
+	uint8_t th;
+	uint8_t tl;
+
+} DS18B20_Request_t;
+
+/* Driver task structure */
+typedef struct
+{
+	DS18B20_t *sensor;					// Bus owned by the task
+	const uint64_t *ROM_codes_array;	// ROM codes of the sensors, terminated by 0
+	DS18B20_Ring_t *ring;				// Optional, every sample read is also pushed here
+	DS18B20_Cache_t *cache;				// Optional, reads are served from it while fresh
+
+	QueueHandle_t queue;				// Set by DS18B20_RTOS_Start
+	TaskHandle_t task;					// Set by DS18B20_RTOS_Start
+	uint16_t slot_count;				// Set by DS18B20_RTOS_Start: length of ROM_codes_array
+	atomic_uint_least32_t sequence;		// Sequence number of the last DS18B20_RTOS_Read, of any task
+
+} DS18B20_Driver_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_RTOS_Start(DS18B20_Driver_t *driver, UBaseType_t priority,
+                           configSTACK_DEPTH_TYPE stack_depth, UBaseType_t queue_length);
+
+BaseType_t DS18B20_RTOS_Post(DS18B20_Driver_t *driver, const DS18B20_Request_t *request, TickType_t timeout);
+
+uint8_t DS18B20_RTOS_Read(DS18B20_Driver_t *driver, uint16_t slot, int16_t *value, TickType_t timeout);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_RTOS_H_ */
+
+/********************************** END OF FILE ******************************************** */
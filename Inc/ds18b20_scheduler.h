@@ -0,0 +1,69 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_scheduler.h                                                                       */
+/*                                                                                           */
+/* Earliest-deadline-first scheduler of DS18B20 sensors with their own sampling periods      */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_SCHEDULER_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_SCHEDULER_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// A broadcast conversion is used when at least 1/DS18B20_BROADCAST_RATIO of the sensors
+// are due, otherwise each due sensor is converted on its own
+#define DS18B20_BROADCAST_RATIO		4U
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* One sensor of the schedule */
+typedef struct
+{
+	uint64_t ROM_code;			// ROM code of the sensor
+	uint32_t period_ms;			// Sampling period
+	uint8_t resolution;			// Resolution in bits (9 to 12), written by DS18B20_Scheduler_Init
+
+	// Managed by the scheduler
+	uint32_t next_due;			// HAL tick (ms) of the next deadline
+	bool due;					// Part of the batch being converted
+	uint8_t status;				// Start of its conversion in the batch, DS18B20_SampleStatus_t
+
+} DS18B20_ScheduleEntry_t;
+
+/* Scheduler structure */
+typedef struct
+{
+	DS18B20_t *sensor;					// Bus of the sensors
+	DS18B20_ScheduleEntry_t *entries;	// Sensors of the bus with their period
+	uint16_t count;						// Number of entries
+	uint32_t batch_window_ms;			// Sensors due within this window are converted with the due ones
+	DS18B20_Ring_t *ring;				// Samples, with the index of the entry as slot
+
+} DS18B20_Scheduler_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_Scheduler_Init(DS18B20_Scheduler_t *scheduler);
+
+uint32_t DS18B20_Scheduler_Run(DS18B20_Scheduler_t *scheduler);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_SCHEDULER_H_ */
+
+/********************************** END OF FILE ******************************************** */
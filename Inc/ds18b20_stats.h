@@ -0,0 +1,135 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_stats.h                                                                           */
+/*                                                                                           */
+/* Runtime counters and latency histograms of a DS18B20 bus                                  */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_STATS_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_STATS_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include standard libraries */
+#include <stdatomic.h>		// Required for the sequence counter
+#include <stdbool.h> 		// Required to use booleans
+#include <stddef.h>			// Required to use NULL
+#include <stdint.h> 		// Required to use uint8_t and uint32_t
+
+//!\ The counters are updated by the driver, in the context that drives the bus, and read
+//!\ by DS18B20_Stats_Snapshot from any other context. A sequence counter, odd while an
+//!\ update is in progress, lets the reader detect a torn copy and try again: the
+//!\ acquisition is never stopped or delayed by the reader.
+//!\ Like the sample ring, this module does not depend on the HAL.
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Number of buckets of a histogram: bucket 0 counts the 0 values, bucket k >= 1 the values
+// from 2^(k-1) to 2^k - 1, and the last bucket all the larger ones
+#define DS18B20_STATS_BUCKETS		16U
+
+// Number of copies tried by DS18B20_Stats_Snapshot before giving up
+#define DS18B20_STATS_ATTEMPTS		4U
+
+// Nominal bus time of the operations, in µs (see DS18B20_Start, DS18B20_writeData and searchBit)
+#define DS18B20_STATS_RESET_US		960U
+#define DS18B20_STATS_BYTE_US		520U
+#define DS18B20_STATS_SEARCH_BIT_US	195U
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Counters of a bus, since DS18B20_Stats_Init */
+typedef struct
+{
+	uint32_t resets;				// Reset pulses sent
+	uint32_t presence_failures;		// Reset pulses without presence pulse
+	uint32_t bytes_written;
+	uint32_t bytes_read;
+	uint32_t search_bits;			// Address bits walked by the searches
+	uint32_t crc_errors;			// ROM codes and scratchpads with a wrong CRC
+	uint32_t retries;				// Operations started again after a failure
+
+	uint32_t conversions;			// Calls of DS18B20_WaitConversion
+	uint32_t conversion_wait_ms;	// Time spent in DS18B20_WaitConversion, sleeping included
+	uint32_t busy_wait_ms;			// Part of it, and of EEPROM copies, spent polling or spinning
+
+	uint32_t sweep_ms[DS18B20_STATS_BUCKETS];		// Latency of the sweeps of the bus, in ms
+	uint32_t transaction_us[DS18B20_STATS_BUCKETS];	// Latency of the scratchpad reads, in µs
+
+} DS18B20_Counters_t;
+
+/* Statistics of a bus */
+typedef struct
+{
+	// Odd while the driver updates the counters
+	atomic_uint_least32_t sequence;
+
+	DS18B20_Counters_t counters;
+
+} DS18B20_Stats_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+void DS18B20_Stats_Init(DS18B20_Stats_t *stats);
+
+bool DS18B20_Stats_Snapshot(DS18B20_Stats_t *stats, DS18B20_Counters_t *snapshot);
+
+uint64_t DS18B20_Stats_BusTime(const DS18B20_Counters_t *counters);
+
+/* Index of the histogram bucket of a value */
+static inline uint8_t DS18B20_Stats_Bucket(uint32_t value)
+{
+	uint8_t bucket = (value == 0U) ? 0U : (uint8_t)(32U - (uint32_t)__builtin_clz(value));
+
+	return (bucket < DS18B20_STATS_BUCKETS) ? bucket : (uint8_t)(DS18B20_STATS_BUCKETS - 1U);
+}
+
+/* Open an update of the counters (driver side) */
+static inline void DS18B20_Stats_Begin(DS18B20_Stats_t *stats)
+{
+	// Only the driver writes the sequence, so a relaxed load is enough
+	uint32_t sequence = atomic_load_explicit(&stats->sequence, memory_order_relaxed);
+
+	atomic_store_explicit(&stats->sequence, sequence + 1U, memory_order_relaxed);
+	// The odd sequence is visible before any of the counters changes
+	atomic_thread_fence(memory_order_release);
+}
+
+/* Close an update of the counters (driver side) */
+static inline void DS18B20_Stats_End(DS18B20_Stats_t *stats)
+{
+	uint32_t sequence = atomic_load_explicit(&stats->sequence, memory_order_relaxed);
+
+	// The counters are visible before the even sequence
+	atomic_store_explicit(&stats->sequence, sequence + 1U, memory_order_release);
+}
+
+// Used by the driver, nothing is counted if the bus has no statistics
+#define DS18B20_STATS_ADD(stats, counter, value) \
+	do { \
+		if ((stats) != NULL) \
+		{ \
+			DS18B20_Stats_Begin(stats); \
+			(stats)->counters.counter += (value); \
+			DS18B20_Stats_End(stats); \
+		} \
+	} while (0)
+
+#define DS18B20_STATS_HISTOGRAM(stats, histogram, value) \
+	DS18B20_STATS_ADD((stats), histogram[DS18B20_Stats_Bucket(value)], 1U)
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_STATS_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,101 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_telemetry.h                                                                       */
+/*                                                                                           */
+/* Binary telemetry frames of DS18B20 samples, sent through a UART with DMA                  */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_TELEMETRY_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_TELEMETRY_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+/** Include standard libraries */
+#include <stdatomic.h>		// Required for the flags shared with the DMA interrupt
+
+//!\ Frame, little-endian:
+//!\   sync (0xA5 0x5A), length (uint16, bytes from seq to the last entry), seq (uint16),
+//!\   timestamp (uint32, HAL tick of the first sample), count (uint8), count entries,
+//!\   CRC16 (CCITT, initial value 0xFFFF, over length to the last entry)
+//!\ Entry, 7 bytes: slot (uint16), value (int16, Q12.4), bus << 4 | status (uint8),
+//!\   delta (uint16, ms from the timestamp of the frame to the one of the sample)
+//!\ A frame holds the samples of DS18B20_TELEMETRY_WINDOW_MS from its first one, so the
+//!\ samples of several sweeps, or of a sensor sampled on its own, share a header.
+//!\ The frames are decoded on the host by Tools/ds18b20_telemetry.py.
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// First bytes of a frame
+#define DS18B20_TELEMETRY_SYNC0			0xA5U
+#define DS18B20_TELEMETRY_SYNC1			0x5AU
+
+// Sizes of a frame, in bytes
+#define DS18B20_TELEMETRY_HEADER_SIZE	11U		// sync, length, seq, timestamp, count
+#define DS18B20_TELEMETRY_ENTRY_SIZE	7U
+#define DS18B20_TELEMETRY_CRC_SIZE		2U
+
+// Number of samples of a frame, a full frame is sent at once
+#ifndef DS18B20_TELEMETRY_ENTRIES
+#define DS18B20_TELEMETRY_ENTRIES		48U
+#endif
+
+// Time span of the samples of a frame in ms, 65535 at most (delta of an entry)
+#ifndef DS18B20_TELEMETRY_WINDOW_MS
+#define DS18B20_TELEMETRY_WINDOW_MS		10000U
+#endif
+
+#define DS18B20_TELEMETRY_FRAME_SIZE	(DS18B20_TELEMETRY_HEADER_SIZE \
+										 + (DS18B20_TELEMETRY_ENTRIES * DS18B20_TELEMETRY_ENTRY_SIZE) \
+										 + DS18B20_TELEMETRY_CRC_SIZE)
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Telemetry of one UART */
+//!\ Two frame buffers: the samples are added to one while the DMA sends the other.
+typedef struct
+{
+	UART_HandleTypeDef *huart;			// UART, with a DMA channel for its transmission
+
+	uint8_t buffers[2][DS18B20_TELEMETRY_FRAME_SIZE];
+	uint8_t filling;					// Buffer the samples are added to
+	uint8_t count;						// Samples in this buffer
+
+	atomic_bool ready;					// Frame of the filling buffer complete, waiting for the DMA
+	atomic_bool busy;					// DMA sending the other buffer
+
+	uint16_t sequence;					// Sequence number of the next frame
+	uint32_t frames;					// Number of frames sent
+	uint32_t overruns;					// Number of samples dropped because both buffers were in use
+
+} DS18B20_Telemetry_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+error_t DS18B20_Telemetry_Init(DS18B20_Telemetry_t *telemetry, UART_HandleTypeDef *huart);
+
+void DS18B20_Telemetry_Deliver(void *context, const DS18B20_Sample_t *sample);
+
+uint8_t DS18B20_Telemetry_Flush(DS18B20_Telemetry_t *telemetry);
+
+void DS18B20_Telemetry_TxComplete(DS18B20_Telemetry_t *telemetry, UART_HandleTypeDef *huart);
+
+uint16_t DS18B20_Telemetry_CRC(const uint8_t data[], uint16_t length);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_TELEMETRY_H_ */
+
+/********************************** END OF FILE ******************************************** */
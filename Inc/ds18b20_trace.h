@@ -0,0 +1,120 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_trace.h                                                                           */
+/*                                                                                           */
+/* Optional trace of the 1-Wire bus transactions, with timer timestamps                      */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef INC_DS18B20_TRACE_H_
+// Header guard to prevent multiple inclusions
+#define INC_DS18B20_TRACE_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+/** Include DS18B20 driver */
+#include "ds18b20.h"
+
+//!\ The trace is only built if DS18B20_TRACE is defined: otherwise the macros used by the
+//!\ driver are empty and the trace costs nothing.
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Number of records kept (power of two), the oldest ones are overwritten
+#ifndef DS18B20_TRACE_SIZE
+#define DS18B20_TRACE_SIZE		1024U
+#endif
+
+// Data of a DS18B20_TRACE_SEARCH record
+#define DS18B20_TRACE_SEARCH_BIT		0x0100U		// Direction written
+#define DS18B20_TRACE_SEARCH_CONFLICT	0x0200U		// Both values were read
+#define DS18B20_TRACE_SEARCH_ERROR		0x0400U		// No device answered
+
+// Data of a DS18B20_TRACE_CRC record
+#define DS18B20_TRACE_CRC_SCRATCHPAD	0x0100U		// Set for a scratchpad, clear for a ROM code
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Type of a trace record */
+typedef enum
+{
+	DS18B20_TRACE_RESET = 0,	// Reset pulse, data = 1 if a presence pulse was seen
+	DS18B20_TRACE_WRITE,		// Byte written, data = byte
+	DS18B20_TRACE_READ,			// Byte read, data = byte
+	DS18B20_TRACE_SEARCH,		// Search bit, data = bit position | DS18B20_TRACE_SEARCH_xxx
+	DS18B20_TRACE_CRC,			// CRC check, data = 0 if OK, 1 otherwise | DS18B20_TRACE_CRC_SCRATCHPAD
+
+} DS18B20_TraceType_t;
+
+/* Trace record */
+typedef struct
+{
+	uint32_t timestamp;		// Timer counter (µs) at the start of the operation
+	uint8_t type;			// DS18B20_TraceType_t
+	uint8_t bus;			// bus_id of the bus
+	uint16_t data;
+
+} DS18B20_TraceRecord_t;
+
+#ifdef DS18B20_TRACE
+
+/* Trace ring */
+typedef struct
+{
+	DS18B20_TraceRecord_t records[DS18B20_TRACE_SIZE];
+	uint32_t head;			// Number of records written since the last clear
+
+} DS18B20_Trace_t;
+
+_Static_assert((DS18B20_TRACE_SIZE & (DS18B20_TRACE_SIZE - 1U)) == 0U, "DS18B20_TRACE_SIZE shall be a power of two");
+
+extern DS18B20_Trace_t DS18B20_trace;
+
+#endif
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+#ifdef DS18B20_TRACE
+
+/* Store a record, the oldest one is overwritten when the ring is full */
+//!\ Not reentrant: the buses shall be driven from a single context while tracing.
+static inline void DS18B20_Trace_Record(uint8_t bus, uint8_t type, uint16_t data, uint32_t timestamp)
+{
+	DS18B20_TraceRecord_t *record = &DS18B20_trace.records[DS18B20_trace.head & (DS18B20_TRACE_SIZE - 1U)];
+
+	record->timestamp = timestamp;
+	record->type = type;
+	record->bus = bus;
+	record->data = data;
+
+	DS18B20_trace.head++;
+}
+
+// Used by the driver: take the timestamp at the start of an operation, record it at the end
+#define DS18B20_TRACE_START(sensor)				uint32_t trace_start = __HAL_TIM_GET_COUNTER(&(sensor)->htim)
+#define DS18B20_TRACE_EVENT(sensor, type, data)	DS18B20_Trace_Record((sensor)->bus_id, (type), (data), trace_start)
+
+void DS18B20_Trace_Dump(void);
+
+void DS18B20_Trace_Clear(void);
+
+#else
+
+#define DS18B20_TRACE_START(sensor)
+#define DS18B20_TRACE_EVENT(sensor, type, data)
+
+#endif
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* INC_DS18B20_TRACE_H_ */
+
+/********************************** END OF FILE ******************************************** */
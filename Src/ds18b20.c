@@ -9,6 +9,7 @@
 /******************************************************************************************* */
 
 #include "ds18b20.h"
+#include "ds18b20_trace.h"
 
 /******************************* STATIC FUNCTIONS BEGIN ************************************ */
 
@@ -26,10 +27,22 @@ static uint8_t DS18B20_readByte(DS18B20_t *sensor);
 static uint8_t DS18B20_read(DS18B20_t *sensor);
 
 static uint8_t onewireSearchInit(onewire_search_state_t *state);
-static uint8_t searchNext(DS18B20_t *sensor, onewire_search_state_t *state);
-static uint8_t searchDevices(DS18B20_t *sensor, uint8_t command, onewire_search_state_t *state);
+static uint8_t searchBit(DS18B20_t *sensor, onewire_search_state_t *state);
+static uint8_t searchFamily(DS18B20_t *sensor, uint8_t family, uint64_t ROM_codes_array[]);
 static uint8_t crcGenerator(uint8_t initial_crc, uint8_t input);
 static uint8_t addressValid(const uint8_t ROM_code[]);
+static uint8_t crcCompute(const uint8_t data[], uint8_t length);
+
+static uint8_t DS18B20_Select(DS18B20_t *sensor, uint64_t ROM_code);
+static void DS18B20_StrongPullup(DS18B20_t *sensor, bool enable);
+static void DS18B20_DeliverToRing(void *context, const DS18B20_Sample_t *sample);
+static uint8_t DS18B20_WriteRegisters(DS18B20_t *sensor, uint64_t ROM_code, uint8_t th, uint8_t tl, uint8_t config);
+static void DS18B20_Shadow(DS18B20_Channel_t *channel, uint64_t ROM_code, const uint8_t scratchpad[]);
+static bool DS18B20_ShadowMatches(const DS18B20_Channel_t *channel, uint64_t ROM_code, uint8_t th, uint8_t tl,
+                                  uint8_t config);
+static bool DS18B20_Suspect(uint64_t ROM_code, const uint8_t scratchpad[], const DS18B20_Sample_t *sample,
+                            const DS18B20_Channel_t *channel);
+static bool DS18B20_TooFast(const DS18B20_Sample_t *sample, const DS18B20_Channel_t *channel);
 
 /******************************* STATIC FUNCTIONS END ************************************** */
 
@@ -54,11 +67,29 @@ error_t DS18B20_Init(DS18B20_t *sensor)
 	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
 	HAL_GPIO_Init(sensor->gpio_port, &GPIO_InitStruct);
 
+	// Initialize the optional MOSFET gate of the strong pull-up, pull-up off
+	if (sensor->pullup_port != NULL)
+	{
+		sensor->pullup_on = true;
+		DS18B20_StrongPullup(sensor, false);
+
+		GPIO_InitStruct.Pin = sensor->pullup_pin;
+		GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+		HAL_GPIO_Init(sensor->pullup_port, &GPIO_InitStruct);
+	}
+	sensor->pullup_on = false;
+
 	// Initialize the timer for the sensor
 	if (DS18B20_Timer_Init(sensor) != 0)
 	{
 		result = ERROR_OTHER;
 	}
+	else
+	{
+		// Parasite-powered sensors cannot signal the end of a conversion
+		sensor->parasite = DS18B20_ReadPowerSupply(sensor);
+		log_ds18b20(DS18B20_LOG_PARASITE, sensor->parasite);
+	}
 
 	return result;
 }
@@ -105,7 +136,7 @@ error_t DS18B20_Timer_Init(DS18B20_t *sensor)
 
 	sensor->htim.Instance = sensor->timer_instance;
 	sensor->htim.Init.Prescaler = prescaler;
-	sensor->htim.Init.Period = -1U; // Max value (we don't care because not a periodic timer)
+	sensor->htim.Init.Period = -1U; // Max value: the counter is free-running, see DS18B20_delay
 	sensor->htim.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
 	sensor->htim.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
 	if (HAL_TIM_Base_Init(&sensor->htim) != HAL_OK)
@@ -133,18 +164,31 @@ error_t DS18B20_Timer_Init(DS18B20_t *sensor)
 }
 
 /* Count us microseconds */
+//!\ The timer is free-running, so that its counter can also timestamp the traces.
+//!\ The auto-reload value is all ones (16 or 32 bits), which makes the masked difference
+//!\ correct across a wrap of the counter.
 void DS18B20_delay(DS18B20_t *sensor, uint16_t us)
 {
+	uint32_t period = __HAL_TIM_GET_AUTORELOAD(&sensor->htim);
+	uint32_t start = __HAL_TIM_GET_COUNTER(&sensor->htim);
 
-	__HAL_TIM_SET_COUNTER(&sensor->htim, 0); // set the counter value at 0
-	while (__HAL_TIM_GET_COUNTER(&sensor->htim) < us)
-		; // wait for the counter to reach the us input in the parameter
+	while (((__HAL_TIM_GET_COUNTER(&sensor->htim) - start) & period) < us)
+		; // wait for the counter to advance by the us input in the parameter
 }
 
 /* Transaction initialization sequence of the DS18B20 */
 uint8_t DS18B20_Start(DS18B20_t *sensor)
 {
 	uint8_t response = 0;
+	DS18B20_TRACE_START(sensor);
+
+	// A new transaction ends the strong pull-up of a conversion or of an EEPROM copy
+	if (sensor->pullup_on)
+	{
+		DS18B20_StrongPullup(sensor, false);
+	}
+
+	sensor->reset_count++;
 
 	HAL_GPIO_WritePin(sensor->gpio_port, sensor->gpio_pin, GPIO_PIN_RESET); // pull the pin low
 	DS18B20_delay(sensor, 480);												// wait at least 480µs low according to datasheet
@@ -166,6 +210,14 @@ uint8_t DS18B20_Start(DS18B20_t *sensor)
 
 	DS18B20_delay(sensor, 400); // at least 480 us DS18B20_delay totally, according to datasheet
 
+	DS18B20_TRACE_EVENT(sensor, DS18B20_TRACE_RESET, response);
+
+	DS18B20_STATS_ADD(sensor->stats, resets, 1U);
+	if (response == 0)
+	{
+		DS18B20_STATS_ADD(sensor->stats, presence_failures, 1U);
+	}
+
 	return response;
 }
 
@@ -198,6 +250,7 @@ uint8_t DS18B20_readByte(DS18B20_t *sensor)
 {
 
 	uint8_t value = 0;
+	DS18B20_TRACE_START(sensor);
 
 	for (uint8_t i = 0; i < 8; i++)
 	{
@@ -206,6 +259,9 @@ uint8_t DS18B20_readByte(DS18B20_t *sensor)
 		value |= bit << i;
 	}
 
+	DS18B20_TRACE_EVENT(sensor, DS18B20_TRACE_READ, value);
+	DS18B20_STATS_ADD(sensor->stats, bytes_read, 1U);
+
 	return value;
 }
 
@@ -242,6 +298,7 @@ uint8_t DS18B20_write1(DS18B20_t *sensor)
 /* Write a byte to the sensor*/
 uint8_t DS18B20_writeData(DS18B20_t *sensor, uint8_t data)
 {
+	DS18B20_TRACE_START(sensor);
 
 	for (uint8_t i = 0; i < 8; i++)
 	{
@@ -258,6 +315,9 @@ uint8_t DS18B20_writeData(DS18B20_t *sensor, uint8_t data)
 		}
 	}
 
+	DS18B20_TRACE_EVENT(sensor, DS18B20_TRACE_WRITE, data);
+	DS18B20_STATS_ADD(sensor->stats, bytes_written, 1U);
+
 	return 0; // OK
 }
 
@@ -266,6 +326,11 @@ uint8_t onewireSearchInit(onewire_search_state_t *state)
 {
 	state->last_zero_branch = -1;
 	state->done = false;
+	state->in_progress = false;
+	state->bit_position = 0;
+	state->local_last_zero_branch = -1;
+	state->walked = false;
+	state->family = 0;
 
 	// Zero-fill the address
 	for (int i = 0; i < 8; i++)
@@ -277,7 +342,8 @@ uint8_t onewireSearchInit(onewire_search_state_t *state)
 	return 0; // OK
 }
 
-uint8_t searchNext(DS18B20_t *sensor, onewire_search_state_t *state)
+/* Walk one bit of the address of the device being searched */
+uint8_t searchBit(DS18B20_t *sensor, onewire_search_state_t *state)
 {
 	// States of ROM search DS18B20_reads
 	enum
@@ -287,67 +353,67 @@ uint8_t searchNext(DS18B20_t *sensor, onewire_search_state_t *state)
 		kOne = 0x01,
 	};
 
+	uint8_t result = 0;
+	DS18B20_TRACE_START(sensor);
+
 	// Value to write to the current position
 	uint8_t bitValue = 0;
 
-	// Keep track of the last zero branch within this search
-	// If this value is not updated, the search is complete
-	int8_t locallast_zero_branch = -1;
-
-	for (uint8_t bitPosition = 0; bitPosition < 64; bitPosition++)
-	{
-
-		// Calculate bitPosition as an index in the address array
-		// This is written as-is for DS18B20_readability. Compilers should reduce this to bit shifts and tests
-		uint8_t byteIndex = bitPosition / 8;
-		uint8_t bitIndex = bitPosition % 8;
+	// Calculate bitPosition as an index in the address array
+	// This is written as-is for DS18B20_readability. Compilers should reduce this to bit shifts and tests
+	uint8_t bitPosition = state->bit_position;
+	uint8_t byteIndex = bitPosition / 8;
+	uint8_t bitIndex = bitPosition % 8;
 
-		// DS18B20_read the current bit and its complement from the bus
-		uint8_t DS18B20_reading = 0;
-		DS18B20_reading |= DS18B20_read(sensor);	  // Bit
-		DS18B20_reading |= DS18B20_read(sensor) << 1; // Complement of bit (negated)
+	// DS18B20_read the current bit and its complement from the bus
+	uint8_t DS18B20_reading = 0;
+	DS18B20_reading |= DS18B20_read(sensor);	  // Bit
+	DS18B20_reading |= DS18B20_read(sensor) << 1; // Complement of bit (negated)
 
-		switch (DS18B20_reading)
+	switch (DS18B20_reading)
+	{
+	case kZero:
+	case kOne:
+		// Bit was the same on all responding devices: it is a known value
+		// The first bit is the value we want to write (rather than its complement)
+		bitValue = (DS18B20_reading & 0x1);
+		break;
+
+	case kConflict:
+		// Both 0 and 1 were written to the bus
+		// Use the search state to continue walking through devices
+		if (bitPosition == state->last_zero_branch)
 		{
-		case kZero:
-		case kOne:
-			// Bit was the same on all responding devices: it is a known value
-			// The first bit is the value we want to write (rather than its complement)
-			bitValue = (DS18B20_reading & 0x1);
-			break;
-
-		case kConflict:
-			// Both 0 and 1 were written to the bus
-			// Use the search state to continue walking through devices
-			if (bitPosition == state->last_zero_branch)
-			{
-				// Current bit is the last position the previous search chose a zero: send one
-				bitValue = 1;
-			}
-			else if (bitPosition < state->last_zero_branch)
-			{
-				// Before the last_zero_branch position, repeat the same choices as the previous search
-				bitValue = state->address[byteIndex] & (1 << bitIndex);
-			}
-			else
-			{
-				// Current bit is past the last_zero_branch in the previous search: send zero
-				bitValue = 0;
-			}
+			// Current bit is the last position the previous search chose a zero: send one
+			bitValue = 1;
+		}
+		else if (bitPosition < state->last_zero_branch)
+		{
+			// Before the last_zero_branch position, repeat the same choices as the previous search
+			bitValue = (state->address[byteIndex] >> bitIndex) & 0x1;
+		}
+		else
+		{
+			// Current bit is past the last_zero_branch in the previous search: send zero
+			bitValue = 0;
+		}
 
-			// Remember the last branch where a zero was written for the next search
-			if (bitValue == 0)
-			{
-				locallast_zero_branch = bitPosition;
-			}
+		// Remember the last branch where a zero was written for the next search
+		if (bitValue == 0)
+		{
+			state->local_last_zero_branch = bitPosition;
+		}
 
-			break;
+		break;
 
-		default:
-			// If we see "11" there was a problem on the bus (no devices pulled it low)
-			return false;
-		}
+	default:
+		// If we see "11" there was a problem on the bus (no devices pulled it low)
+		result = 1;
+		break;
+	}
 
+	if (result == 0)
+	{
 		// Write bit into address
 		if (bitValue == 0)
 		{
@@ -355,7 +421,7 @@ uint8_t searchNext(DS18B20_t *sensor, onewire_search_state_t *state)
 		}
 		else
 		{
-			state->address[byteIndex] |= (bitValue << bitIndex);
+			state->address[byteIndex] |= (1 << bitIndex);
 		}
 
 		// Write bit to the bus to continue the search
@@ -367,37 +433,14 @@ uint8_t searchNext(DS18B20_t *sensor, onewire_search_state_t *state)
 		{
 			DS18B20_write1(sensor);
 		}
-	}
 
-	// If the no branch points were found, mark the search as done.
-	// Otherwise, mark the last zero branch we found for the next search
-	if (locallast_zero_branch == -1)
-	{
-		state->done = true;
+		state->bit_position++;
 	}
-	else
-	{
-		state->last_zero_branch = locallast_zero_branch;
-	}
-
-	// DS18B20_read a whole address - return OK
-	return 0;
-}
 
-/* Search for devices on the 1-Wire bus */
-uint8_t searchDevices(DS18B20_t *sensor, uint8_t command, onewire_search_state_t *state)
-{
-	uint8_t result = 0;
-	// Bail out if the previous search was the end or if no sensor on the bus
-	if ( (state->done) || (DS18B20_Start(sensor) == 0) )
-	{
-		result = 1;
-	}
-	else
-	{
-		DS18B20_writeData(sensor, command);
-		result = searchNext(sensor, state);
-	}
+	DS18B20_TRACE_EVENT(sensor, DS18B20_TRACE_SEARCH, bitPosition | (bitValue ? DS18B20_TRACE_SEARCH_BIT : 0U)
+						| ((DS18B20_reading == kConflict) ? DS18B20_TRACE_SEARCH_CONFLICT : 0U)
+						| ((result != 0) ? DS18B20_TRACE_SEARCH_ERROR : 0U));
+	DS18B20_STATS_ADD(sensor->stats, search_bits, 1U);
 
 	return result;	// returns 0 if OK, 1 otherwise
 }
@@ -409,7 +452,7 @@ uint8_t crcGenerator(uint8_t initial_crc, uint8_t input)
 	// Input is supposed to be a Byte where the most left bit is MSB (input not reversed).
 
 	// 1. Calculate the CRC of data 0x00 to 0xFF and store them into one array in order.
-	const uint8_t crc8_table[256] = {
+	static const uint8_t crc8_table[256] = {
 		0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
 		0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E, 0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
 		0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
@@ -465,6 +508,20 @@ uint8_t addressValid(const uint8_t ROM_code[])
 	return result;	// returns 0 if OK, 1 otherwise
 }
 
+/* Compute the CRC of a buffer, as done by the sensor on its ROM code and scratchpad */
+uint8_t crcCompute(const uint8_t data[], uint8_t length)
+{
+	// Initially, the CRC is equal to 0 according to datasheet
+	uint8_t crc = 0x00;
+
+	for (uint8_t i = 0; i < length; i++)
+	{
+		crc = crcGenerator(crc, data[i]);
+	}
+
+	return crc;
+}
+
 /* Search all sensors on the 1-Wire bus and return a chained list of ther ROM Codes */
 //!\ This function uses a chained list to search for all the sensors on the bus when the
 //!\ exact number of sensors present is unknown. Though this is an interesting programming
@@ -550,7 +607,43 @@ uint8_t addressValid(const uint8_t ROM_code[])
 } */
 
 /* Search all sensors on the 1-wire bus */
+//!\ Only the temperature sensors are stored: the other devices of the bus (ID chips,
+//!\ switches...) are skipped by searching the branch of each sensor family in turn.
 uint8_t DS18B20_Search(DS18B20_t *sensor, uint64_t ROM_codes_array[])
+{
+	static const uint8_t families[] = { DS18B20_FAMILY_DS18B20, DS18B20_FAMILY_DS1822,
+	                                    DS18B20_FAMILY_DS18S20, DS18B20_FAMILY_MAX31850 };
+
+	// The detected ROM Codes will be stored in an array of uint64_t, provided as argument
+	// of the function (ROM_codes_array). Its lenght shall be greater than the number of
+	// sensors on the bus, as the array is terminated by a 0.
+
+	uint8_t index = 0;
+
+	log_ds18b20(DS18B20_LOG_SEARCHING);
+
+	for (uint8_t i = 0; i < sizeof(families); i++)
+	{
+		index += searchFamily(sensor, families[i], &ROM_codes_array[index]);
+	}
+
+	ROM_codes_array[index] = 0ULL; // End of the array
+
+	return 0; // OK
+}
+
+/* Search the devices of one family on the 1-wire bus, or all of them if family is 0 */
+uint8_t DS18B20_SearchFamily(DS18B20_t *sensor, uint8_t family, uint64_t ROM_codes_array[])
+{
+	uint8_t index = searchFamily(sensor, family, ROM_codes_array);
+
+	ROM_codes_array[index] = 0ULL; // End of the array
+
+	return 0; // OK
+}
+
+/* Store the ROM codes of the devices of one family, returns the number of devices found */
+uint8_t searchFamily(DS18B20_t *sensor, uint8_t family, uint64_t ROM_codes_array[])
 {
 	// Searching ROM codes of all sensors is more complicated than just sending
 	// the Search ROM Command and wait for responses.
@@ -558,52 +651,346 @@ uint8_t DS18B20_Search(DS18B20_t *sensor, uint64_t ROM_codes_array[])
 	// data through a certain process.
 
 	onewire_search_state_t search_state;
-	onewireSearchInit(&search_state);
-
-	// The detected ROM Codes will be stored in an array of uint64_t, provided as argument
-	// of the function (ROM_codes_array). Its lenght shall be greater than the number of
-	// sensors on the bus.
+	DS18B20_SearchInitFamily(&search_state, family);
 
 	uint8_t index = 0;
-	uint8_t count = 0;
+	uint8_t status = DS18B20_SEARCH_FOUND;
+	uint64_t ROM_code = 0ULL;
 
-	log_ds18b20("Searching devices...\n\r");
+	while ((status == DS18B20_SEARCH_FOUND) || (status == DS18B20_SEARCH_CRC_ERROR))
+	{
+		status = DS18B20_SearchNext(sensor, &search_state, &ROM_code);
 
-	while (searchDevices(sensor, SEARCH_ROM, &search_state))
+		if (status == DS18B20_SEARCH_FOUND)
+		{
+			ROM_codes_array[index] = ROM_code;
+			index++;
+
+			// Display the detected ROM Code of the sensor through serial.
+			log_ds18b20(DS18B20_LOG_ROM_CODE, index,
+						(unsigned long)(ROM_code >> 32), (unsigned long)ROM_code);
+		}
+		else if (status == DS18B20_SEARCH_CRC_ERROR)
+		{
+			// Display through Serial
+			log_ds18b20(DS18B20_LOG_ROM_INVALID);
+		}
+	}
+
+	return index;
+}
+
+/* Write the same alarm and configuration registers to all the sensors of the bus */
+//!\ The registers of each sensor are compared with its shadow (read again if it is not valid),
+//!\ and only the sensors whose registers differ are written, and copied to EEPROM if persist
+//!\ is set. A COPY_SCRATCHPAD holds the bus for 10ms and wears the EEPROM: in the common case
+//!\ where nothing changed, nothing is written. If every sensor differs, a single SKIP_ROM
+//!\ write and copy is used; the bus shall then carry only the sensors of the array.
+//!\ The EEPROM is assumed to match the scratchpad, as it does after power-up and after a
+//!\ provisioning with persist set. A DS18S20 has no configuration register: only its TH
+//!\ and TL are compared and written. Requires sensor->channels.
+error_t DS18B20_Provision(DS18B20_t *sensor, const uint64_t ROM_codes_array[], uint8_t th, uint8_t tl,
+                          uint8_t config, bool persist)
+{
+	error_t result = OK;
+	uint16_t count = 0;
+	uint16_t differ = 0;
+	bool broadcast = true;	// Every sensor can be written by a broadcast
+
+	if ((ROM_codes_array == NULL) || (sensor->channels == NULL))
+	{
+		result = NULL_POINTER;
+	}
+
+	// Compare each sensor with its shadow
+	for (uint16_t slot = 0; (result == OK) && (ROM_codes_array[slot] != 0); slot++)
 	{
+		DS18B20_Channel_t *channel = DS18B20_Channel(sensor, slot);
+		uint8_t scratchpad[DS18B20_SCRATCHPAD_SIZE] = {0};
 
-		// Store the detected ROM code in the field ROM code of the current
-		// ROM_code_Address structure.
+		count++;
 
-		ROM_codes_array[index] = 0ULL;
+		if ((ROM_codes_array[slot] == DS18B20_FREE_SLOT)
+			|| ((uint8_t)(ROM_codes_array[slot] >> 56) == DS18B20_FAMILY_MAX31850))
+		{
+			broadcast = false; // Nothing to write in this slot
+			continue;
+		}
 
-		for (int i = 0; i < 8; i++)
+		if (channel == NULL)
 		{
-			// ROM codes are stored MSB first
-			ROM_codes_array[index] |= search_state.address[i] << 8*(7-i);
+			result = ERROR_OTHER; // More sensors than channels
+		}
+		else if ((channel->shadow_valid == false)
+			&& (DS18B20_ReadScratchpad(sensor, ROM_codes_array[slot], scratchpad) == DS18B20_SAMPLE_OK))
+		{
+			DS18B20_Shadow(channel, ROM_codes_array[slot], scratchpad);
 		}
 
-		// Check is the received ROM code is valid
-		if (addressValid(&ROM_codes_array[index]))
+		if (result != OK)
 		{
-			// Display through Serial
-			log_ds18b20("Received valid ROM code !\n\r");
+			// Stop comparing
+		}
+		else if (channel->shadow_valid == false)
+		{
+			broadcast = false; // Not read, write it on its own
+			differ++;
+		}
+		else if (DS18B20_ShadowMatches(channel, ROM_codes_array[slot], th, tl, config) == false)
+		{
+			differ++;
 		}
 		else
 		{
-			// Display through Serial
-			log_ds18b20("Received ROM code not valid !\n\r");
+			broadcast = false;
 		}
+	}
 
-		count++;
+	// The copy current of all the sensors at once shall be supplied
+	broadcast = (broadcast) && (differ > 1U) && (DS18B20_GroupSize(sensor) >= count);
 
-		// Display the detected ROM Code of the sensor through serial.
-		log_ds18b20("ROM Code for sensor %u: %x \n\r", count, ROM_codes_array[index]);
+	log_ds18b20(DS18B20_LOG_PROVISIONING, differ, count);
 
-		index++;
+	if ((result == OK) && (broadcast))
+	{
+		if ((DS18B20_WriteRegisters(sensor, 0ULL, th, tl, config) != 0)
+			|| ((persist) && (DS18B20_CopyScratchpad(sensor, 0ULL) != 0)))
+		{
+			result = ERROR_OTHER;
+		}
 	}
 
-	return 0; // OK
+	for (uint16_t slot = 0; (result == OK) && (differ > 0U) && (slot < count); slot++)
+	{
+		DS18B20_Channel_t *channel = DS18B20_Channel(sensor, slot);
+
+		if ((ROM_codes_array[slot] == DS18B20_FREE_SLOT)
+			|| ((uint8_t)(ROM_codes_array[slot] >> 56) == DS18B20_FAMILY_MAX31850)
+			|| (DS18B20_ShadowMatches(channel, ROM_codes_array[slot], th, tl, config)))
+		{
+			continue; // Nothing to write, or already up to date
+		}
+
+		if ((broadcast == false)
+			&& ((DS18B20_WriteRegisters(sensor, ROM_codes_array[slot], th, tl, config) != 0)
+				|| ((persist) && (DS18B20_CopyScratchpad(sensor, ROM_codes_array[slot]) != 0))))
+		{
+			channel->shadow_valid = false;
+			result = ERROR_OTHER;
+		}
+		else
+		{
+			channel->th = th;
+			channel->tl = tl;
+			if ((uint8_t)(ROM_codes_array[slot] >> 56) != DS18B20_FAMILY_DS18S20)
+			{
+				channel->config = config;
+			}
+			channel->shadow_valid = true;
+		}
+	}
+
+	return result;
+}
+
+/* Get the channel of a slot, NULL if the bus has no channel for it */
+DS18B20_Channel_t *DS18B20_Channel(DS18B20_t *sensor, uint16_t slot)
+{
+	return ((sensor->channels != NULL) && (slot < sensor->channel_count)) ? &sensor->channels[slot] : NULL;
+}
+
+/* Forget the state kept for the sensor of a slot, e.g. when another sensor takes the slot */
+//!\ The settings of the channel (deadband, filter, max_rate...) belong to the slot and are kept.
+void DS18B20_Channel_Reset(DS18B20_t *sensor, uint16_t slot)
+{
+	DS18B20_Channel_t *channel = DS18B20_Channel(sensor, slot);
+
+	if (channel != NULL)
+	{
+		channel->th = 0;
+		channel->tl = 0;
+		channel->config = 0;
+		channel->shadow_valid = false;
+
+		channel->reported = 0;
+		channel->reported_status = 0;
+		channel->trend = 0;
+		channel->reported_at = 0;
+		channel->reported_valid = false;
+
+		channel->previous[0] = 0;
+		channel->previous[1] = 0;
+		channel->previous_count = 0;
+		channel->ema_valid = false;
+		channel->ema = 0;
+
+		channel->accepted = 0;
+		channel->accepted_at = 0;
+		channel->accepted_valid = false;
+	}
+}
+
+/* Compute the 1-Wire CRC of a ROM code or of a scratchpad */
+uint8_t DS18B20_CRC(const uint8_t data[], uint8_t length)
+{
+	return crcCompute(data, length);
+}
+
+/* Tell if a ROM code is the one of a supported temperature sensor */
+bool DS18B20_IsSensor(uint64_t ROM_code)
+{
+	uint8_t family = (uint8_t)(ROM_code >> 56);
+
+	return (family == DS18B20_FAMILY_DS18B20) || (family == DS18B20_FAMILY_DS1822)
+		   || (family == DS18B20_FAMILY_DS18S20) || (family == DS18B20_FAMILY_MAX31850);
+}
+
+/* Reset a search state, the next DS18B20_SearchNext returns the first device */
+void DS18B20_SearchInit(onewire_search_state_t *state)
+{
+	(void)onewireSearchInit(state);
+}
+
+/* Reset a search state to walk only the devices of one family, 0 for all of them */
+//!\ The family code is preset in the address and the last zero branch is set past the
+//!\ last bit, so that the first pass repeats the family bits at every conflict.
+void DS18B20_SearchInitFamily(onewire_search_state_t *state, uint8_t family)
+{
+	(void)onewireSearchInit(state);
+
+	if (family != 0)
+	{
+		state->family = family;
+		state->address[0] = family;
+		state->last_zero_branch = 64;
+	}
+}
+
+/* Find the next device of a search on the bus */
+uint8_t DS18B20_SearchNext(DS18B20_t *sensor, onewire_search_state_t *state, uint64_t *ROM_code)
+{
+	// A budget larger than a whole device never pauses the search
+	return DS18B20_SearchStep(sensor, state, UINT16_MAX, ROM_code);
+}
+
+/* Advance the search by at most max_slots time slots of the bus */
+//!\ The bus is idle between two bits, so the search can be paused there for as long as needed.
+//!\ If another transaction resets the bus in the meantime, the devices leave the search: the
+//!\ current device is then walked again from its first bit, along the same branches.
+//!\ The reset and the SEARCH_ROM command are never split, so the first call of a device may
+//!\ exceed the budget; at least one bit is walked per call otherwise.
+uint8_t DS18B20_SearchStep(DS18B20_t *sensor, onewire_search_state_t *state, uint16_t max_slots,
+                           uint64_t *ROM_code)
+{
+	uint8_t result = DS18B20_SEARCH_IN_PROGRESS;
+	uint16_t slots = 0;
+
+	// The devices left the search if the bus was reset since the last step
+	if ((state->in_progress) && (state->reset_count != sensor->reset_count))
+	{
+		state->in_progress = false;
+	}
+
+	if (state->done)
+	{
+		result = DS18B20_SEARCH_DONE;
+	}
+	else if (state->in_progress == false)
+	{
+		if (DS18B20_Start(sensor) != 0)
+		{
+			DS18B20_writeData(sensor, SEARCH_ROM);
+
+			state->in_progress = true;
+			state->bit_position = 0;
+			state->local_last_zero_branch = -1;
+			state->reset_count = sensor->reset_count;
+			slots = DS18B20_SEARCH_START_SLOTS;
+		}
+		else if (state->walked == false)
+		{
+			// No presence pulse before the first device: the bus is empty
+			state->done = true;
+			result = DS18B20_SEARCH_DONE;
+		}
+		else
+		{
+			// A device answered before: the presence pulse was lost to a glitch, or the
+			// devices left the bus during the search. The rest of the tree is not known.
+			result = DS18B20_SEARCH_BUS_ERROR;
+		}
+	}
+
+	while ((result == DS18B20_SEARCH_IN_PROGRESS) && (state->bit_position < 64)
+		   && ((slots == 0) || ((uint32_t)slots + DS18B20_SEARCH_BIT_SLOTS <= max_slots)))
+	{
+		if (searchBit(sensor, state) != 0)
+		{
+			state->in_progress = false;
+			result = DS18B20_SEARCH_BUS_ERROR;
+		}
+
+		slots += DS18B20_SEARCH_BIT_SLOTS;
+	}
+
+	if ((result == DS18B20_SEARCH_IN_PROGRESS) && (state->bit_position == 64))
+	{
+		state->in_progress = false;
+		state->walked = true;
+
+		// If the no branch points were found, mark the search as done.
+		// Otherwise, mark the last zero branch we found for the next search
+		if (state->local_last_zero_branch == -1)
+		{
+			state->done = true;
+		}
+		else
+		{
+			state->last_zero_branch = state->local_last_zero_branch;
+		}
+
+		// In a family search, the next device would leave the family if its first
+		// different bit is within the family code
+		if ((state->family != 0) && (state->last_zero_branch < 8))
+		{
+			state->done = true;
+		}
+
+		if ((state->family != 0) && (state->address[0] != state->family))
+		{
+			// No device of this family on the bus, the walk ended in another branch
+			state->done = true;
+			result = DS18B20_SEARCH_DONE;
+		}
+		else if (addressValid(state->address) != 0)
+		{
+			result = DS18B20_SEARCH_CRC_ERROR;
+		}
+		else
+		{
+			*ROM_code = 0ULL;
+
+			for (uint8_t i = 0; i < 8; i++)
+			{
+				// ROM codes are stored MSB first
+				*ROM_code |= (uint64_t)state->address[i] << 8*(7-i);
+			}
+
+			result = DS18B20_SEARCH_FOUND;
+		}
+
+		DS18B20_TRACE_START(sensor);
+		if (result != DS18B20_SEARCH_DONE)
+		{
+			DS18B20_TRACE_EVENT(sensor, DS18B20_TRACE_CRC, (result == DS18B20_SEARCH_CRC_ERROR));
+		}
+		if (result == DS18B20_SEARCH_CRC_ERROR)
+		{
+			DS18B20_STATS_ADD(sensor->stats, crc_errors, 1U);
+		}
+	}
+
+	return result;	// returns a DS18B20_SearchStatus_t
 }
 
 /* Get the temperature of all the detected sensors on the 1-Wire bus */
@@ -684,53 +1071,797 @@ uint8_t DS18B20_GetTemp(DS18B20_t *sensor, const uint64_t ROM_codes_array[], uin
 	// We will ask the temperature to each sensor and display it through Serial
 	// if the console is enabled.
 
-	uint8_t ROM_code_byte = 0;
 	uint8_t count = 0;
+	uint8_t result = 0;
 
 	// We will go through the array of ROM Codes
 	while (ROM_codes_array[count] != 0)
 	{
-		DS18B20_Start(sensor);				  // Initiate the transaction on the 1-Wire bus
-											  // sensor can be any of the sensors of the bus
-		DS18B20_writeData(sensor, MATCH_ROM); // Match ROM
+		DS18B20_Sample_t sample = {0};
+		sample.slot = count;
 
-		for (uint8_t i = 0; i < 8; i++)
-		{ // Send the ROM Code MSB first
-			ROM_code_byte = ( ROM_codes_array[count] >> 8*(7-i) ) & 0xFF;
-			DS18B20_writeData(sensor, ROM_code_byte);
+		if (ROM_codes_array[count] == DS18B20_FREE_SLOT)
+		{
+			// Nothing to convert in a free slot, its temperature is 0
+		}
+		else if (DS18B20_StartConversion(sensor, ROM_codes_array[count]) != 0)
+		{
+			sample.status = DS18B20_SAMPLE_NO_PRESENCE;
+		}
+		else if (DS18B20_WaitConversion(sensor, DS18B20_ConversionTime(sensor)) != 0)
+		{
+			sample.status = DS18B20_SAMPLE_TIMEOUT;
 		}
 
-		DS18B20_writeData(sensor, CONVERT_T); // Temperature conversion
+		if (ROM_codes_array[count] != DS18B20_FREE_SLOT)
+		{
+			// The scratchpad is decoded according to the family of the sensor (DS18B20, DS18S20...),
+			// and a power-on or disconnected value is converted and read again
+			sample.timestamp = HAL_GetTick();
+			DS18B20_ReadSample(sensor, ROM_codes_array[count], &sample);
 
-		DS18B20_Start(sensor);				  // Initiate the transaction
-		DS18B20_writeData(sensor, MATCH_ROM); // Match ROM
+			if (sample.status != DS18B20_SAMPLE_OK)
+			{
+				sample.value = 0;
+				result = 1;
+			}
 
-		for (uint8_t i = 0; i < 8; i++)
-		{ // Send the ROM Code MSB first again
+			// Display the temperature of the sensor through Serial
+			log_ds18b20(DS18B20_LOG_TEMPERATURE, count + 1, (uint16_t)(sample.value >> 4));
+		}
 
-			ROM_code_byte = ( ROM_codes_array[count] >> 8*(7-i) ) & 0xFF;
-			DS18B20_writeData(sensor, ROM_code_byte);
+		// Temperature in °C, without the 4 fractional bits
+		temperature[count] = (uint16_t)(sample.value >> 4);
+
+		count += 1; // Increment the sensor count
+	}
+
+	return result;	// returns 0 if OK, 1 if a temperature could not be read
+}
+
+/* Reset the bus and address one sensor, or all of them if ROM_code is 0 */
+uint8_t DS18B20_Select(DS18B20_t *sensor, uint64_t ROM_code)
+{
+	uint8_t result = 0;
+
+	if (DS18B20_Start(sensor) == 0)
+	{
+		result = 1; // No presence pulse
+	}
+	else if (ROM_code == 0ULL)
+	{
+		DS18B20_writeData(sensor, SKIP_ROM); // Address all the sensors of the bus
+	}
+	else
+	{
+		DS18B20_writeData(sensor, MATCH_ROM); // Match ROM
+
+		for (uint8_t i = 0; i < 8; i++)
+		{ // Send the ROM Code MSB first
+			DS18B20_writeData(sensor, (ROM_code >> 8*(7-i)) & 0xFF);
 		}
+	}
+
+	return result;	// returns 0 if OK, 1 otherwise
+}
+
+/* Start a temperature conversion on one sensor, or on all of them if ROM_code is 0 */
+uint8_t DS18B20_StartConversion(DS18B20_t *sensor, uint64_t ROM_code)
+{
+	uint8_t result = DS18B20_Select(sensor, ROM_code);
+
+	if (result == 0)
+	{
+		DS18B20_writeData(sensor, CONVERT_T); // Temperature conversion
+
+		// Parasite-powered sensors need the strong pull-up within 10µs
+		if (sensor->parasite)
+		{
+			DS18B20_StrongPullup(sensor, true);
+		}
+	}
+
+	return result;	// returns 0 if OK, 1 otherwise
+}
+
+/* Enable or disable the strong pull-up of the bus */
+void DS18B20_StrongPullup(DS18B20_t *sensor, bool enable)
+{
+	if (sensor->pullup_port != NULL)
+	{
+		// External MOSFET between the bus and VDD
+		GPIO_PinState state = (enable != sensor->pullup_active_low) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+		HAL_GPIO_WritePin(sensor->pullup_port, sensor->pullup_pin, state);
+	}
+	else if (enable)
+	{
+		// The pin is released (output register high): switch it from open-drain to push-pull.
+		// The output type register is written directly, HAL_GPIO_Init is too slow for the 10µs.
+		sensor->gpio_port->OTYPER &= ~((uint32_t)sensor->gpio_pin);
+	}
+	else
+	{
+		sensor->gpio_port->OTYPER |= (uint32_t)sensor->gpio_pin; // Back to open-drain
+	}
+
+	sensor->pullup_on = enable;
+}
+
+/* Check whether at least one sensor of the bus is parasite-powered */
+bool DS18B20_ReadPowerSupply(DS18B20_t *sensor)
+{
+	bool result = false;
 
+	if (DS18B20_Select(sensor, 0ULL) == 0)
+	{
+		DS18B20_writeData(sensor, READ_PWR_SUPPLY);
+
+		// Parasite-powered sensors pull the bus low during the read time slot
+		if (DS18B20_read(sensor) == 0)
+		{
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+/* Wait for the end of the conversion started by DS18B20_StartConversion */
+//!\ Without a conversion_wait hook, the bus is polled: the sensors hold the bus low during
+//!\ read time slots as long as they are converting. This only works with externally
+//!\ powered sensors: with parasite-powered ones, the whole timeout is waited under the
+//!\ strong pull-up. With a hook, the whole timeout is given to the hook, and the MCU
+//!\ can sleep instead of polling.
+uint8_t DS18B20_WaitConversion(DS18B20_t *sensor, uint32_t timeout_ms)
+{
+	uint8_t result = 1;
+	uint32_t start = HAL_GetTick();
+
+	if (sensor->conversion_wait != NULL)
+	{
+		sensor->conversion_wait(sensor->wait_context, timeout_ms);
+
+		// The clocks may have been changed or stopped during the wait (Stop mode)
+		if (DS18B20_Timer_Init(sensor) == OK)
+		{
+			result = 0;
+		}
+	}
+	else if (sensor->parasite)
+	{
+		// The bus is held high by the strong pull-up: wait for the whole conversion time
+		while ((HAL_GetTick() - start) <= timeout_ms)
+		{
+		}
+
+		result = 0;
+	}
+	else
+	{
+		while ((result != 0) && ((HAL_GetTick() - start) <= timeout_ms))
+		{
+			if (DS18B20_read(sensor) != 0)
+			{
+				result = 0; // Conversion complete
+			}
+		}
+	}
+
+	// End of the strong pull-up of parasite-powered sensors
+	if (sensor->pullup_on)
+	{
+		DS18B20_StrongPullup(sensor, false);
+	}
+
+	uint32_t elapsed = HAL_GetTick() - start;
+	DS18B20_STATS_ADD(sensor->stats, conversions, 1U);
+	DS18B20_STATS_ADD(sensor->stats, conversion_wait_ms, elapsed);
+	if (sensor->conversion_wait == NULL)
+	{
+		DS18B20_STATS_ADD(sensor->stats, busy_wait_ms, elapsed);
+	}
+
+	return result;	// returns 0 if OK, 1 on timeout
+}
+
+/* Read and check the 9 bytes of the scratchpad of one sensor */
+uint8_t DS18B20_ReadScratchpad(DS18B20_t *sensor, uint64_t ROM_code, uint8_t scratchpad[])
+{
+	uint8_t result = DS18B20_SAMPLE_OK;
+	uint32_t start = __HAL_TIM_GET_COUNTER(&sensor->htim);
+
+	if (DS18B20_Select(sensor, ROM_code) != 0)
+	{
+		result = DS18B20_SAMPLE_NO_PRESENCE;
+	}
+	else
+	{
 		DS18B20_writeData(sensor, READ_SCRATCHPAD); // Read data
 
-		uint8_t Temperature_byte_1 = DS18B20_readByte(sensor); // First byte of data
-		uint8_t Temperature_byte_2 = DS18B20_readByte(sensor); // Second byte of data
+		for (uint8_t i = 0; i < DS18B20_SCRATCHPAD_SIZE; i++)
+		{
+			scratchpad[i] = DS18B20_readByte(sensor);
+		}
 
-		// Temperature data is made of the concatenation of the two data bytes.
-		// The sensor sends the data LSB first.
-		// For DS18S20+, the point is after the Bit 1,
-		// we therefore have to divide the 16-bit result by 2^1 = 2.
-		uint16_t Temperature = (((Temperature_byte_2 << 8)) | Temperature_byte_1) >> 4;
-		temperature[count] = Temperature;
+		// The last byte is the CRC of the 8 others
+		DS18B20_TRACE_START(sensor);
+		if (crcCompute(scratchpad, DS18B20_SCRATCHPAD_SIZE - 1U) != scratchpad[DS18B20_SCRATCHPAD_SIZE - 1U])
+		{
+			result = DS18B20_SAMPLE_CRC_ERROR;
+		}
+		DS18B20_TRACE_EVENT(sensor, DS18B20_TRACE_CRC, DS18B20_TRACE_CRC_SCRATCHPAD | (result != DS18B20_SAMPLE_OK));
 
-		count += 1; // Increment the sensor count
+		if (result == DS18B20_SAMPLE_CRC_ERROR)
+		{
+			DS18B20_STATS_ADD(sensor->stats, crc_errors, 1U);
+		}
+	}
 
-		// Display the temperature of the sensor through Serial
-		log_ds18b20("Temperature of sensor %i: %d\n\r", count, Temperature);
+	// From the reset to the CRC check, preemptions included
+	DS18B20_STATS_HISTOGRAM(sensor->stats, transaction_us,
+	                        (__HAL_TIM_GET_COUNTER(&sensor->htim) - start) & __HAL_TIM_GET_AUTORELOAD(&sensor->htim));
+
+	return result;	// returns a DS18B20_SampleStatus_t
+}
+
+/* Read the scratchpad of one sensor and decode its temperature */
+uint8_t DS18B20_ReadTemperature(DS18B20_t *sensor, uint64_t ROM_code, int16_t *value)
+{
+	uint8_t scratchpad[DS18B20_SCRATCHPAD_SIZE] = {0};
+	uint8_t result = DS18B20_ReadScratchpad(sensor, ROM_code, scratchpad);
+
+	if (result == DS18B20_SAMPLE_OK)
+	{
+		result = DS18B20_Decode(ROM_code, scratchpad, value);
 	}
 
-	return 0; // OK
+	return result;	// returns a DS18B20_SampleStatus_t
+}
+
+/* Read the temperature and the slot ID of one sensor into a sample */
+//!\ Nothing is read if the sample already has an error status, e.g. from its conversion.
+//!\ A suspect value (see DS18B20_Suspect) is converted and read again on this sensor only,
+//!\ up to DS18B20_SANITY_RETRIES times, and the sample is DS18B20_SAMPLE_INVALID if it
+//!\ remains suspect. A retry keeps the bus for a whole conversion time, and the sample then
+//!\ takes the timestamp of the end of the new conversion.
+//!\ 85°C read again from a new conversion is a real temperature, not the power-on value:
+//!\ only the rate check applies to it.
+void DS18B20_ReadSample(DS18B20_t *sensor, uint64_t ROM_code, DS18B20_Sample_t *sample)
+{
+	uint8_t scratchpad[DS18B20_SCRATCHPAD_SIZE] = {0};
+	uint8_t read = sample->status;
+	DS18B20_Channel_t *channel = DS18B20_Channel(sensor, sample->slot);
+
+	if (sample->status == DS18B20_SAMPLE_OK)
+	{
+		read = DS18B20_ReadScratchpad(sensor, ROM_code, scratchpad);
+		sample->status = (read == DS18B20_SAMPLE_OK) ? DS18B20_Decode(ROM_code, scratchpad, &sample->value) : read;
+
+		int16_t first = sample->value;
+		bool first_valid = (sample->status == DS18B20_SAMPLE_OK);
+		bool confirmed = false;		// Same value read after a new conversion
+
+		for (uint8_t retry = 0; (retry < DS18B20_SANITY_RETRIES) && (DS18B20_Suspect(ROM_code, scratchpad, sample, channel));
+		     retry++)
+		{
+			DS18B20_STATS_ADD(sensor->stats, retries, 1U);
+
+			if (DS18B20_StartConversion(sensor, ROM_code) != 0)
+			{
+				read = DS18B20_SAMPLE_NO_PRESENCE;
+			}
+			else if (DS18B20_WaitConversion(sensor, DS18B20_ConversionTime(sensor)) != 0)
+			{
+				read = DS18B20_SAMPLE_TIMEOUT;
+			}
+			else
+			{
+				// The value is now the one of this conversion, for the rate check too
+				sample->timestamp = HAL_GetTick();
+				read = DS18B20_ReadScratchpad(sensor, ROM_code, scratchpad);
+			}
+
+			sample->status = (read == DS18B20_SAMPLE_OK) ? DS18B20_Decode(ROM_code, scratchpad, &sample->value) : read;
+			confirmed = (first_valid) && (read == DS18B20_SAMPLE_OK) && (sample->status == DS18B20_SAMPLE_OK)
+						&& (sample->value == first);
+		}
+
+		bool suspect = DS18B20_Suspect(ROM_code, scratchpad, sample, channel);
+
+		if ((suspect) && (confirmed) && (sample->value == DS18B20_POWER_ON_VALUE))
+		{
+			suspect = DS18B20_TooFast(sample, channel);
+		}
+
+		if (suspect)
+		{
+			// A step confirmed by a new conversion is real: only this sample is lost
+			if ((channel != NULL) && (sample->status == DS18B20_SAMPLE_OK)
+				&& ((sample->value != DS18B20_POWER_ON_VALUE) || (confirmed)))
+			{
+				channel->accepted = sample->value;
+				channel->accepted_at = sample->timestamp;
+			}
+
+			sample->status = DS18B20_SAMPLE_INVALID;
+		}
+		else if ((channel != NULL) && (sample->status == DS18B20_SAMPLE_OK))
+		{
+			channel->accepted = sample->value;
+			channel->accepted_at = sample->timestamp;
+			channel->accepted_valid = true;
+		}
+	}
+
+	if (read == DS18B20_SAMPLE_OK)
+	{
+		sample->id = DS18B20_SlotID(ROM_code, scratchpad);
+		DS18B20_Shadow(channel, ROM_code, scratchpad);
+	}
+
+	log_ds18b20(DS18B20_LOG_SAMPLE, sample->slot, sample->value);
+}
+
+/* Update the shadow of the TH, TL and configuration registers of a channel from a scratchpad */
+void DS18B20_Shadow(DS18B20_Channel_t *channel, uint64_t ROM_code, const uint8_t scratchpad[])
+{
+	// A MAX31850 has no such registers
+	if ((channel != NULL) && ((uint8_t)(ROM_code >> 56) != DS18B20_FAMILY_MAX31850))
+	{
+		channel->th = scratchpad[2];
+		channel->tl = scratchpad[3];
+		channel->config = scratchpad[4];
+		channel->shadow_valid = true;
+	}
+}
+
+/* Tell if the shadow of a channel is valid and holds these registers */
+bool DS18B20_ShadowMatches(const DS18B20_Channel_t *channel, uint64_t ROM_code, uint8_t th, uint8_t tl,
+                           uint8_t config)
+{
+	// Byte 4 of a DS18S20 is reserved (0xFF), its resolution is fixed
+	bool config_matches = ((uint8_t)(ROM_code >> 56) == DS18B20_FAMILY_DS18S20) || (channel->config == config);
+
+	return (channel->shadow_valid) && (channel->th == th) && (channel->tl == tl) && (config_matches);
+}
+
+/* Tell if a sample has the signature of a failure rather than a real temperature */
+//!\ - 85°C, the power-on value of the register: the sensor browned out, or was read without
+//!\   a conversion. It is only plausible close to the last accepted value of the channel.
+//!\ - A scratchpad of 0xFF only, read from a sensor that left the bus (its CRC fails).
+//!\ - A change from the last accepted value faster than the max_rate of the channel.
+bool DS18B20_Suspect(uint64_t ROM_code, const uint8_t scratchpad[], const DS18B20_Sample_t *sample,
+                     const DS18B20_Channel_t *channel)
+{
+	bool result = false;
+	bool known = (channel != NULL) && (channel->accepted_valid);
+	int32_t change = (known) ? ((int32_t)sample->value - channel->accepted) : 0;
+
+	change = (change < 0) ? -change : change;
+
+	if ((sample->status == DS18B20_SAMPLE_OK) || (sample->status == DS18B20_SAMPLE_CRC_ERROR))
+	{
+		result = true;
+
+		for (uint8_t i = 0; (i < (DS18B20_SCRATCHPAD_SIZE - 1U)) && (result); i++)
+		{
+			result = (scratchpad[i] == 0xFFU);
+		}
+	}
+
+	if (sample->status != DS18B20_SAMPLE_OK)
+	{
+		// Other failures are reported as they are
+	}
+	else if ((sample->value == DS18B20_POWER_ON_VALUE) && ((uint8_t)(ROM_code >> 56) != DS18B20_FAMILY_MAX31850)
+		&& ((known == false) || (change > DS18B20_POWER_ON_MARGIN)))
+	{
+		result = true;
+	}
+	else if (DS18B20_TooFast(sample, channel))
+	{
+		result = true;
+	}
+
+	return result;
+}
+
+/* Tell if a value changed from the last accepted one of its channel faster than its max_rate */
+bool DS18B20_TooFast(const DS18B20_Sample_t *sample, const DS18B20_Channel_t *channel)
+{
+	bool result = false;
+
+	if ((channel != NULL) && (channel->accepted_valid) && (channel->max_rate != 0U))
+	{
+		// At least one second of change is allowed, for the samples closer than that
+		int32_t change = (int32_t)sample->value - channel->accepted;
+		uint32_t elapsed = sample->timestamp - channel->accepted_at;
+		uint64_t allowed = ((uint64_t)channel->max_rate * ((elapsed < 1000U) ? 1000U : elapsed)) / 1000U;
+
+		change = (change < 0) ? -change : change;
+		result = ((uint64_t)change > allowed);
+	}
+
+	return result;
+}
+
+/* Get the slot ID stored in a scratchpad by DS18B20_WriteSlotID */
+//!\ A MAX31850 has no user byte: its ID is given by its AD3..AD0 address pins instead.
+uint16_t DS18B20_SlotID(uint64_t ROM_code, const uint8_t scratchpad[])
+{
+	uint16_t result = 0;
+
+	if ((uint8_t)(ROM_code >> 56) == DS18B20_FAMILY_MAX31850)
+	{
+		result = scratchpad[4] & 0x0FU;
+	}
+	else
+	{
+		result = (uint16_t)((scratchpad[2] << 8) | scratchpad[3]); // TH, TL
+	}
+
+	return result;
+}
+
+/* Write a slot ID into the TH and TL EEPROM bytes of one sensor */
+//!\ The configuration register is read first and written back unchanged, and nothing is
+//!\ written if the sensor already has this ID. The ID replaces the alarm thresholds, so
+//!\ ALARM_SEARCH shall not be used on a bus with IDs.
+uint8_t DS18B20_WriteSlotID(DS18B20_t *sensor, uint64_t ROM_code, uint16_t id)
+{
+	uint8_t scratchpad[DS18B20_SCRATCHPAD_SIZE] = {0};
+	uint8_t result = DS18B20_SAMPLE_OK;
+
+	if ((ROM_code == 0ULL) || ((uint8_t)(ROM_code >> 56) == DS18B20_FAMILY_MAX31850))
+	{
+		result = DS18B20_SAMPLE_INVALID; // One sensor at a time, with user bytes
+	}
+	else
+	{
+		result = DS18B20_ReadScratchpad(sensor, ROM_code, scratchpad);
+	}
+
+	if ((result == DS18B20_SAMPLE_OK) && (DS18B20_SlotID(ROM_code, scratchpad) != id))
+	{
+		if ((DS18B20_WriteScratchpad(sensor, ROM_code, (uint8_t)(id >> 8), (uint8_t)id, scratchpad[4]) != 0)
+			|| (DS18B20_CopyScratchpad(sensor, ROM_code) != 0))
+		{
+			result = DS18B20_SAMPLE_NO_PRESENCE;
+		}
+	}
+
+	return result;	// returns a DS18B20_SampleStatus_t
+}
+
+/* Decode the temperature of a scratchpad according to the family of the sensor */
+//!\ All the families give a temperature in Q12.4 format, so a bus mixing them can be
+//!\ converted with a single broadcast and read in the same sweep.
+uint8_t DS18B20_Decode(uint64_t ROM_code, const uint8_t scratchpad[], int16_t *value)
+{
+	uint8_t result = DS18B20_SAMPLE_OK;
+	int16_t raw = (int16_t)((scratchpad[1] << 8) | scratchpad[0]);
+
+	switch ((uint8_t)(ROM_code >> 56))
+	{
+	case DS18B20_FAMILY_DS18S20:
+	{
+		// 9-bit value in 0.5°C steps, extended with COUNT_REMAIN (byte 6) and COUNT_PER_C (byte 7)
+		int32_t count_remain = scratchpad[6];
+		int32_t count_per_c = scratchpad[7];
+
+		if (count_per_c == 0)
+		{
+			result = DS18B20_SAMPLE_INVALID;
+		}
+		else
+		{
+			*value = (int16_t)(((int32_t)(raw & ~1) * 8) - 4 + (((count_per_c - count_remain) * 16) / count_per_c));
+		}
+		break;
+	}
+
+	case DS18B20_FAMILY_MAX31850:
+	{
+		DS18B20_Thermocouple_t thermocouple;
+
+		if (DS18B20_DecodeMAX31850(scratchpad, &thermocouple) != 0)
+		{
+			result = DS18B20_SAMPLE_FAULT;
+		}
+		*value = thermocouple.temperature;
+		break;
+	}
+
+	default:
+	{
+		// DS18B20 and DS1822: the low bits are undefined below 12-bit resolution
+		uint8_t undefined_bits = 3U - ((scratchpad[4] >> 5) & 0x03U);
+
+		*value = (int16_t)(raw & ~((1 << undefined_bits) - 1));
+		break;
+	}
+	}
+
+	return result;	// returns a DS18B20_SampleStatus_t
+}
+
+/* Decode the thermocouple and cold-junction temperatures of a MAX31850 scratchpad */
+uint8_t DS18B20_DecodeMAX31850(const uint8_t scratchpad[], DS18B20_Thermocouple_t *thermocouple)
+{
+	// Thermocouple in bits 15..2 of bytes 1-0 (0.25°C), fault flag in bit 0
+	thermocouple->temperature = (int16_t)(((scratchpad[1] << 8) | scratchpad[0]) & 0xFFFC);
+
+	// Cold junction in bits 15..4 of bytes 3-2 (0.0625°C), fault details in bits 2..0
+	thermocouple->cold_junction = (int16_t)((scratchpad[3] << 8) | scratchpad[2]) >> 4;
+	thermocouple->faults = scratchpad[2] & DS18B20_MAX31850_FAULTS;
+
+	if ((scratchpad[0] & 0x01U) == 0)
+	{
+		thermocouple->faults = 0; // Fault details are only meaningful with the fault flag
+	}
+	else if (thermocouple->faults == 0)
+	{
+		thermocouple->faults = DS18B20_MAX31850_FAULTS; // Fault flag without details
+	}
+
+	return (thermocouple->faults == 0) ? 0 : 1;	// returns 0 if OK, 1 on a thermocouple fault
+}
+
+/* Write the alarm registers and the configuration register of one sensor, or of all of them if ROM_code is 0 */
+//!\ The values are only written to the scratchpad, they are lost at power-off unless
+//!\ a COPY_SCRATCHPAD command is sent afterwards.
+uint8_t DS18B20_WriteScratchpad(DS18B20_t *sensor, uint64_t ROM_code, uint8_t th, uint8_t tl, uint8_t config)
+{
+	// The slot of the ROM code is unknown here: the shadows are read again before being trusted
+	for (uint16_t slot = 0; slot < sensor->channel_count; slot++)
+	{
+		sensor->channels[slot].shadow_valid = false;
+	}
+
+	return DS18B20_WriteRegisters(sensor, ROM_code, th, tl, config);	// returns 0 if OK, 1 otherwise
+}
+
+/* Write TH, TL and configuration registers, without touching the shadows */
+//!\ A DS18S20 only takes TH and TL. A broadcast sends the configuration register as well,
+//!\ which the DS18S20 of the bus ignore.
+uint8_t DS18B20_WriteRegisters(DS18B20_t *sensor, uint64_t ROM_code, uint8_t th, uint8_t tl, uint8_t config)
+{
+	uint8_t result = DS18B20_Select(sensor, ROM_code);
+
+	if (result == 0)
+	{
+		DS18B20_writeData(sensor, WRITE_SCRATCHPAD);
+		DS18B20_writeData(sensor, th);		// TH register (byte 2)
+		DS18B20_writeData(sensor, tl);		// TL register (byte 3)
+
+		if ((uint8_t)(ROM_code >> 56) != DS18B20_FAMILY_DS18S20)
+		{
+			DS18B20_writeData(sensor, config);	// Configuration register (byte 4)
+		}
+	}
+
+	return result;	// returns 0 if OK, 1 otherwise
+}
+
+/* Copy the alarm and configuration registers of one sensor, or of all of them, to EEPROM */
+uint8_t DS18B20_CopyScratchpad(DS18B20_t *sensor, uint64_t ROM_code)
+{
+	uint8_t result = DS18B20_Select(sensor, ROM_code);
+	uint32_t start = HAL_GetTick();
+
+	if (result == 0)
+	{
+		DS18B20_writeData(sensor, COPY_SCRATCHPAD);
+
+		if (sensor->parasite)
+		{
+			// Parasite-powered sensors need the strong pull-up within 10µs, for 10ms
+			DS18B20_StrongPullup(sensor, true);
+
+			while ((HAL_GetTick() - start) <= DS18B20_COPY_TIME_MS)
+			{
+			}
+
+			DS18B20_StrongPullup(sensor, false);
+		}
+		else
+		{
+			// Externally powered sensors answer 1 once the copy is done
+			result = 1;
+
+			while ((result != 0) && ((HAL_GetTick() - start) <= DS18B20_COPY_TIME_MS))
+			{
+				if (DS18B20_read(sensor) != 0)
+				{
+					result = 0;
+				}
+			}
+		}
+
+		DS18B20_STATS_ADD(sensor->stats, busy_wait_ms, HAL_GetTick() - start);
+	}
+
+	return result;	// returns 0 if OK, 1 otherwise
+}
+
+/* Maximum conversion time for the resolution of the bus, in ms */
+uint32_t DS18B20_ConversionTime(const DS18B20_t *sensor)
+{
+	return DS18B20_ResolutionTime(sensor->resolution);
+}
+
+/* Maximum conversion time for a resolution in bits, in ms */
+uint32_t DS18B20_ResolutionTime(uint8_t resolution)
+{
+	uint32_t result = DS18B20_CONVERSION_TIMEOUT_MS;
+
+	// Conversion time is halved for each bit of resolution removed:
+	// 93.75 ms at 9 bits, 187.5 ms at 10 bits, 375 ms at 11 bits, 750 ms at 12 bits
+	if ((resolution >= 9U) && (resolution < 12U))
+	{
+		result = (DS18B20_CONVERSION_TIMEOUT_MS >> (12U - resolution)) + 1U;
+	}
+
+	return result;
+}
+
+/* Number of sensors that may convert at the same time on the bus */
+//!\ Each parasite-powered sensor draws up to 1.5mA from the strong pull-up while converting.
+//!\ Externally powered sensors do not take their current from the bus.
+uint16_t DS18B20_GroupSize(const DS18B20_t *sensor)
+{
+	uint16_t result = UINT16_MAX;
+
+	if ((sensor->parasite) && (sensor->pullup_current_ua != 0U))
+	{
+		uint32_t group_size = sensor->pullup_current_ua / DS18B20_CONVERSION_CURRENT_UA;
+
+		result = (group_size == 0U) ? 1U : ((group_size > UINT16_MAX) ? UINT16_MAX : (uint16_t)group_size);
+	}
+
+	return result;
+}
+
+/* Tell if the sensors of an array shall be converted one at a time, see DS18B20_GroupSize */
+bool DS18B20_Staggered(const DS18B20_t *sensor, const uint64_t ROM_codes_array[])
+{
+	uint16_t count = 0;
+
+	for (uint16_t slot = 0; ROM_codes_array[slot] != 0; slot++)
+	{
+		if (ROM_codes_array[slot] != DS18B20_FREE_SLOT)
+		{
+			count++; // Nothing converts in a free slot
+		}
+	}
+
+	return (DS18B20_GroupSize(sensor) < count);
+}
+
+
+/* Convert all the sensors of the bus and deliver one sample per sensor */
+//!\ Unlike DS18B20_GetTemp, a single broadcast conversion is done for the whole bus,
+//!\ and the temperatures are kept in Q12.4 format (signed, 1 LSB = 1/16 °C).
+//!\ If the bus is parasite-powered and the strong pull-up cannot supply all the sensors
+//!\ at once (see pullup_current_ua), the conversions are staggered. The 1-Wire commands can
+//!\ only address one sensor or all of them, and the bus cannot be used while parasite-powered
+//!\ sensors convert: the sensors are then converted one at a time, each one being read out
+//!\ right before the conversion of the next one starts.
+error_t DS18B20_Sweep(DS18B20_t *sensor, const uint64_t ROM_codes_array[],
+                      DS18B20_Deliver_t deliver, void *context)
+{
+	error_t result = OK;
+	uint16_t count = 0;
+	uint32_t start = HAL_GetTick();
+
+	if ((ROM_codes_array == NULL) || (deliver == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		while (ROM_codes_array[count] != 0)
+		{
+			count++;
+		}
+	}
+
+	if ((result == OK) && (DS18B20_Staggered(sensor, ROM_codes_array) == false))
+	{
+		uint8_t conversion_status = DS18B20_SAMPLE_OK;
+
+		if (DS18B20_StartConversion(sensor, 0ULL) != 0)
+		{
+			conversion_status = DS18B20_SAMPLE_NO_PRESENCE;
+		}
+		else if (DS18B20_WaitConversion(sensor, DS18B20_ConversionTime(sensor)) != 0)
+		{
+			conversion_status = DS18B20_SAMPLE_TIMEOUT;
+		}
+
+		// All the sensors were sampled at the end of the same conversion
+		uint32_t timestamp = HAL_GetTick();
+
+		for (uint16_t slot = 0; slot < count; slot++)
+		{
+			DS18B20_Sample_t sample = {0};
+			sample.timestamp = timestamp;
+			sample.slot = slot;
+			sample.status = conversion_status;
+
+			if (ROM_codes_array[slot] != DS18B20_FREE_SLOT)
+			{
+				DS18B20_ReadSample(sensor, ROM_codes_array[slot], &sample);
+				deliver(context, &sample);
+			}
+		}
+	}
+	else if (result == OK)
+	{
+		for (uint16_t slot = 0; slot < count; slot++)
+		{
+			DS18B20_Sample_t sample = {0};
+			sample.slot = slot;
+
+			if (ROM_codes_array[slot] == DS18B20_FREE_SLOT)
+			{
+				// Nothing to convert in a free slot
+			}
+			else if (DS18B20_StartConversion(sensor, ROM_codes_array[slot]) != 0)
+			{
+				sample.status = DS18B20_SAMPLE_NO_PRESENCE;
+			}
+			else if (DS18B20_WaitConversion(sensor, DS18B20_ConversionTime(sensor)) != 0)
+			{
+				sample.status = DS18B20_SAMPLE_TIMEOUT;
+			}
+
+			sample.timestamp = HAL_GetTick();
+
+			if (ROM_codes_array[slot] != DS18B20_FREE_SLOT)
+			{
+				DS18B20_ReadSample(sensor, ROM_codes_array[slot], &sample);
+				deliver(context, &sample);
+			}
+		}
+	}
+
+	if (result == OK)
+	{
+		DS18B20_STATS_HISTOGRAM(sensor->stats, sweep_ms, HAL_GetTick() - start);
+	}
+
+	return result;
+}
+
+/* Push a sample into the ring given as context */
+void DS18B20_DeliverToRing(void *context, const DS18B20_Sample_t *sample)
+{
+	(void)DS18B20_Ring_Push((DS18B20_Ring_t *)context, sample);
+}
+
+/* Convert all the sensors and push one sample per sensor into the ring */
+error_t DS18B20_Acquire(DS18B20_t *sensor, const uint64_t ROM_codes_array[], DS18B20_Ring_t *ring)
+{
+	error_t result = OK;
+
+	if (ring == NULL)
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		uint32_t overruns = ring->overruns;
+
+		result = DS18B20_Sweep(sensor, ROM_codes_array, DS18B20_DeliverToRing, ring);
+
+		if ((result == OK) && (ring->overruns != overruns))
+		{
+			result = ERROR_OTHER; // Ring full, the application does not pop fast enough
+		}
+	}
+
+	return result;
 }
 
 /********************************** END OF FILE ******************************************** */
@@ -0,0 +1,152 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_cache.c                                                                           */
+/*                                                                                           */
+/* Per-sensor result cache with a maximum age, shared by all the readers of a bus            */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_cache.h"
+
+//!\ A conversion takes as long for one sensor as for the whole bus, so a stale entry is
+//!\ never refreshed alone: the whole bus is converted at once and every entry is updated.
+//!\ The requests for the other sensors that follow within max_age_ms are then served
+//!\ from RAM, without touching the bus.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static void DS18B20_Cache_Deliver(void *context, const DS18B20_Sample_t *sample);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Initialize the cache of a bus, all the entries are stale */
+error_t DS18B20_Cache_Init(DS18B20_Cache_t *cache, DS18B20_t *sensor, const uint64_t ROM_codes_array[],
+                           DS18B20_CacheEntry_t entries[], uint32_t max_age_ms)
+{
+	error_t result = OK;
+
+	if ((cache == NULL) || (sensor == NULL) || (ROM_codes_array == NULL) || (entries == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		cache->sensor = sensor;
+		cache->ROM_codes_array = ROM_codes_array;
+		cache->entries = entries;
+		cache->max_age_ms = max_age_ms;
+		cache->hits = 0;
+		cache->sweeps = 0;
+
+		for (cache->entry_count = 0; ROM_codes_array[cache->entry_count] != 0; cache->entry_count++)
+		{
+			entries[cache->entry_count].valid = false;
+		}
+	}
+
+	return result;
+}
+
+/* Get the cached result of a sensor if it is recent enough */
+//!\ The hit is not counted here: a reader may look up several sensors and still convert
+//!\ the bus, so it counts the read in hits once it is served from the cache.
+bool DS18B20_Cache_Lookup(DS18B20_Cache_t *cache, uint16_t slot, int16_t *value, uint8_t *status)
+{
+	bool result = false;
+
+	if (slot >= cache->entry_count)
+	{
+		// Not in the ROM codes array
+	}
+	else if ((cache->entries[slot].valid) && ((HAL_GetTick() - cache->entries[slot].timestamp) <= cache->max_age_ms))
+	{
+		*value = cache->entries[slot].value;
+		if (status != NULL)
+		{
+			*status = cache->entries[slot].status;
+		}
+
+		result = true;
+	}
+
+	return result;	// returns true on a cache hit
+}
+
+/* Update the entry of a sensor with a new sample */
+void DS18B20_Cache_Store(DS18B20_Cache_t *cache, const DS18B20_Sample_t *sample)
+{
+	if (sample->slot < cache->entry_count)
+	{
+		DS18B20_CacheEntry_t *entry = &cache->entries[sample->slot];
+
+		entry->timestamp = sample->timestamp;
+		entry->value = sample->value;
+		entry->status = sample->status;
+		entry->valid = true;
+	}
+}
+
+/* Store a sample of a sweep into the cache given as context */
+void DS18B20_Cache_Deliver(void *context, const DS18B20_Sample_t *sample)
+{
+	DS18B20_Cache_Store((DS18B20_Cache_t *)context, sample);
+}
+
+/* Convert the whole bus once and update every entry */
+uint8_t DS18B20_Cache_Refresh(DS18B20_Cache_t *cache)
+{
+	uint8_t result = DS18B20_SAMPLE_OK;
+
+	if (DS18B20_Sweep(cache->sensor, cache->ROM_codes_array, DS18B20_Cache_Deliver, cache) != OK)
+	{
+		result = DS18B20_SAMPLE_INVALID;
+	}
+
+	cache->sweeps++;
+
+	return result;	// returns a DS18B20_SampleStatus_t
+}
+
+/* Get the temperature of a sensor, from the cache or from a new sweep of the bus */
+//!\ A slot out of the ROM codes array, a free slot, or a sensor the sweep did not read,
+//!\ gives DS18B20_SAMPLE_NO_PRESENCE.
+uint8_t DS18B20_Cache_Get(DS18B20_Cache_t *cache, uint16_t slot, int16_t *value)
+{
+	uint8_t result = DS18B20_SAMPLE_OK;
+
+	if ((slot >= cache->entry_count) || (cache->ROM_codes_array[slot] == DS18B20_FREE_SLOT))
+	{
+		result = DS18B20_SAMPLE_NO_PRESENCE; // No sensor to convert
+	}
+	else if (DS18B20_Cache_Lookup(cache, slot, value, &result))
+	{
+		cache->hits++;
+	}
+	else
+	{
+		result = DS18B20_Cache_Refresh(cache);
+
+		// The status of the sensor itself is the one of its new entry
+		if (result != DS18B20_SAMPLE_OK)
+		{
+			// Sweep failed
+		}
+		else if (cache->entries[slot].valid == false)
+		{
+			result = DS18B20_SAMPLE_NO_PRESENCE;
+		}
+		else
+		{
+			*value = cache->entries[slot].value;
+			result = cache->entries[slot].status;
+		}
+	}
+
+	return result;	// returns a DS18B20_SampleStatus_t
+}
+
+/********************************** END OF FILE ******************************************** */
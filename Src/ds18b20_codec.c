@@ -0,0 +1,284 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_codec.c                                                                           */
+/*                                                                                           */
+/* Compact encoding of DS18B20 samples: per-sensor deltas, zigzag varints and keyframes      */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_codec.h"
+
+//!\ The temperatures change by a few LSBs between two sweeps, and the samples of a sweep
+//!\ share their timestamp: a sample takes 1 byte most of the time instead of 6, and the
+//!\ encoding is a few shifts and compares per byte. With DS18B20_CODEC_PROFILE, the cycle
+//!\ counter of the core measures it (the DWT shall be enabled by the application).
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static void DS18B20_Codec_Reset(DS18B20_Codec_t *codec);
+static uint8_t DS18B20_Codec_PutVarint(uint8_t data[], uint32_t value);
+static uint8_t DS18B20_Codec_GetVarint(const uint8_t data[], uint32_t length, uint32_t *value);
+static uint32_t DS18B20_Codec_Zigzag(int32_t value);
+static int32_t DS18B20_Codec_Unzigzag(uint32_t value);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Initialize an encoder or a decoder, the first sample encoded is a keyframe */
+error_t DS18B20_Codec_Init(DS18B20_Codec_t *codec, int16_t references[], uint16_t capacity, uint16_t key_interval)
+{
+	error_t result = OK;
+
+	if ((codec == NULL) || ((capacity != 0U) && (references == NULL)))
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		codec->references = references;
+		codec->capacity = capacity;
+		codec->key_interval = (key_interval == 0U) ? DS18B20_CODEC_KEY_INTERVAL : key_interval;
+		codec->samples = 0;
+		codec->bytes = 0;
+		codec->keyframes = 0;
+		codec->cycles = 0;
+
+		DS18B20_Codec_Reset(codec);
+		codec->since_key = codec->key_interval;
+	}
+
+	return result;
+}
+
+/* Make the next sample a keyframe, e.g. at the start of a storage page */
+void DS18B20_Codec_Key(DS18B20_Codec_t *codec)
+{
+	codec->since_key = codec->key_interval;
+}
+
+/* Encode a sample, data shall hold DS18B20_CODEC_MAX_SIZE bytes */
+uint8_t DS18B20_Codec_Encode(DS18B20_Codec_t *codec, const DS18B20_Sample_t *sample, uint8_t data[])
+{
+#ifdef DS18B20_CODEC_PROFILE
+	uint32_t start = DWT->CYCCNT;
+#endif
+	uint8_t length = 0;
+	uint8_t flags = (uint8_t)((sample->status & DS18B20_CODEC_STATUS_MASK) << DS18B20_CODEC_STATUS_SHIFT);
+
+	if (codec->since_key >= codec->key_interval)
+	{
+		DS18B20_Codec_Reset(codec);
+		codec->since_key = 0;
+		codec->keyframes++;
+		flags |= DS18B20_CODEC_KEY;
+	}
+	else if (sample->timestamp != codec->timestamp)
+	{
+		flags |= DS18B20_CODEC_TIME;
+	}
+
+	if (sample->slot != (uint16_t)(codec->slot + 1U))
+	{
+		flags |= DS18B20_CODEC_SLOT;
+	}
+
+	int16_t *reference = (sample->slot < codec->capacity) ? &codec->references[sample->slot] : NULL;
+	int32_t delta = (int32_t)sample->value - ((reference != NULL) ? *reference : 0);
+
+	if (flags == 0U)
+	{
+		// Short form: next slot, same timestamp, OK status
+		length = DS18B20_Codec_PutVarint(data, DS18B20_Codec_Zigzag(delta) << 1);
+	}
+	else
+	{
+		length = DS18B20_Codec_PutVarint(data, ((uint32_t)flags << 1) | 1U);
+
+		if (flags & DS18B20_CODEC_KEY)
+		{
+			length += DS18B20_Codec_PutVarint(&data[length], sample->timestamp);
+		}
+		if (flags & DS18B20_CODEC_TIME)
+		{
+			length += DS18B20_Codec_PutVarint(&data[length],
+			                                  DS18B20_Codec_Zigzag((int32_t)(sample->timestamp - codec->timestamp)));
+		}
+		if (flags & DS18B20_CODEC_SLOT)
+		{
+			length += DS18B20_Codec_PutVarint(&data[length], sample->slot);
+		}
+		if (sample->status == DS18B20_SAMPLE_OK)
+		{
+			length += DS18B20_Codec_PutVarint(&data[length], DS18B20_Codec_Zigzag(delta));
+		}
+	}
+
+	// The value of a failed sample is meaningless, the reference is kept
+	if ((reference != NULL) && (sample->status == DS18B20_SAMPLE_OK))
+	{
+		*reference = sample->value;
+	}
+	codec->slot = sample->slot;
+	codec->timestamp = sample->timestamp;
+	codec->since_key++;
+
+	codec->samples++;
+	codec->bytes += length;
+#ifdef DS18B20_CODEC_PROFILE
+	codec->cycles += DWT->CYCCNT - start;
+#endif
+
+	return length;	// returns the number of bytes written
+}
+
+/* Decode a sample, from a keyframe or from the sample after the previous one decoded */
+//!\ Returns the number of bytes read, 0 if the data is incomplete or not valid.
+uint8_t DS18B20_Codec_Decode(DS18B20_Codec_t *codec, const uint8_t data[], uint32_t length, DS18B20_Sample_t *sample)
+{
+	uint8_t result = 0;
+	uint32_t control = 0;
+	uint32_t field = 0;
+	uint8_t read = DS18B20_Codec_GetVarint(data, length, &control);
+	uint8_t flags = (uint8_t)(control >> 1);
+	DS18B20_Sample_t decoded = {0};
+
+	decoded.timestamp = codec->timestamp;
+	decoded.slot = (uint16_t)(codec->slot + 1U);
+	decoded.status = DS18B20_SAMPLE_OK;
+
+	if ((read != 0U) && (control & 1U))
+	{
+		decoded.status = (flags >> DS18B20_CODEC_STATUS_SHIFT) & DS18B20_CODEC_STATUS_MASK;
+
+		if ((read != 0U) && (flags & DS18B20_CODEC_KEY))
+		{
+			uint8_t size = DS18B20_Codec_GetVarint(&data[read], length - read, &field);
+			read = (size == 0U) ? 0U : (uint8_t)(read + size);
+			decoded.timestamp = field;
+
+			DS18B20_Codec_Reset(codec);
+			decoded.slot = 0;
+		}
+		if ((read != 0U) && (flags & DS18B20_CODEC_TIME))
+		{
+			uint8_t size = DS18B20_Codec_GetVarint(&data[read], length - read, &field);
+			read = (size == 0U) ? 0U : (uint8_t)(read + size);
+			decoded.timestamp += (uint32_t)DS18B20_Codec_Unzigzag(field);
+		}
+		if ((read != 0U) && (flags & DS18B20_CODEC_SLOT))
+		{
+			uint8_t size = DS18B20_Codec_GetVarint(&data[read], length - read, &field);
+			read = (size == 0U) ? 0U : (uint8_t)(read + size);
+			decoded.slot = (uint16_t)field;
+		}
+		if ((read != 0U) && (decoded.status == DS18B20_SAMPLE_OK))
+		{
+			uint8_t size = DS18B20_Codec_GetVarint(&data[read], length - read, &field);
+			read = (size == 0U) ? 0U : (uint8_t)(read + size);
+		}
+	}
+	else
+	{
+		field = control >> 1;
+	}
+
+	if (read != 0U)
+	{
+		int16_t *reference = (decoded.slot < codec->capacity) ? &codec->references[decoded.slot] : NULL;
+
+		if (decoded.status == DS18B20_SAMPLE_OK)
+		{
+			decoded.value = (int16_t)(((reference != NULL) ? *reference : 0) + DS18B20_Codec_Unzigzag(field));
+
+			if (reference != NULL)
+			{
+				*reference = decoded.value;
+			}
+		}
+
+		codec->slot = decoded.slot;
+		codec->timestamp = decoded.timestamp;
+		*sample = decoded;
+		result = read;
+	}
+
+	return result;
+}
+
+/* Compression ratio of the samples encoded so far, in percent of their raw size */
+uint32_t DS18B20_Codec_Ratio(const DS18B20_Codec_t *codec)
+{
+	uint32_t result = 0;
+
+	if (codec->samples != 0U)
+	{
+		result = (uint32_t)(((uint64_t)codec->bytes * 100U) / ((uint64_t)codec->samples * DS18B20_CODEC_RAW_SIZE));
+	}
+
+	return result;
+}
+
+/* Reset the references, as at a keyframe */
+void DS18B20_Codec_Reset(DS18B20_Codec_t *codec)
+{
+	for (uint16_t slot = 0; slot < codec->capacity; slot++)
+	{
+		codec->references[slot] = 0;
+	}
+
+	codec->slot = UINT16_MAX;	// The next slot is 0
+	codec->timestamp = 0;
+}
+
+/* Write an unsigned varint, 7 bits per byte, least significant first */
+uint8_t DS18B20_Codec_PutVarint(uint8_t data[], uint32_t value)
+{
+	uint8_t length = 0;
+
+	while (value >= 0x80U)
+	{
+		data[length++] = (uint8_t)(value | 0x80U);
+		value >>= 7;
+	}
+	data[length++] = (uint8_t)value;
+
+	return length;
+}
+
+/* Read an unsigned varint, returns its size, 0 if incomplete or longer than 32 bits */
+uint8_t DS18B20_Codec_GetVarint(const uint8_t data[], uint32_t length, uint32_t *value)
+{
+	uint8_t result = 0;
+	uint32_t decoded = 0;
+
+	for (uint8_t i = 0; (i < 5U) && (i < length) && (result == 0U); i++)
+	{
+		decoded |= (uint32_t)(data[i] & 0x7FU) << (7U * i);
+
+		if ((data[i] & 0x80U) == 0U)
+		{
+			result = (uint8_t)(i + 1U);
+		}
+	}
+
+	*value = decoded;
+
+	return result;
+}
+
+/* Map a signed value to an unsigned one, small magnitudes first: 0, -1, 1, -2... */
+uint32_t DS18B20_Codec_Zigzag(int32_t value)
+{
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+/* Inverse of DS18B20_Codec_Zigzag */
+int32_t DS18B20_Codec_Unzigzag(uint32_t value)
+{
+	return (int32_t)(value >> 1) ^ -(int32_t)(value & 1U);
+}
+
+/********************************** END OF FILE ******************************************** */
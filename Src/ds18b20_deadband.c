@@ -0,0 +1,110 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_deadband.c                                                                        */
+/*                                                                                           */
+/* Deadband, hysteresis and heartbeat per sensor, to deliver only the changed samples        */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_deadband.h"
+
+//!\ A sample is compared to the last one delivered for its slot, not to the previous
+//!\ one, so that a slow drift is delivered once it reaches the deadband. A temperature
+//!\ sitting between two LSBs flickers up and down: the hysteresis is only added when the
+//!\ change goes the other way than the last one delivered, which filters this flicker
+//!\ without slowing down a steady rise or fall.
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Insert the deadband stage in front of a delivery function */
+error_t DS18B20_Deadband_Init(DS18B20_Deadband_t *deadband, DS18B20_t *sensor, DS18B20_Deliver_t deliver,
+                              void *context)
+{
+	error_t result = OK;
+
+	if ((deadband == NULL) || (sensor == NULL) || (deliver == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		deadband->sensor = sensor;
+		deadband->deliver = deliver;
+		deadband->context = context;
+		deadband->delivered = 0;
+		deadband->suppressed = 0;
+
+		for (uint16_t slot = 0; slot < sensor->channel_count; slot++)
+		{
+			sensor->channels[slot].reported_valid = false;
+			sensor->channels[slot].trend = 0;
+		}
+	}
+
+	return result;
+}
+
+/* Pass a sample on if it changed enough, given as DS18B20_Deliver_t to DS18B20_Sweep */
+//!\ The samples of the slots without a channel are always passed on.
+void DS18B20_Deadband_Deliver(void *context, const DS18B20_Sample_t *sample)
+{
+	DS18B20_Deadband_t *deadband = (DS18B20_Deadband_t *)context;
+	DS18B20_Channel_t *channel = DS18B20_Channel(deadband->sensor, sample->slot);
+
+	if ((channel == NULL) || (DS18B20_Deadband_Changed(channel, sample)))
+	{
+		deadband->delivered++;
+		deadband->deliver(deadband->context, sample);
+	}
+	else
+	{
+		deadband->suppressed++;
+	}
+}
+
+/* Tell if a sample shall be delivered, and remember it as the last one delivered if so */
+//!\ Q12.4 integer math only: the difference of two int16 values always fits an int32.
+bool DS18B20_Deadband_Changed(DS18B20_Channel_t *channel, const DS18B20_Sample_t *sample)
+{
+	bool result = false;
+	int32_t change = (int32_t)sample->value - channel->reported;
+	int8_t trend = (change > 0) ? 1 : ((change < 0) ? -1 : 0);
+	uint32_t threshold = channel->deadband;
+
+	if ((trend != 0) && (trend == -channel->trend))
+	{
+		threshold += channel->hysteresis; // Change going back: filter the flicker
+	}
+
+	if ((channel->reported_valid == false) || (sample->status != channel->reported_status))
+	{
+		result = true; // First sample, or a sensor failing or coming back
+	}
+	else if ((channel->heartbeat_ms != 0U) && ((sample->timestamp - channel->reported_at) >= channel->heartbeat_ms))
+	{
+		result = true; // Keep-alive of an unchanged sensor
+	}
+	else if ((sample->status == DS18B20_SAMPLE_OK) && ((uint32_t)((change < 0) ? -change : change) >= threshold))
+	{
+		result = true;
+	}
+
+	if (result)
+	{
+		if ((channel->reported_valid) && (trend != 0))
+		{
+			channel->trend = trend;
+		}
+
+		channel->reported = sample->value;
+		channel->reported_status = sample->status;
+		channel->reported_at = sample->timestamp;
+		channel->reported_valid = true;
+	}
+
+	return result;
+}
+
+/********************************** END OF FILE ******************************************** */
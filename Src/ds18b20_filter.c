@@ -0,0 +1,126 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_filter.c                                                                          */
+/*                                                                                           */
+/* Median-of-3 spike rejection and exponential moving average per sensor                     */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_filter.h"
+
+//!\ The median of the last 3 values replaces a single wrong value, e.g. a bit flipped by
+//!\ EMI on a long line, by one of its neighbours, without delaying a real step by more than
+//!\ one sample. The average is then avg += (value - avg) / 2^ema_shift, kept shifted left
+//!\ by ema_shift so that its fraction is not lost: integer math only, a few cycles per sample.
+//!\ A failed sample is passed on unchanged and leaves the filter state as it was.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static int16_t DS18B20_Filter_Median(int16_t a, int16_t b, int16_t c);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Insert the filter stage in front of a delivery function */
+error_t DS18B20_Filter_Init(DS18B20_Filter_t *filter, DS18B20_t *sensor, DS18B20_Deliver_t deliver, void *context)
+{
+	error_t result = OK;
+
+	if ((filter == NULL) || (sensor == NULL) || (deliver == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		filter->sensor = sensor;
+		filter->deliver = deliver;
+		filter->context = context;
+		filter->spikes = 0;
+
+		for (uint16_t slot = 0; slot < sensor->channel_count; slot++)
+		{
+			sensor->channels[slot].previous_count = 0;
+			sensor->channels[slot].ema_valid = false;
+		}
+	}
+
+	return result;
+}
+
+/* Filter a sample and pass it on, given as DS18B20_Deliver_t to DS18B20_Sweep */
+//!\ The samples of the slots without a channel are passed on unchanged.
+void DS18B20_Filter_Deliver(void *context, const DS18B20_Sample_t *sample)
+{
+	DS18B20_Filter_t *filter = (DS18B20_Filter_t *)context;
+	DS18B20_Channel_t *channel = DS18B20_Channel(filter->sensor, sample->slot);
+	DS18B20_Sample_t filtered = *sample;
+
+	if ((channel != NULL) && (DS18B20_Filter_Apply(channel, &filtered)))
+	{
+		filter->spikes++;
+	}
+
+	filter->deliver(filter->context, &filtered);
+}
+
+/* Replace the value of a sample by its filtered value, and update the state of the channel */
+//!\ Returns true if the median rejected the raw value.
+bool DS18B20_Filter_Apply(DS18B20_Channel_t *channel, DS18B20_Sample_t *sample)
+{
+	bool result = false;
+	int16_t value = sample->value;
+
+	if (sample->status == DS18B20_SAMPLE_OK)
+	{
+		if (channel->median)
+		{
+			// Until 3 values are known, the median is the raw value
+			if (channel->previous_count >= 2U)
+			{
+				value = DS18B20_Filter_Median(sample->value, channel->previous[0], channel->previous[1]);
+				result = (value != sample->value);
+			}
+
+			channel->previous[1] = channel->previous[0];
+			channel->previous[0] = sample->value;
+			channel->previous_count = (channel->previous_count < 2U) ? (uint8_t)(channel->previous_count + 1U) : 2U;
+		}
+
+		if (channel->ema_shift != 0U)
+		{
+			uint8_t shift = (channel->ema_shift < DS18B20_FILTER_EMA_SHIFT_MAX) ? channel->ema_shift
+			                                                                    : (uint8_t)DS18B20_FILTER_EMA_SHIFT_MAX;
+
+			if (channel->ema_valid == false)
+			{
+				channel->ema = (int32_t)value * (1L << shift);	// Starts at the first value, not at 0
+				channel->ema_valid = true;
+			}
+			else
+			{
+				channel->ema += (int32_t)value - (channel->ema >> shift);
+			}
+
+			// Rounded to the nearest LSB
+			value = (int16_t)((channel->ema + (1L << (shift - 1U))) >> shift);
+		}
+
+		sample->value = value;
+	}
+
+	return result;
+}
+
+/* Median of 3 values */
+int16_t DS18B20_Filter_Median(int16_t a, int16_t b, int16_t c)
+{
+	int16_t low = (a < b) ? a : b;
+	int16_t high = (a < b) ? b : a;
+
+	return (c < low) ? low : ((c > high) ? high : c);
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,429 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_flashlog.c                                                                        */
+/*                                                                                           */
+/* Append-only log of encoded samples in a ring of flash sectors                             */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_flashlog.h"
+
+/** Include the CRC of the telemetry frames */
+#include "ds18b20_telemetry.h"
+
+#include <string.h>
+
+//!\ The region is a ring of pages, written in order. A sector is erased when the log enters
+//!\ it, unless it is blank already, which also levels the wear: every sector is erased once
+//!\ per turn of the ring, and not again by a reset.
+//!\ A page is programmed once, full, with a header holding its sequence number and a CRC.
+//!\ After a reset, the newest valid page tells where to go on. A page torn by a power cut
+//!\ fails its CRC and is never used again, and an interrupted erase is done again since
+//!\ no page of its sector was written yet.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static void DS18B20_FlashLog_Recover(DS18B20_FlashLog_t *log);
+static void DS18B20_FlashLog_Prepare(DS18B20_FlashLog_t *log);
+static bool DS18B20_FlashLog_Check(const DS18B20_FlashLog_t *log, uint32_t position, uint8_t data[],
+                                   uint32_t *sequence, uint16_t *length);
+static bool DS18B20_FlashLog_Blank(const DS18B20_FlashLog_t *log, uint32_t position);
+static void DS18B20_FlashLog_Put32(uint8_t data[], uint32_t value);
+static uint32_t DS18B20_FlashLog_Get32(const uint8_t data[]);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Initialize a log on a flash region and go on after its newest valid page */
+//!\ page is the RAM buffer of a page, flash->page_size bytes aligned on 4 bytes. codec is
+//!\ only needed by DS18B20_FlashLog_Deliver; it is keyed at each page, so that every page
+//!\ can be decoded alone.
+error_t DS18B20_FlashLog_Init(DS18B20_FlashLog_t *log, const DS18B20_Flash_t *flash, uint8_t page[],
+                              DS18B20_Codec_t *codec)
+{
+	error_t result = OK;
+
+	if ((log == NULL) || (flash == NULL) || (page == NULL)
+		|| (flash->read == NULL) || (flash->program == NULL) || (flash->erase == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else if ((flash->sector_count < 2U) || (flash->page_size <= DS18B20_FLASHLOG_HEADER_SIZE)
+		|| ((flash->page_size % DS18B20_FLASHLOG_WORD_SIZE) != 0U)
+		|| (flash->sector_size < flash->page_size) || ((flash->sector_size % flash->page_size) != 0U)
+		|| ((codec != NULL) && (flash->page_size < (DS18B20_FLASHLOG_HEADER_SIZE + DS18B20_CODEC_MAX_SIZE))))
+	{
+		result = ERROR_OTHER;
+	}
+	else
+	{
+		log->flash = flash;
+		log->page = page;
+		log->fill = 0;
+		log->codec = codec;
+		log->sector_pages = flash->sector_size / flash->page_size;
+		log->page_count = log->sector_pages * flash->sector_count;
+		log->pages = 0;
+		log->erases = 0;
+		log->skipped = 0;
+		log->program_errors = 0;
+		log->errors = 0;
+
+		DS18B20_FlashLog_Recover(log);
+		DS18B20_FlashLog_Prepare(log);
+
+		if (codec != NULL)
+		{
+			DS18B20_Codec_Key(codec);
+		}
+	}
+
+	return result;
+}
+
+/* Add data to the page being filled, writing the page first if the data does not fit */
+//!\ A log is filled either by DS18B20_FlashLog_Deliver or by this function, not both.
+uint8_t DS18B20_FlashLog_Append(DS18B20_FlashLog_t *log, const uint8_t data[], uint16_t length)
+{
+	uint8_t result = 0;
+	uint16_t capacity = (uint16_t)(log->flash->page_size - DS18B20_FLASHLOG_HEADER_SIZE);
+
+	if (length > capacity)
+	{
+		result = 1;
+	}
+	else if ((length > (capacity - log->fill)) && (DS18B20_FlashLog_Flush(log) != 0U))
+	{
+		result = 1;
+	}
+	else
+	{
+		memcpy(&log->page[DS18B20_FLASHLOG_HEADER_SIZE + log->fill], data, length);
+		log->fill = (uint16_t)(log->fill + length);
+	}
+
+	if (result != 0U)
+	{
+		log->errors++;
+	}
+
+	return result;	// returns 1 if the data was dropped
+}
+
+/* Write the page being filled, and move to the next one */
+//!\ If programming fails, the page is left behind and its data kept in RAM for the next try.
+uint8_t DS18B20_FlashLog_Flush(DS18B20_FlashLog_t *log)
+{
+	uint8_t result = 0;
+	uint16_t page_size = log->flash->page_size;
+
+	if (log->fill != 0U)
+	{
+		uint8_t *page = log->page;
+
+		// The CRC covers the length, the sequence number and the data
+		memset(&page[DS18B20_FLASHLOG_HEADER_SIZE + log->fill], 0xFF,
+		       (size_t)(page_size - DS18B20_FLASHLOG_HEADER_SIZE - log->fill));
+		DS18B20_FlashLog_Put32(&page[0], DS18B20_FLASHLOG_MAGIC);
+		page[6] = (uint8_t)log->fill;
+		page[7] = (uint8_t)(log->fill >> 8);
+		DS18B20_FlashLog_Put32(&page[8], log->sequence);
+
+		uint16_t crc = DS18B20_Telemetry_CRC(&page[6], (uint16_t)(DS18B20_FLASHLOG_HEADER_SIZE - 6U + log->fill));
+		page[4] = (uint8_t)crc;
+		page[5] = (uint8_t)(crc >> 8);
+
+		// A sequence number is never used twice, even by a page that failed
+		log->sequence++;
+
+		if (log->flash->program(log->flash->context, log->position * page_size, page, page_size) != 0U)
+		{
+			log->program_errors++;
+			result = 1;
+		}
+		else
+		{
+			log->pages++;
+			log->fill = 0;
+
+			if (log->codec != NULL)
+			{
+				DS18B20_Codec_Key(log->codec);
+			}
+		}
+
+		log->position = (log->position + 1U) % log->page_count;
+		DS18B20_FlashLog_Prepare(log);
+	}
+
+	return result;	// returns 1 if the page could not be written
+}
+
+/* Encode a sample into the log, given as DS18B20_Deliver_t to DS18B20_Sweep */
+void DS18B20_FlashLog_Deliver(void *context, const DS18B20_Sample_t *sample)
+{
+	DS18B20_FlashLog_t *log = (DS18B20_FlashLog_t *)context;
+	uint16_t capacity = (uint16_t)(log->flash->page_size - DS18B20_FLASHLOG_HEADER_SIZE);
+
+	if ((uint16_t)(capacity - log->fill) < DS18B20_CODEC_MAX_SIZE)
+	{
+		(void)DS18B20_FlashLog_Flush(log);
+	}
+
+	if ((log->codec == NULL) || ((uint16_t)(capacity - log->fill) < DS18B20_CODEC_MAX_SIZE))
+	{
+		log->errors++;
+	}
+	else
+	{
+		log->fill = (uint16_t)(log->fill + DS18B20_Codec_Encode(log->codec, sample,
+		                                                        &log->page[DS18B20_FLASHLOG_HEADER_SIZE + log->fill]));
+	}
+}
+
+/* Start reading the log from its oldest page */
+void DS18B20_FlashLog_Rewind(const DS18B20_FlashLog_t *log, DS18B20_FlashCursor_t *cursor)
+{
+	// The oldest pages are in the sector after the current one, which is erased next
+	uint32_t sector = ((log->position / log->sector_pages) + 1U) % log->flash->sector_count;
+
+	cursor->position = sector * log->sector_pages;
+	cursor->remaining = log->page_count;
+	cursor->sequence = 0;
+}
+
+/* Read the data of the next valid page, data shall hold flash->page_size bytes */
+//!\ Only the written pages are read: the page being filled is not, until it is flushed.
+uint8_t DS18B20_FlashLog_Read(const DS18B20_FlashLog_t *log, DS18B20_FlashCursor_t *cursor, uint8_t data[],
+                              uint16_t *length)
+{
+	uint8_t result = 1;
+	uint32_t sequence = 0;
+
+	while ((result != 0U) && (cursor->remaining != 0U))
+	{
+		bool valid = DS18B20_FlashLog_Check(log, cursor->position, data, &sequence, length);
+
+		cursor->position = (cursor->position + 1U) % log->page_count;
+		cursor->remaining--;
+
+		// A page older than the previous one was left by an interrupted erase
+		if ((valid) && (sequence > cursor->sequence))
+		{
+			memmove(data, &data[DS18B20_FLASHLOG_HEADER_SIZE], *length);
+			cursor->sequence = sequence;
+			result = 0;
+		}
+	}
+
+	return result;	// returns 1 at the end of the log
+}
+
+/* Read the internal flash, the region being mapped in memory */
+uint8_t DS18B20_FlashH7_Read(void *context, uint32_t address, uint8_t data[], uint32_t length)
+{
+	DS18B20_FlashH7_t *region = (DS18B20_FlashH7_t *)context;
+
+	memcpy(data, (const void *)(uintptr_t)(region->address + address), length);
+
+	return 0;
+}
+
+/* Program the internal flash, length shall be a multiple of the flash word (32 bytes) */
+//!\ data shall be aligned on 4 bytes, HAL_FLASH_Program reads it by words.
+uint8_t DS18B20_FlashH7_Program(void *context, uint32_t address, const uint8_t data[], uint32_t length)
+{
+	DS18B20_FlashH7_t *region = (DS18B20_FlashH7_t *)context;
+	uint32_t word = DS18B20_FLASHLOG_WORD_SIZE;
+	uint8_t result = 0;
+
+	HAL_FLASH_Unlock();
+
+	for (uint32_t offset = 0; (offset < length) && (result == 0U); offset += word)
+	{
+		if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD, region->address + address + offset,
+		                      (uint32_t)(uintptr_t)&data[offset]) != HAL_OK)
+		{
+			result = 1;
+		}
+	}
+
+	HAL_FLASH_Lock();
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+	// The cache may still hold the erased content
+	SCB_InvalidateDCache_by_Addr((void *)(uintptr_t)(region->address + address), (int32_t)length);
+#endif
+
+	return result;
+}
+
+/* Erase a sector of the internal flash */
+uint8_t DS18B20_FlashH7_Erase(void *context, uint16_t sector)
+{
+	DS18B20_FlashH7_t *region = (DS18B20_FlashH7_t *)context;
+	FLASH_EraseInitTypeDef erase = {0};
+	uint32_t error = 0;
+	uint8_t result = 0;
+
+	erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+	erase.Banks = region->bank;
+	erase.Sector = region->first_sector + sector;
+	erase.NbSectors = 1;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+	HAL_FLASH_Unlock();
+
+	if (HAL_FLASHEx_Erase(&erase, &error) != HAL_OK)
+	{
+		result = 1;
+	}
+
+	HAL_FLASH_Lock();
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+	SCB_InvalidateDCache_by_Addr((void *)(uintptr_t)(region->address + ((uint32_t)sector * FLASH_SECTOR_SIZE)),
+	                             (int32_t)FLASH_SECTOR_SIZE);
+#endif
+
+	return result;
+}
+
+/* Find the newest valid page, the log goes on after it */
+void DS18B20_FlashLog_Recover(DS18B20_FlashLog_t *log)
+{
+	uint32_t newest = 0;
+	uint32_t sequence = 0;
+	uint16_t length = 0;
+
+	log->position = 0;
+	log->sequence = 0;
+
+	for (uint32_t position = 0; position < log->page_count; position++)
+	{
+		if ((DS18B20_FlashLog_Check(log, position, log->page, &sequence, &length)) && (sequence > log->sequence))
+		{
+			newest = position;
+			log->sequence = sequence;
+		}
+	}
+
+	if (log->sequence != 0U)
+	{
+		log->position = (newest + 1U) % log->page_count;
+	}
+
+	log->sequence++;	// The first sequence number of an empty log is 1
+}
+
+/* Make sure the current page is blank, erasing its sector when entering it */
+//!\ A page which is not blank in the middle of a sector was torn by a power cut: it is skipped.
+//!\ A blank sector is not erased, e.g. the current one after a reset.
+void DS18B20_FlashLog_Prepare(DS18B20_FlashLog_t *log)
+{
+	bool ready = false;
+
+	for (uint32_t tries = 0; (!ready) && (tries < log->page_count); tries++)
+	{
+		if ((log->position % log->sector_pages) == 0U)
+		{
+			bool blank = true;
+
+			for (uint32_t page = 0; (page < log->sector_pages) && (blank); page++)
+			{
+				blank = DS18B20_FlashLog_Blank(log, log->position + page);
+			}
+
+			if (blank == false)
+			{
+				if (log->flash->erase(log->flash->context, (uint16_t)(log->position / log->sector_pages)) != 0U)
+				{
+					log->errors++;
+				}
+				else
+				{
+					log->erases++;
+				}
+			}
+		}
+
+		if (DS18B20_FlashLog_Blank(log, log->position))
+		{
+			ready = true;
+		}
+		else
+		{
+			log->skipped++;
+			log->position = (log->position + 1U) % log->page_count;
+		}
+	}
+}
+
+/* Read a page and check its header and CRC */
+bool DS18B20_FlashLog_Check(const DS18B20_FlashLog_t *log, uint32_t position, uint8_t data[],
+                            uint32_t *sequence, uint16_t *length)
+{
+	bool result = false;
+	uint16_t page_size = log->flash->page_size;
+
+	if ((log->flash->read(log->flash->context, position * page_size, data, page_size) == 0U)
+		&& (DS18B20_FlashLog_Get32(&data[0]) == DS18B20_FLASHLOG_MAGIC))
+	{
+		uint16_t crc = (uint16_t)(data[4] | ((uint16_t)data[5] << 8));
+
+		*length = (uint16_t)(data[6] | ((uint16_t)data[7] << 8));
+		*sequence = DS18B20_FlashLog_Get32(&data[8]);
+
+		result = (*length <= (page_size - DS18B20_FLASHLOG_HEADER_SIZE))
+			&& (DS18B20_Telemetry_CRC(&data[6], (uint16_t)(DS18B20_FLASHLOG_HEADER_SIZE - 6U + *length)) == crc);
+	}
+
+	return result;
+}
+
+/* Check that a page is erased, reading it by small blocks to keep the page buffer */
+bool DS18B20_FlashLog_Blank(const DS18B20_FlashLog_t *log, uint32_t position)
+{
+	bool result = true;
+	uint8_t block[32];
+	uint16_t page_size = log->flash->page_size;
+
+	for (uint16_t offset = 0; (offset < page_size) && (result); offset += sizeof(block))
+	{
+		uint16_t size = (uint16_t)(page_size - offset);
+
+		size = (size < sizeof(block)) ? size : (uint16_t)sizeof(block);
+
+		if (log->flash->read(log->flash->context, (position * page_size) + offset, block, size) != 0U)
+		{
+			result = false;
+		}
+
+		for (uint16_t i = 0; (i < size) && (result); i++)
+		{
+			result = (block[i] == 0xFFU);
+		}
+	}
+
+	return result;
+}
+
+/* Write a little-endian uint32 */
+void DS18B20_FlashLog_Put32(uint8_t data[], uint32_t value)
+{
+	data[0] = (uint8_t)value;
+	data[1] = (uint8_t)(value >> 8);
+	data[2] = (uint8_t)(value >> 16);
+	data[3] = (uint8_t)(value >> 24);
+}
+
+/* Read a little-endian uint32 */
+uint32_t DS18B20_FlashLog_Get32(const uint8_t data[])
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,272 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_history.c                                                                         */
+/*                                                                                           */
+/* Per-sensor history: raw samples and minute / hour min, mean and max                       */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_history.h"
+
+//!\ Each sample updates the raw ring and the running min, max and sum of the minute and of
+//!\ the hour in progress, in constant time. A period is closed, and its aggregate stored,
+//!\ when the first sample of a later period arrives: the periods without any valid sample
+//!\ are not stored, the index of each aggregate tells which period it is.
+//!\ Only the samples with an OK status are stored; a missing sample leaves a gap in the
+//!\ raw ring, where the time of the older samples is lost.
+//!\ A raw sample keeps the time since the previous one in 16 bits: in ms up to 32.767 s,
+//!\ otherwise as the second of the previous sample (modulo DS18B20_HISTORY_SECONDS_MOD).
+//!\ That second is absolute, so the rounding of the rebuilt timestamps (less than 1 s, and
+//!\ only before such a delta) never adds up along the ring. Two samples more than
+//!\ DS18B20_HISTORY_SPAN_MS apart, or on both sides of the wrap of the HAL tick with more
+//!\ than 32.767 s between them, are separated by a gap.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static void DS18B20_History_InitLevel(DS18B20_HistoryLevel_t *level, DS18B20_Aggregate_t buffer[],
+                                      uint16_t capacity, uint32_t period_ms);
+static void DS18B20_History_Update(DS18B20_HistoryLevel_t *level, uint32_t timestamp, int16_t value);
+static int16_t DS18B20_History_Mean(int32_t sum, uint16_t count);
+static bool DS18B20_History_Level(const DS18B20_HistoryLevel_t *level, uint16_t index,
+                                  DS18B20_Aggregate_t *aggregate);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Initialize the history of a sensor, any buffer may be NULL with a capacity of 0 */
+error_t DS18B20_History_Init(DS18B20_History_t *history, int16_t values[], uint16_t deltas[], uint16_t capacity,
+                             DS18B20_Aggregate_t minutes[], uint16_t minute_capacity,
+                             DS18B20_Aggregate_t hours[], uint16_t hour_capacity)
+{
+	error_t result = OK;
+
+	if ((history == NULL) || ((capacity != 0U) && ((values == NULL) || (deltas == NULL)))
+		|| ((minute_capacity != 0U) && (minutes == NULL)) || ((hour_capacity != 0U) && (hours == NULL)))
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		history->values = values;
+		history->deltas = deltas;
+		history->capacity = capacity;
+		history->head = 0;
+		history->count = 0;
+		history->last_timestamp = 0;
+		history->gap = false;
+
+		DS18B20_History_InitLevel(&history->minutes, minutes, minute_capacity, DS18B20_HISTORY_MINUTE_MS);
+		DS18B20_History_InitLevel(&history->hours, hours, hour_capacity, DS18B20_HISTORY_HOUR_MS);
+	}
+
+	return result;
+}
+
+/* Store a sample in the history of its sensor */
+void DS18B20_History_Add(DS18B20_History_t *history, const DS18B20_Sample_t *sample)
+{
+	if (sample->status != DS18B20_SAMPLE_OK)
+	{
+		history->gap = true;
+	}
+	else
+	{
+		if (history->capacity != 0U)
+		{
+			uint32_t delta = sample->timestamp - history->last_timestamp;
+
+			if ((history->count == 0U) || (history->gap) || (delta >= DS18B20_HISTORY_SPAN_MS)
+				|| ((delta > DS18B20_HISTORY_MS_MAX) && (sample->timestamp < history->last_timestamp)))
+			{
+				delta = DS18B20_HISTORY_GAP;
+			}
+			else if (delta > DS18B20_HISTORY_MS_MAX)
+			{
+				delta = DS18B20_HISTORY_SECONDS | ((history->last_timestamp / 1000U) % DS18B20_HISTORY_SECONDS_MOD);
+			}
+
+			history->values[history->head] = sample->value;
+			history->deltas[history->head] = (uint16_t)delta;
+			history->head = (uint16_t)((history->head + 1U) % history->capacity);
+
+			if (history->count < history->capacity)
+			{
+				history->count++;
+			}
+		}
+
+		history->last_timestamp = sample->timestamp;
+		history->gap = false;
+
+		DS18B20_History_Update(&history->minutes, sample->timestamp, sample->value);
+		DS18B20_History_Update(&history->hours, sample->timestamp, sample->value);
+	}
+}
+
+/* Get a raw sample, index 0 being the newest one */
+//!\ The timestamp is rebuilt from the deltas of the newer samples, so this takes a time
+//!\ proportional to index. It is DS18B20_HISTORY_NO_TIME beyond a gap, and rounded down to
+//!\ the second beyond a delta longer than DS18B20_HISTORY_MS_MAX.
+bool DS18B20_History_Get(const DS18B20_History_t *history, uint16_t index, int16_t *value, uint32_t *timestamp)
+{
+	bool result = false;
+
+	if (index < history->count)
+	{
+		uint16_t position = (uint16_t)((history->head + history->capacity - 1U) % history->capacity);
+		uint32_t time = history->last_timestamp;
+
+		for (uint16_t i = 0; i < index; i++)
+		{
+			uint16_t delta = history->deltas[position];
+
+			if ((time == DS18B20_HISTORY_NO_TIME) || (delta == DS18B20_HISTORY_GAP))
+			{
+				time = DS18B20_HISTORY_NO_TIME;
+			}
+			else if ((delta & DS18B20_HISTORY_SECONDS) != 0U)
+			{
+				// Start of the stored second, at least 32 s back: the second of a time
+				// already rounded down, one too low at most, still leads to it
+				uint32_t seconds = time / 1000U;
+				uint32_t back = ((seconds % DS18B20_HISTORY_SECONDS_MOD) + DS18B20_HISTORY_SECONDS_MOD
+				                 - (delta & DS18B20_HISTORY_MS_MAX)) % DS18B20_HISTORY_SECONDS_MOD;
+
+				time = (seconds - back) * 1000U;
+			}
+			else
+			{
+				time -= delta;
+			}
+
+			position = (uint16_t)((position + history->capacity - 1U) % history->capacity);
+		}
+
+		*value = history->values[position];
+		*timestamp = time;
+		result = true;
+	}
+
+	return result;	// returns false if the history has no such sample
+}
+
+/* Get the aggregate of a minute, index 0 being the minute in progress */
+bool DS18B20_History_Minute(const DS18B20_History_t *history, uint16_t index, DS18B20_Aggregate_t *aggregate)
+{
+	return DS18B20_History_Level(&history->minutes, index, aggregate);
+}
+
+/* Get the aggregate of an hour, index 0 being the hour in progress */
+bool DS18B20_History_Hour(const DS18B20_History_t *history, uint16_t index, DS18B20_Aggregate_t *aggregate)
+{
+	return DS18B20_History_Level(&history->hours, index, aggregate);
+}
+
+/* Store a sample in the history of its slot, given as DS18B20_Deliver_t to DS18B20_Sweep */
+void DS18B20_History_Deliver(void *context, const DS18B20_Sample_t *sample)
+{
+	DS18B20_Histories_t *histories = (DS18B20_Histories_t *)context;
+
+	if (sample->slot < histories->count)
+	{
+		DS18B20_History_Add(&histories->histories[sample->slot], sample);
+	}
+
+	if (histories->deliver != NULL)
+	{
+		histories->deliver(histories->context, sample);
+	}
+}
+
+/* Initialize the aggregates of one period length */
+void DS18B20_History_InitLevel(DS18B20_HistoryLevel_t *level, DS18B20_Aggregate_t buffer[],
+                               uint16_t capacity, uint32_t period_ms)
+{
+	level->buffer = buffer;
+	level->capacity = capacity;
+	level->head = 0;
+	level->count = 0;
+	level->period_ms = period_ms;
+	level->current.count = 0;
+	level->sum = 0;
+}
+
+/* Add a sample to the period in progress, closing it first if the sample is in a later one */
+void DS18B20_History_Update(DS18B20_HistoryLevel_t *level, uint32_t timestamp, int16_t value)
+{
+	uint32_t period = timestamp / level->period_ms;
+
+	if ((level->current.count != 0U) && (period != level->current.period))
+	{
+		level->current.mean = DS18B20_History_Mean(level->sum, level->current.count);
+
+		if (level->capacity != 0U)
+		{
+			level->buffer[level->head] = level->current;
+			level->head = (uint16_t)((level->head + 1U) % level->capacity);
+
+			if (level->count < level->capacity)
+			{
+				level->count++;
+			}
+		}
+
+		level->current.count = 0;
+		level->sum = 0;
+	}
+
+	if (level->current.count == 0U)
+	{
+		level->current.period = period;
+		level->current.min = value;
+		level->current.max = value;
+	}
+	else
+	{
+		level->current.min = (value < level->current.min) ? value : level->current.min;
+		level->current.max = (value > level->current.max) ? value : level->current.max;
+	}
+
+	// The sum of UINT16_MAX int16 values still fits an int32
+	if (level->current.count < UINT16_MAX)
+	{
+		level->sum += value;
+		level->current.count++;
+	}
+}
+
+/* Mean of count Q12.4 values, rounded to the nearest */
+int16_t DS18B20_History_Mean(int32_t sum, uint16_t count)
+{
+	int32_t half = (sum < 0) ? -(int32_t)(count / 2U) : (int32_t)(count / 2U);
+
+	return (int16_t)((sum + half) / (int32_t)count);
+}
+
+/* Get an aggregate of one period length, index 0 being the period in progress */
+bool DS18B20_History_Level(const DS18B20_HistoryLevel_t *level, uint16_t index, DS18B20_Aggregate_t *aggregate)
+{
+	bool result = false;
+
+	if (index == 0U)
+	{
+		if (level->current.count != 0U)
+		{
+			*aggregate = level->current;
+			aggregate->mean = DS18B20_History_Mean(level->sum, level->current.count);
+			result = true;
+		}
+	}
+	else if (index <= level->count)
+	{
+		*aggregate = level->buffer[(level->head + level->capacity - index) % level->capacity];
+		result = true;
+	}
+
+	return result;	// returns false if the history has no such period
+}
+
+/********************************** END OF FILE ******************************************** */
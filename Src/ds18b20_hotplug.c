@@ -0,0 +1,186 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_hotplug.c                                                                         */
+/*                                                                                           */
+/* Background detection of the sensors added to or removed from a bus                        */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_hotplug.h"
+
+//!\ The bus is searched again in the background, one device per call of
+//!\ DS18B20_Hotplug_Step (or max_slots time slots, if set), so that the search can be
+//!\ interleaved with the acquisitions.
+//!\ The ROM codes array of the table is updated in place and never compacted: a device
+//!\ keeps its slot as long as it is on the bus, a new device takes the first free slot,
+//!\ and the slot of a removed device is marked DS18B20_FREE_SLOT. The indexes used by the
+//!\ consumers of the samples and by the caches therefore stay valid. The channel of a slot
+//!\ is reset when its device is added or removed, so that the state of the previous device
+//!\ (register shadow, filter, last values) is never used for the next one.
+//!\ A ROM code with a wrong CRC starts the pass again, DS18B20_HOTPLUG_RESTARTS times at
+//!\ most: the pass then walks on past this device, so that a persistent fault (a damaged
+//!\ sensor, a noisy branch) does not hide the devices removed elsewhere on the bus. The
+//!\ device skipped is not seen by the pass, and is reported removed if it was known.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static void DS18B20_Hotplug_Found(DS18B20_Hotplug_t *hotplug, uint64_t ROM_code);
+static void DS18B20_Hotplug_EndPass(DS18B20_Hotplug_t *hotplug);
+static void DS18B20_Hotplug_Event(DS18B20_Hotplug_t *hotplug, DS18B20_HotplugEvent_t event,
+                                  uint16_t slot, uint64_t ROM_code);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Check the hot-plug structure, the table holds the devices already known */
+//!\ The table may have been initialized with the result of DS18B20_Search.
+error_t DS18B20_Hotplug_Init(DS18B20_Hotplug_t *hotplug)
+{
+	error_t result = OK;
+
+	if ((hotplug == NULL) || (hotplug->sensor == NULL) || (hotplug->table == NULL) || (hotplug->seen == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else if (hotplug->table->ROM_codes == NULL)
+	{
+		result = ERROR_OTHER; // The acquisition functions need the ROM codes array of a full table
+	}
+	else
+	{
+		hotplug->pass_active = false;
+		hotplug->restarts = 0;
+		hotplug->skipped = 0;
+		hotplug->passes = 0;
+	}
+
+	return result;
+}
+
+/* Advance the search of the bus, and update the array at the end of a pass */
+//!\ Returns true when a whole search pass has just been completed.
+bool DS18B20_Hotplug_Step(DS18B20_Hotplug_t *hotplug)
+{
+	bool result = false;
+	uint64_t ROM_code = 0ULL;
+	uint16_t max_slots = (hotplug->max_slots == 0U) ? UINT16_MAX : hotplug->max_slots;
+
+	if (hotplug->pass_active == false)
+	{
+		DS18B20_SearchInit(&hotplug->search);
+
+		for (uint16_t i = 0; i < DS18B20_HOTPLUG_SEEN_WORDS(hotplug->table->capacity); i++)
+		{
+			hotplug->seen[i] = 0U;
+		}
+
+		hotplug->pass_active = true;
+	}
+
+	switch (DS18B20_SearchStep(hotplug->sensor, &hotplug->search, max_slots, &ROM_code))
+	{
+	case DS18B20_SEARCH_IN_PROGRESS:
+		// Device partly walked, resumed by the next step
+		break;
+
+	case DS18B20_SEARCH_FOUND:
+		// The other devices of the bus (ID chips, switches...) never take a slot
+		if (DS18B20_IsSensor(ROM_code))
+		{
+			DS18B20_Hotplug_Found(hotplug, ROM_code);
+		}
+		break;
+
+	case DS18B20_SEARCH_DONE:
+		// Whole tree walked: the devices not seen were removed
+		DS18B20_Hotplug_EndPass(hotplug);
+		result = true;
+		break;
+
+	case DS18B20_SEARCH_CRC_ERROR:
+		if (hotplug->restarts < DS18B20_HOTPLUG_RESTARTS)
+		{
+			// Device plugged or unplugged during the pass, or noise on the bus: start again
+			// without removing anything
+			hotplug->restarts++;
+			hotplug->pass_active = false;
+		}
+		else
+		{
+			// Persistent: the search state already points past this branch
+			hotplug->skipped++;
+		}
+		break;
+
+	default:
+		// Presence pulse lost after the first device: the rest of the tree is not known,
+		// start again without removing anything
+		hotplug->pass_active = false;
+		break;
+	}
+
+	return result;
+}
+
+/* Mark a found device as seen, or give it a free slot */
+void DS18B20_Hotplug_Found(DS18B20_Hotplug_t *hotplug, uint64_t ROM_code)
+{
+	uint16_t slot = DS18B20_RomTable_Find(hotplug->table, ROM_code);
+
+	if (slot == DS18B20_ROMTABLE_NONE)
+	{
+		slot = DS18B20_RomTable_Add(hotplug->table, ROM_code);
+
+		if (slot != DS18B20_ROMTABLE_NONE)
+		{
+			DS18B20_Channel_Reset(hotplug->sensor, slot); // Nothing known yet of this sensor
+			DS18B20_Hotplug_Event(hotplug, DS18B20_DEVICE_ADDED, slot, ROM_code);
+		}
+		else
+		{
+			DS18B20_Hotplug_Event(hotplug, DS18B20_DEVICE_NO_SLOT, UINT16_MAX, ROM_code);
+		}
+	}
+
+	if (slot != DS18B20_ROMTABLE_NONE)
+	{
+		hotplug->seen[slot / 32U] |= (1UL << (slot % 32U));
+	}
+}
+
+/* Free the slots of the devices that were not seen during the pass */
+void DS18B20_Hotplug_EndPass(DS18B20_Hotplug_t *hotplug)
+{
+	for (uint16_t slot = 0; slot < hotplug->table->capacity; slot++)
+	{
+		uint64_t ROM_code = DS18B20_RomTable_Get(hotplug->table, slot);
+
+		if ((ROM_code != DS18B20_FREE_SLOT) && ((hotplug->seen[slot / 32U] & (1UL << (slot % 32U))) == 0U))
+		{
+			(void)DS18B20_RomTable_Remove(hotplug->table, slot);
+			DS18B20_Channel_Reset(hotplug->sensor, slot);
+			DS18B20_Hotplug_Event(hotplug, DS18B20_DEVICE_REMOVED, slot, ROM_code);
+		}
+	}
+
+	hotplug->pass_active = false;
+	hotplug->restarts = 0;
+	hotplug->passes++;
+}
+
+/* Send an event to the callback, if any */
+void DS18B20_Hotplug_Event(DS18B20_Hotplug_t *hotplug, DS18B20_HotplugEvent_t event,
+                           uint16_t slot, uint64_t ROM_code)
+{
+	log_ds18b20(DS18B20_LOG_HOTPLUG, event, slot);
+
+	if (hotplug->callback != NULL)
+	{
+		hotplug->callback(hotplug->context, event, slot, ROM_code);
+	}
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,101 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_log.c                                                                             */
+/*                                                                                           */
+/* Debug messages of the DS18B20 driver, printed at once or deferred as binary records       */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_log.h"
+
+#ifdef DEBUG_DS18B20
+
+#include <string.h>		// Required to use memcpy
+
+#include "stm32h7xx_hal.h" 	// HAL_GetTick
+
+//!\ The deferred ring works like the sample ring: wait-free for one producer (the driver)
+//!\ and one consumer (the idle loop), with free-running indexes counted in words.
+//!\ A record is written in the ring only if it fits as a whole, so that it costs a few
+//!\ stores instead of the milliseconds of a printf through the UART at 115200 baud.
+
+#define DS18B20_LOG_STRING(id)	id##_FMT,
+const char *const DS18B20_log_formats[DS18B20_LOG_COUNT] = { DS18B20_LOG_FORMATS(DS18B20_LOG_STRING) };
+#undef DS18B20_LOG_STRING
+
+#ifdef DS18B20_LOG_DEFERRED
+
+DS18B20_Log_t DS18B20_log;
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Store a message in the deferred ring (producer side) */
+//!\ arguments[0] is the leading 0 of log_ds18b20, the count arguments follow it.
+void DS18B20_Log_Write(uint8_t id, const uint32_t *arguments, uint8_t count)
+{
+	// Only the producer writes head, so a relaxed load is enough
+	uint32_t head = atomic_load_explicit(&DS18B20_log.head, memory_order_relaxed);
+	// Acquire pairs with the release of the consumer: the words are free to overwrite
+	uint32_t tail = atomic_load_explicit(&DS18B20_log.tail, memory_order_acquire);
+
+	if ((head - tail) + 2U + count > DS18B20_LOG_SIZE)
+	{
+		DS18B20_log.dropped++; // Ring full, the record is lost
+	}
+	else
+	{
+		DS18B20_log.words[head++ & (DS18B20_LOG_SIZE - 1U)] = ((uint32_t)DS18B20_LOG_SYNC << 24)
+		                                                     | ((uint32_t)count << 8) | id;
+		DS18B20_log.words[head++ & (DS18B20_LOG_SIZE - 1U)] = HAL_GetTick();
+
+		for (uint8_t i = 0; i < count; i++)
+		{
+			DS18B20_log.words[head++ & (DS18B20_LOG_SIZE - 1U)] = arguments[i + 1U];
+		}
+
+		// Publish the record to the consumer
+		atomic_store_explicit(&DS18B20_log.head, head, memory_order_release);
+	}
+}
+
+/* Copy the pending records into a buffer, to be sent to the host (consumer side) */
+//!\ Only whole records are copied, in the byte order of the target (little-endian).
+//!\ Returns the number of bytes copied, 0 if the ring is empty.
+uint32_t DS18B20_Log_Drain(uint8_t buffer[], uint32_t size)
+{
+	uint32_t length = 0;
+
+	// Only the consumer writes tail, so a relaxed load is enough
+	uint32_t tail = atomic_load_explicit(&DS18B20_log.tail, memory_order_relaxed);
+	// Acquire pairs with the release of the producer: the records are complete
+	uint32_t head = atomic_load_explicit(&DS18B20_log.head, memory_order_acquire);
+
+	while (tail != head)
+	{
+		uint32_t words = 2U + ((DS18B20_log.words[tail & (DS18B20_LOG_SIZE - 1U)] >> 8) & 0xFFU);
+
+		if (length + (words * sizeof(uint32_t)) > size)
+		{
+			break; // The next record does not fit in the buffer
+		}
+
+		for (uint32_t i = 0; i < words; i++)
+		{
+			memcpy(&buffer[length], &DS18B20_log.words[tail++ & (DS18B20_LOG_SIZE - 1U)], sizeof(uint32_t));
+			length += sizeof(uint32_t);
+		}
+	}
+
+	// Release the words to the producer
+	atomic_store_explicit(&DS18B20_log.tail, tail, memory_order_release);
+
+	return length;
+}
+
+#endif /* DS18B20_LOG_DEFERRED */
+
+#endif /* DEBUG_DS18B20 */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,129 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_lowpower.c                                                                        */
+/*                                                                                           */
+/* Low-power waits for the DS18B20 conversions (Sleep or Stop mode)                          */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_lowpower.h"
+
+//!\ Between CONVERT_T and READ_SCRATCHPAD the MCU has nothing to do for up to 750 ms.
+//!\ These functions are meant to be set as conversion_wait hook of a DS18B20_t:
+//!\ - DS18B20_SleepWait enters Sleep mode (WFI) and is woken up by each SysTick interrupt.
+//!\ - DS18B20_StopWait enters Stop mode and is woken up by an LPTIM timeout. The system
+//!\   clock is restored and the HAL tick is advanced by the time spent in Stop mode,
+//!\   as counted by the LPTIM.
+//!\ In both cases the driver re-arms its microsecond timer when the hook returns.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static uint32_t DS18B20_LowPower_Counter(LPTIM_HandleTypeDef *hlptim);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Wait in Sleep mode, the SysTick interrupt wakes the core up every ms */
+void DS18B20_SleepWait(void *context, uint32_t ms)
+{
+	(void)context;
+	uint32_t start = HAL_GetTick();
+
+	while ((HAL_GetTick() - start) <= ms)
+	{
+		HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+	}
+}
+
+/* Wait in Stop mode, an LPTIM timeout wakes the MCU up */
+//!\ The LPTIM interrupt shall be enabled in the NVIC, and DS18B20_LowPower_WakeUp called
+//!\ from HAL_LPTIM_CompareMatchCallback. Other interrupts that wake the MCU up before the
+//!\ timeout run on the wake-up clock (HSI), the MCU then goes back to Stop mode.
+void DS18B20_StopWait(void *context, uint32_t ms)
+{
+	DS18B20_LowPower_t *low_power = (DS18B20_LowPower_t *)context;
+	uint32_t hz = low_power->lptim_clock_hz;
+	uint64_t remaining = ((uint64_t)(ms + 1U) * hz) / 1000U;	// LPTIM ticks left to wait
+	uint64_t slept = 0;											// LPTIM ticks spent in Stop mode
+	bool stopped = false;
+
+	// The LPTIM counter is 16-bit wide: a long wait, or a fast LPTIM clock, takes several periods
+	while (remaining > 0U)
+	{
+		uint32_t timeout = (remaining > DS18B20_LPTIM_TIMEOUT_MAX) ? DS18B20_LPTIM_TIMEOUT_MAX : (uint32_t)remaining;
+
+		low_power->wakeup = false;
+
+		if (HAL_LPTIM_TimeOut_Start_IT(low_power->hlptim, 0xFFFFU, timeout) != HAL_OK)
+		{
+			break;
+		}
+
+		if (stopped == false)
+		{
+			HAL_SuspendTick();
+			stopped = true;
+		}
+
+		while (low_power->wakeup == false)
+		{
+			HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+		}
+
+		// Time actually spent, wake-up latency included
+		uint32_t counter = DS18B20_LowPower_Counter(low_power->hlptim);
+		(void)HAL_LPTIM_TimeOut_Stop_IT(low_power->hlptim);
+
+		slept += counter;
+		remaining = (counter < remaining) ? (remaining - counter) : 0U;
+	}
+
+	if (stopped)
+	{
+		// The PLL is off when waking up from Stop mode
+		if (low_power->clock_restore != NULL)
+		{
+			low_power->clock_restore();
+		}
+
+		// SysTick was stopped: account for the time spent in Stop mode
+		uwTick += (uint32_t)((slept * 1000U) / hz);
+		HAL_ResumeTick();
+	}
+
+	if (hz == 0U)
+	{
+		DS18B20_SleepWait(NULL, ms); // LPTIM not configured: Sleep mode
+	}
+	else if (remaining > 0U)
+	{
+		DS18B20_SleepWait(NULL, (uint32_t)((remaining * 1000U) / hz)); // LPTIM not available: Sleep mode
+	}
+}
+
+/* Signal the end of the Stop mode wait, to be called from HAL_LPTIM_CompareMatchCallback */
+void DS18B20_LowPower_WakeUp(DS18B20_LowPower_t *low_power)
+{
+	low_power->wakeup = true;
+}
+
+/* Read the LPTIM counter, which runs on its own clock */
+//!\ The counter is read until two reads match, as the counter may change during a read.
+uint32_t DS18B20_LowPower_Counter(LPTIM_HandleTypeDef *hlptim)
+{
+	uint32_t counter = HAL_LPTIM_ReadCounter(hlptim);
+	uint32_t check = HAL_LPTIM_ReadCounter(hlptim);
+
+	while (counter != check)
+	{
+		counter = check;
+		check = HAL_LPTIM_ReadCounter(hlptim);
+	}
+
+	return counter;
+}
+
+/********************************** END OF FILE ******************************************** */
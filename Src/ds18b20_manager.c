@@ -0,0 +1,200 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_manager.c                                                                         */
+/*                                                                                           */
+/* Manager of several DS18B20 buses with overlapped conversions                              */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_manager.h"
+
+//!\ Each bus runs a cycle: broadcast conversion, wait, readout of its sensors.
+//!\ The buses are independent, so their conversions overlap: while a bus converts,
+//!\ the sensors of the buses whose conversion is over are read out. Only one sensor is
+//!\ read per poll, taking the buses in round robin, so that a conversion is started again
+//!\ on a bus as soon as its readout is over. The sweep time of N buses then tends to
+//!\ max(conversion time, sum of the readouts) instead of the sum of the cycles.
+//!\ A parasite-powered bus whose strong pull-up cannot supply all its sensors at once
+//!\ converts them one at a time, as DS18B20_Sweep does: each cycle is then a conversion
+//!\ and a readout per sensor. A bus with no presence pulse is tried again one conversion
+//!\ time later, not at every poll.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static void DS18B20_Manager_Update(DS18B20_Bus_t *bus);
+static void DS18B20_Manager_Readout(DS18B20_Manager_t *manager, uint8_t index);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Initialize the manager, all the buses start a conversion at the first poll */
+error_t DS18B20_Manager_Init(DS18B20_Manager_t *manager, DS18B20_Bus_t buses[], uint8_t bus_count,
+                             DS18B20_Ring_t *ring)
+{
+	error_t result = OK;
+
+	if ((manager == NULL) || (buses == NULL) || (ring == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		manager->buses = buses;
+		manager->bus_count = bus_count;
+		manager->current = 0;
+		manager->ring = ring;
+
+		for (uint8_t i = 0; i < bus_count; i++)
+		{
+			buses[i].state = DS18B20_BUS_IDLE;
+			buses[i].next_slot = 0;
+			buses[i].staggered = false;
+			buses[i].start_failed = false;
+			buses[i].conversion_status = DS18B20_SAMPLE_OK;
+			buses[i].cycle_time_ms = 0;
+			buses[i].cycles = 0;
+		}
+	}
+
+	return result;
+}
+
+/* Advance all the buses, and read out one sensor if a bus is ready */
+uint8_t DS18B20_Manager_Poll(DS18B20_Manager_t *manager)
+{
+	uint8_t result = 0;
+
+	// Start or end the conversions first: they cost a few ms of bus time at most
+	for (uint8_t i = 0; i < manager->bus_count; i++)
+	{
+		DS18B20_Manager_Update(&manager->buses[i]);
+	}
+
+	// Then read out one sensor of the next bus in readout state
+	for (uint8_t n = 1; (n <= manager->bus_count) && (result == 0); n++)
+	{
+		uint8_t index = (manager->current + n) % manager->bus_count;
+
+		if (manager->buses[index].state == DS18B20_BUS_READOUT)
+		{
+			DS18B20_Manager_Readout(manager, index);
+			manager->current = index;
+			result = 1;
+		}
+	}
+
+	return result;	// returns the number of sensors read
+}
+
+/* Start a conversion on an idle bus, or end it once its time is over */
+void DS18B20_Manager_Update(DS18B20_Bus_t *bus)
+{
+	uint32_t now = HAL_GetTick();
+
+	if ((bus->state == DS18B20_BUS_IDLE) && (bus->start_failed)
+		&& ((now - bus->conversion_start) <= DS18B20_ConversionTime(bus->sensor)))
+	{
+		// No sensor answered the last start: not yet time to try again
+	}
+	else if (bus->state == DS18B20_BUS_IDLE)
+	{
+		if (bus->start_failed)
+		{
+			DS18B20_STATS_ADD(bus->sensor->stats, retries, 1U);
+		}
+
+		if (bus->next_slot == 0U)
+		{
+			bus->cycle_start = now;
+			bus->staggered = DS18B20_Staggered(bus->sensor, bus->ROM_codes_array);
+		}
+
+		bus->conversion_start = now;
+		bus->conversion_status = DS18B20_SAMPLE_OK;
+
+		if (bus->staggered)
+		{
+			// Next sensor on its own, the readout skipped the free slots
+			while (bus->ROM_codes_array[bus->next_slot] == DS18B20_FREE_SLOT)
+			{
+				bus->next_slot++;
+			}
+
+			bus->start_failed = false;
+			bus->state = DS18B20_BUS_CONVERTING;
+
+			if (DS18B20_StartConversion(bus->sensor, bus->ROM_codes_array[bus->next_slot]) != 0)
+			{
+				// Only this sensor is missing: its sample is read out as such
+				bus->conversion_status = DS18B20_SAMPLE_NO_PRESENCE;
+				bus->conversion_end = now;
+				bus->state = DS18B20_BUS_READOUT;
+			}
+		}
+		else if (DS18B20_StartConversion(bus->sensor, 0ULL) == 0)
+		{
+			bus->start_failed = false;
+			bus->state = DS18B20_BUS_CONVERTING;
+		}
+		else
+		{
+			bus->start_failed = true; // No sensor answered
+		}
+	}
+	else if ((bus->state == DS18B20_BUS_CONVERTING)
+			 && ((now - bus->conversion_start) > DS18B20_ConversionTime(bus->sensor)))
+	{
+		bus->conversion_end = now;
+		bus->state = DS18B20_BUS_READOUT;
+	}
+}
+
+/* Read the next sensor of a bus and push its sample */
+void DS18B20_Manager_Readout(DS18B20_Manager_t *manager, uint8_t index)
+{
+	DS18B20_Bus_t *bus = &manager->buses[index];
+
+	// Nothing to read in the free slots
+	while (bus->ROM_codes_array[bus->next_slot] == DS18B20_FREE_SLOT)
+	{
+		bus->next_slot++;
+	}
+
+	if (bus->ROM_codes_array[bus->next_slot] != 0)
+	{
+		DS18B20_Sample_t sample = {0};
+		sample.timestamp = bus->conversion_end;
+		sample.slot = bus->next_slot;
+		sample.bus = index;
+		sample.status = bus->conversion_status;
+		DS18B20_ReadSample(bus->sensor, bus->ROM_codes_array[bus->next_slot], &sample);
+
+		(void)DS18B20_Ring_Push(manager->ring, &sample);
+
+		bus->next_slot++;
+
+		while (bus->ROM_codes_array[bus->next_slot] == DS18B20_FREE_SLOT)
+		{
+			bus->next_slot++;
+		}
+	}
+
+	// End of the cycle once the last sensor is read
+	if (bus->ROM_codes_array[bus->next_slot] == 0)
+	{
+		bus->cycle_time_ms = HAL_GetTick() - bus->cycle_start;
+		bus->cycles++;
+		DS18B20_STATS_HISTOGRAM(bus->sensor->stats, sweep_ms, bus->cycle_time_ms);
+		bus->next_slot = 0;
+		bus->state = DS18B20_BUS_IDLE;
+	}
+	else if (bus->staggered)
+	{
+		bus->state = DS18B20_BUS_IDLE; // The next sensor converts on its own
+	}
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,100 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_ring.c                                                                            */
+/*                                                                                           */
+/* Lock-free single-producer / single-consumer ring of DS18B20 samples                       */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_ring.h"
+
+//!\ The ring is wait-free for exactly one producer (the acquisition engine, in an
+//!\ interrupt or a task) and one consumer (the application). The indexes are free
+//!\ running 32-bit counters: the number of records in the ring is head - tail, and
+//!\ the position of a record is its counter masked by the size of the ring.
+//!\ Each side only writes its own index, and publishes it with a release store
+//!\ after the record has been written (producer) or read (consumer).
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Initialize a ring on a caller-provided buffer, whose size is a power of two */
+bool DS18B20_Ring_Init(DS18B20_Ring_t *ring, DS18B20_Sample_t buffer[], uint32_t size)
+{
+	bool result = false;
+
+	if ((ring != NULL) && (buffer != NULL) && (size != 0U) && ((size & (size - 1U)) == 0U))
+	{
+		atomic_init(&ring->head, 0U);
+		atomic_init(&ring->tail, 0U);
+		ring->buffer = buffer;
+		ring->mask = size - 1U;
+		ring->overruns = 0U;
+
+		result = true;
+	}
+
+	return result;
+}
+
+/* Push a sample into the ring (producer side) */
+bool DS18B20_Ring_Push(DS18B20_Ring_t *ring, const DS18B20_Sample_t *sample)
+{
+	bool result = false;
+
+	// Only the producer writes head, so a relaxed load is enough
+	uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	// Acquire pairs with the release of the consumer: the record is free to overwrite
+	uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+	if ((head - tail) <= ring->mask)
+	{
+		ring->buffer[head & ring->mask] = *sample;
+
+		// Publish the record to the consumer
+		atomic_store_explicit(&ring->head, head + 1U, memory_order_release);
+
+		result = true;
+	}
+	else
+	{
+		ring->overruns++; // Ring full: the newest sample is dropped
+	}
+
+	return result;
+}
+
+/* Pop the oldest sample from the ring (consumer side) */
+bool DS18B20_Ring_Pop(DS18B20_Ring_t *ring, DS18B20_Sample_t *sample)
+{
+	bool result = false;
+
+	// Only the consumer writes tail, so a relaxed load is enough
+	uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	// Acquire pairs with the release of the producer: the record is complete
+	uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+	if (head != tail)
+	{
+		*sample = ring->buffer[tail & ring->mask];
+
+		// Give the record back to the producer
+		atomic_store_explicit(&ring->tail, tail + 1U, memory_order_release);
+
+		result = true;
+	}
+
+	return result;
+}
+
+/* Number of samples waiting in the ring (approximate if called from a third context) */
+uint32_t DS18B20_Ring_Count(DS18B20_Ring_t *ring)
+{
+	uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+	uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+	return head - tail;
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,328 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_romtable.c                                                                        */
+/*                                                                                           */
+/* Table of ROM codes with stable handles and a sorted index for fast lookups                */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_romtable.h"
+
+#include <string.h>		// Required to use memmove
+
+//!\ The ROM codes are stored in handle order, so that a handle never changes while its
+//!\ sensor is in the table, and the index holds the handles sorted in search order:
+//!\ the search walks the bits of each byte LSB first, starting with the family byte.
+//!\ A lookup is a binary search in the index; an insertion or a removal moves the end of
+//!\ the index, which is done only when a sensor is plugged or unplugged.
+//!\ A compact table only keeps the 48-bit serial number of each sensor: 6 bytes instead
+//!\ of 8, for buses with a single family of sensors.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static uint64_t DS18B20_RomTable_Key(uint64_t ROM_code);
+static uint64_t DS18B20_RomTable_KeyOf(const DS18B20_RomTable_t *table, uint16_t handle);
+static bool DS18B20_RomTable_IsFree(const DS18B20_RomTable_t *table, uint16_t handle);
+static uint16_t DS18B20_RomTable_Position(const DS18B20_RomTable_t *table, uint64_t key);
+static void DS18B20_RomTable_Insert(DS18B20_RomTable_t *table, uint16_t handle);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Initialize a full table, the array may already hold the result of DS18B20_Search */
+//!\ ROM_codes shall have capacity + 1 entries. The codes before the first 0 are kept and
+//!\ get their index as handle; the other entries become free handles.
+error_t DS18B20_RomTable_Init(DS18B20_RomTable_t *table, uint64_t ROM_codes[], uint16_t index[],
+                              uint16_t capacity)
+{
+	error_t result = OK;
+
+	if ((table == NULL) || (ROM_codes == NULL) || (index == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else if (capacity == DS18B20_ROMTABLE_NONE)
+	{
+		result = ERROR_OTHER; // The last handle value is reserved
+	}
+	else
+	{
+		bool end = false;
+
+		table->ROM_codes = ROM_codes;
+		table->serials = NULL;
+		table->family = 0;
+		table->index = index;
+		table->capacity = capacity;
+		table->count = 0;
+
+		for (uint16_t handle = 0; handle < capacity; handle++)
+		{
+			end = (end) || (ROM_codes[handle] == 0ULL);
+
+			if ((end) || (ROM_codes[handle] == DS18B20_FREE_SLOT))
+			{
+				ROM_codes[handle] = DS18B20_FREE_SLOT;
+			}
+			else if (DS18B20_RomTable_Find(table, ROM_codes[handle]) != DS18B20_ROMTABLE_NONE)
+			{
+				ROM_codes[handle] = DS18B20_FREE_SLOT; // Duplicate
+			}
+			else
+			{
+				DS18B20_RomTable_Insert(table, handle);
+			}
+		}
+
+		ROM_codes[capacity] = 0ULL; // End of the array
+	}
+
+	return result;
+}
+
+/* Initialize an empty compact table for sensors of a single family */
+error_t DS18B20_RomTable_InitCompact(DS18B20_RomTable_t *table, uint8_t serials[][DS18B20_SERIAL_SIZE],
+                                     uint16_t index[], uint16_t capacity, uint8_t family)
+{
+	error_t result = OK;
+
+	if ((table == NULL) || (serials == NULL) || (index == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else if (capacity == DS18B20_ROMTABLE_NONE)
+	{
+		result = ERROR_OTHER; // The last handle value is reserved
+	}
+	else
+	{
+		table->ROM_codes = NULL;
+		table->serials = serials;
+		table->family = family;
+		table->index = index;
+		table->capacity = capacity;
+		table->count = 0;
+
+		// A free handle has an all-ones serial number
+		memset(serials, 0xFF, (size_t)capacity * DS18B20_SERIAL_SIZE);
+	}
+
+	return result;
+}
+
+/* Get the handle of a ROM code, DS18B20_ROMTABLE_NONE if it is not in the table */
+uint16_t DS18B20_RomTable_Find(const DS18B20_RomTable_t *table, uint64_t ROM_code)
+{
+	uint16_t result = DS18B20_ROMTABLE_NONE;
+	uint64_t key = DS18B20_RomTable_Key(ROM_code);
+	uint16_t position = DS18B20_RomTable_Position(table, key);
+
+	if ((table->serials != NULL) && ((uint8_t)(ROM_code >> 56) != table->family))
+	{
+		// Not a sensor of the family of the compact table
+	}
+	else if ((position < table->count) && (DS18B20_RomTable_KeyOf(table, table->index[position]) == key))
+	{
+		result = table->index[position];
+	}
+
+	return result;
+}
+
+/* Add a ROM code to the table, returns its handle or DS18B20_ROMTABLE_NONE if the table is full */
+//!\ A ROM code already in the table keeps its handle.
+uint16_t DS18B20_RomTable_Add(DS18B20_RomTable_t *table, uint64_t ROM_code)
+{
+	uint16_t result = DS18B20_RomTable_Find(table, ROM_code);
+
+	if ((result != DS18B20_ROMTABLE_NONE) || (table->count == table->capacity)
+		|| ((table->serials != NULL) && ((uint8_t)(ROM_code >> 56) != table->family))
+		|| (ROM_code == 0ULL) || (ROM_code == DS18B20_FREE_SLOT))
+	{
+		// Already in the table, no free handle, or not a ROM code the table can hold
+	}
+	else
+	{
+		// First free handle, so that the handles stay as low as possible
+		for (uint16_t handle = 0; (handle < table->capacity) && (result == DS18B20_ROMTABLE_NONE); handle++)
+		{
+			if (DS18B20_RomTable_IsFree(table, handle))
+			{
+				result = handle;
+			}
+		}
+
+		if (table->serials != NULL)
+		{
+			for (uint8_t i = 0; i < DS18B20_SERIAL_SIZE; i++)
+			{
+				// Bytes 1 to 6 of the ROM code, which is stored MSB first
+				table->serials[result][i] = (uint8_t)(ROM_code >> 8*(6-i));
+			}
+		}
+		else
+		{
+			table->ROM_codes[result] = ROM_code;
+		}
+
+		DS18B20_RomTable_Insert(table, result);
+	}
+
+	return result;
+}
+
+/* Remove a ROM code from the table, its handle becomes free */
+bool DS18B20_RomTable_Remove(DS18B20_RomTable_t *table, uint16_t handle)
+{
+	bool result = false;
+
+	if ((handle < table->capacity) && (DS18B20_RomTable_IsFree(table, handle) == false))
+	{
+		uint16_t position = DS18B20_RomTable_Position(table, DS18B20_RomTable_KeyOf(table, handle));
+
+		memmove(&table->index[position], &table->index[position + 1U],
+		        (size_t)(table->count - position - 1U) * sizeof(uint16_t));
+		table->count--;
+
+		if (table->serials != NULL)
+		{
+			memset(table->serials[handle], 0xFF, DS18B20_SERIAL_SIZE);
+		}
+		else
+		{
+			table->ROM_codes[handle] = DS18B20_FREE_SLOT;
+		}
+
+		result = true;
+	}
+
+	return result;	// returns true if the handle was used
+}
+
+/* Get the ROM code of a handle, DS18B20_FREE_SLOT if the handle is free */
+uint64_t DS18B20_RomTable_Get(const DS18B20_RomTable_t *table, uint16_t handle)
+{
+	uint64_t result = DS18B20_FREE_SLOT;
+
+	if ((handle >= table->capacity) || (DS18B20_RomTable_IsFree(table, handle)))
+	{
+		// Nothing stored
+	}
+	else if (table->serials != NULL)
+	{
+		uint8_t address[8];
+
+		address[0] = table->family;
+		memcpy(&address[1], table->serials[handle], DS18B20_SERIAL_SIZE);
+		address[7] = DS18B20_CRC(address, 7);
+
+		result = 0ULL;
+		for (uint8_t i = 0; i < 8; i++)
+		{
+			// ROM codes are stored MSB first
+			result |= (uint64_t)address[i] << 8*(7-i);
+		}
+	}
+	else
+	{
+		result = table->ROM_codes[handle];
+	}
+
+	return result;
+}
+
+/* Sort key of a ROM code: the order in which the search finds the devices */
+uint64_t DS18B20_RomTable_Key(uint64_t ROM_code)
+{
+	// Reverse the bits of each byte, the family byte staying the most significant.
+	// The CRC byte is left out, it only depends on the other bytes.
+	uint64_t key = ROM_code & ~0xFFULL;
+
+	key = ((key >> 1) & 0x5555555555555555ULL) | ((key & 0x5555555555555555ULL) << 1);
+	key = ((key >> 2) & 0x3333333333333333ULL) | ((key & 0x3333333333333333ULL) << 2);
+	key = ((key >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((key & 0x0F0F0F0F0F0F0F0FULL) << 4);
+
+	return key;
+}
+
+/* Sort key of the ROM code of a used handle */
+uint64_t DS18B20_RomTable_KeyOf(const DS18B20_RomTable_t *table, uint16_t handle)
+{
+	uint64_t ROM_code = 0ULL;
+
+	if (table->serials != NULL)
+	{
+		// The CRC is not part of the key, no need to compute it
+		ROM_code = (uint64_t)table->family << 56;
+
+		for (uint8_t i = 0; i < DS18B20_SERIAL_SIZE; i++)
+		{
+			ROM_code |= (uint64_t)table->serials[handle][i] << 8*(6-i);
+		}
+	}
+	else
+	{
+		ROM_code = table->ROM_codes[handle];
+	}
+
+	return DS18B20_RomTable_Key(ROM_code);
+}
+
+/* Tell if a handle holds no ROM code */
+bool DS18B20_RomTable_IsFree(const DS18B20_RomTable_t *table, uint16_t handle)
+{
+	bool result = true;
+
+	if (table->serials != NULL)
+	{
+		for (uint8_t i = 0; (i < DS18B20_SERIAL_SIZE) && (result); i++)
+		{
+			result = (table->serials[handle][i] == 0xFFU);
+		}
+	}
+	else
+	{
+		result = (table->ROM_codes[handle] == DS18B20_FREE_SLOT);
+	}
+
+	return result;
+}
+
+/* Position of the first entry of the index whose key is not lower than key */
+uint16_t DS18B20_RomTable_Position(const DS18B20_RomTable_t *table, uint64_t key)
+{
+	uint16_t low = 0;
+	uint16_t high = table->count;
+
+	while (low < high)
+	{
+		uint16_t middle = low + (uint16_t)((high - low) / 2U);
+
+		if (DS18B20_RomTable_KeyOf(table, table->index[middle]) < key)
+		{
+			low = middle + 1U;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+/* Insert a used handle in the index, at the position of its key */
+void DS18B20_RomTable_Insert(DS18B20_RomTable_t *table, uint16_t handle)
+{
+	uint16_t position = DS18B20_RomTable_Position(table, DS18B20_RomTable_KeyOf(table, handle));
+
+	memmove(&table->index[position + 1U], &table->index[position],
+	        (size_t)(table->count - position) * sizeof(uint16_t));
+	table->index[position] = handle;
+	table->count++;
+}
+
+/********************************** END OF FILE ******************************************** */
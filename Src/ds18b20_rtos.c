@@ -0,0 +1,360 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_rtos.c                                                                            */
+/*                                                                                           */
+/* FreeRTOS integration of the DS18B20 driver: one task owns the bus                         */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_rtos.h"
+
+//!\ Only the driver task talks to the bus, so the clients never block on the 1-Wire
+//!\ timings. During a conversion, the driver task sleeps with vTaskDelay and leaves the
+//!\ CPU to the other tasks instead of polling the bus: DS18B20_RTOS_Start sets this as
+//!\ conversion_wait hook of the bus, unless the application already set one.
+//!\ The bit slots are still timed by busy-waiting: give the driver task a priority high
+//!\ enough not to be preempted in the middle of a slot.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static void DS18B20_RTOS_Task(void *argument);
+static void DS18B20_RTOS_Delay(void *context, uint32_t ms);
+
+static void DS18B20_RTOS_Answer(const DS18B20_Request_t *request, uint16_t index, int16_t value, uint8_t status,
+                                uint8_t *result, int16_t *reply);
+static bool DS18B20_RTOS_ServeFromCache(DS18B20_Driver_t *driver, const DS18B20_Request_t *request, uint8_t *result,
+                                        int16_t *reply);
+static uint8_t DS18B20_RTOS_ServeRead(DS18B20_Driver_t *driver, const DS18B20_Request_t *request, int16_t *reply);
+static uint8_t DS18B20_RTOS_ServeConfig(DS18B20_Driver_t *driver, const DS18B20_Request_t *request);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Create the request queue and the driver task */
+error_t DS18B20_RTOS_Start(DS18B20_Driver_t *driver, UBaseType_t priority,
+                           configSTACK_DEPTH_TYPE stack_depth, UBaseType_t queue_length)
+{
+	error_t result = OK;
+
+	if ((driver == NULL) || (driver->sensor == NULL) || (driver->ROM_codes_array == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		driver->slot_count = 0;
+		atomic_init(&driver->sequence, 0U);
+		while (driver->ROM_codes_array[driver->slot_count] != 0)
+		{
+			driver->slot_count++;
+		}
+
+		if (driver->sensor->conversion_wait == NULL)
+		{
+			driver->sensor->conversion_wait = DS18B20_RTOS_Delay;
+		}
+
+		driver->queue = xQueueCreate(queue_length, sizeof(DS18B20_Request_t));
+
+		if ((driver->queue == NULL)
+			|| (xTaskCreate(DS18B20_RTOS_Task, "DS18B20", stack_depth, driver, priority, &driver->task) != pdPASS))
+		{
+			result = ERROR_OTHER; // Not enough FreeRTOS heap
+		}
+	}
+
+	return result;
+}
+
+/* Post a request to the driver task, the request is copied into the queue */
+BaseType_t DS18B20_RTOS_Post(DS18B20_Driver_t *driver, const DS18B20_Request_t *request, TickType_t timeout)
+{
+	return xQueueSend(driver->queue, request, timeout);
+}
+
+/* Read one sensor, and block the calling task until the result is available */
+//!\ The value comes back in the notification, so a request that times out never writes to
+//!\ the caller afterwards. Its late notification, or the one of an earlier request, is told
+//!\ apart by its sequence number and dropped. To read all the sensors at once, post a
+//!\ DS18B20_ALL_SLOTS request whose arrays outlive it.
+uint8_t DS18B20_RTOS_Read(DS18B20_Driver_t *driver, uint16_t slot, int16_t *value, TickType_t timeout)
+{
+	uint8_t result = DS18B20_SAMPLE_TIMEOUT;
+	uint32_t notification = 0;
+	TickType_t start = xTaskGetTickCount();
+
+	DS18B20_Request_t request = {0};
+	request.type = DS18B20_REQUEST_READ;
+	request.client = xTaskGetCurrentTaskHandle();
+	// Only has to differ from the last requests of this task, but the tasks share the counter
+	request.sequence = (uint16_t)((atomic_fetch_add_explicit(&driver->sequence, 1U, memory_order_relaxed) + 1U)
+	                              & DS18B20_RTOS_SEQUENCE_MASK);
+	request.slot = slot;
+
+	if ((slot == DS18B20_ALL_SLOTS) || (value == NULL))
+	{
+		result = DS18B20_SAMPLE_INVALID;
+	}
+	else if (DS18B20_RTOS_Post(driver, &request, timeout) == pdPASS)
+	{
+		bool waiting = true;
+
+		while (waiting)
+		{
+			TickType_t elapsed = xTaskGetTickCount() - start;
+			TickType_t remaining = (timeout == portMAX_DELAY) ? portMAX_DELAY
+			                     : ((elapsed < timeout) ? (timeout - elapsed) : 0U);
+
+			if (xTaskNotifyWait(0, UINT32_MAX, &notification, remaining) != pdTRUE)
+			{
+				waiting = false;	// Timeout
+			}
+			else if (DS18B20_RTOS_SEQUENCE(notification) == request.sequence)
+			{
+				*value = DS18B20_RTOS_VALUE(notification);
+				result = DS18B20_RTOS_STATUS(notification);
+				waiting = false;
+			}
+		}
+	}
+
+	return result;	// returns a DS18B20_SampleStatus_t
+}
+
+/* Driver task: serve the requests one after the other */
+void DS18B20_RTOS_Task(void *argument)
+{
+	DS18B20_Driver_t *driver = (DS18B20_Driver_t *)argument;
+	DS18B20_Request_t request;
+
+	for (;;)
+	{
+		if (xQueueReceive(driver->queue, &request, portMAX_DELAY) == pdPASS)
+		{
+			uint8_t status = DS18B20_SAMPLE_OK;
+			int16_t value = 0;
+
+			if ((request.slot != DS18B20_ALL_SLOTS) && (request.slot >= driver->slot_count))
+			{
+				status = DS18B20_SAMPLE_INVALID; // Not in the ROM codes array
+			}
+			else if (request.type == DS18B20_REQUEST_CONFIG)
+			{
+				status = DS18B20_RTOS_ServeConfig(driver, &request);
+			}
+			else
+			{
+				status = DS18B20_RTOS_ServeRead(driver, &request, &value);
+			}
+
+			if (request.client != NULL)
+			{
+				xTaskNotify(request.client, DS18B20_RTOS_NOTIFICATION(request.sequence, status, value),
+				            eSetValueWithOverwrite);
+			}
+		}
+	}
+}
+
+/* Sleep during a conversion, given as conversion_wait hook of the bus */
+void DS18B20_RTOS_Delay(void *context, uint32_t ms)
+{
+	(void)context;
+
+	// Round up so that the task never wakes up before the end of the conversion
+	vTaskDelay(pdMS_TO_TICKS(ms) + 1U);
+}
+
+/* Give the result of one sensor to the client of a read request */
+void DS18B20_RTOS_Answer(const DS18B20_Request_t *request, uint16_t index, int16_t value, uint8_t status,
+                         uint8_t *result, int16_t *reply)
+{
+	if (request->value != NULL)
+	{
+		request->value[index] = value;
+	}
+	if (request->status != NULL)
+	{
+		request->status[index] = status;
+	}
+
+	// The notification carries the first error met, if any, and the value of a single sensor
+	if (*result == DS18B20_SAMPLE_OK)
+	{
+		*result = status;
+	}
+	if (request->slot != DS18B20_ALL_SLOTS)
+	{
+		*reply = value;
+	}
+}
+
+/* Answer a read request from the cache, if all the addressed sensors are fresh */
+bool DS18B20_RTOS_ServeFromCache(DS18B20_Driver_t *driver, const DS18B20_Request_t *request, uint8_t *result,
+                                 int16_t *reply)
+{
+	bool hit = true;
+	uint16_t first = (request->slot == DS18B20_ALL_SLOTS) ? 0U : request->slot;
+	int16_t value = 0;
+	uint8_t status = DS18B20_SAMPLE_OK;
+
+	// Check first, so that a partial hit does not write anything
+	for (uint16_t slot = first; (hit) && (driver->ROM_codes_array[slot] != 0); slot++)
+	{
+		if (driver->ROM_codes_array[slot] != DS18B20_FREE_SLOT)
+		{
+			hit = DS18B20_Cache_Lookup(driver->cache, slot, &value, &status);
+		}
+
+		if (request->slot != DS18B20_ALL_SLOTS)
+		{
+			break; // Only one sensor requested
+		}
+	}
+
+	for (uint16_t slot = first; (hit) && (driver->ROM_codes_array[slot] != 0); slot++)
+	{
+		const DS18B20_CacheEntry_t *entry = &driver->cache->entries[slot];
+
+		if (driver->ROM_codes_array[slot] != DS18B20_FREE_SLOT)
+		{
+			DS18B20_RTOS_Answer(request, slot - first, entry->value, entry->status, result, reply);
+		}
+
+		if (request->slot != DS18B20_ALL_SLOTS)
+		{
+			break; // Only one sensor requested
+		}
+	}
+
+	// A partial hit is served by a conversion, and is not counted
+	if (hit)
+	{
+		driver->cache->hits++;
+	}
+
+	return hit;
+}
+
+/* Convert, sleep during the conversion, and read the addressed sensors */
+uint8_t DS18B20_RTOS_ServeRead(DS18B20_Driver_t *driver, const DS18B20_Request_t *request, int16_t *reply)
+{
+	uint8_t result = DS18B20_SAMPLE_OK;
+	uint64_t ROM_code = 0ULL;	// Broadcast when all the sensors are requested
+	uint16_t first = 0U;
+
+	// Without a cache, only the requested sensor is converted and read.
+	// With a cache, the whole bus is, so that the requests for the other sensors
+	// queued in the meantime are then served from the cache.
+	if ((request->slot != DS18B20_ALL_SLOTS) && (driver->cache == NULL))
+	{
+		ROM_code = driver->ROM_codes_array[request->slot];
+		first = request->slot;
+	}
+
+	if ((request->slot != DS18B20_ALL_SLOTS) && (driver->ROM_codes_array[request->slot] == DS18B20_FREE_SLOT))
+	{
+		// No sensor in this slot: nothing to convert
+		DS18B20_RTOS_Answer(request, 0, 0, DS18B20_SAMPLE_NO_PRESENCE, &result, reply);
+	}
+	else if ((driver->cache != NULL) && (DS18B20_RTOS_ServeFromCache(driver, request, &result, reply)))
+	{
+		// Served without touching the bus
+	}
+	else if (DS18B20_StartConversion(driver->sensor, ROM_code) != 0)
+	{
+		result = DS18B20_SAMPLE_NO_PRESENCE;
+	}
+	else
+	{
+		uint32_t start = HAL_GetTick();
+
+		// Sleeps with the conversion_wait hook set by DS18B20_RTOS_Start, if no other was set
+		(void)DS18B20_WaitConversion(driver->sensor, DS18B20_ConversionTime(driver->sensor));
+
+		uint32_t timestamp = HAL_GetTick();
+
+		for (uint16_t slot = first; driver->ROM_codes_array[slot] != 0; slot++)
+		{
+			if (driver->ROM_codes_array[slot] == DS18B20_FREE_SLOT)
+			{
+				continue; // Nothing to read in a free slot
+			}
+
+			DS18B20_Sample_t sample = {0};
+			sample.timestamp = timestamp;
+			sample.slot = slot;
+			DS18B20_ReadSample(driver->sensor, driver->ROM_codes_array[slot], &sample);
+
+			if (driver->cache != NULL)
+			{
+				DS18B20_Cache_Store(driver->cache, &sample);
+			}
+			if (driver->ring != NULL)
+			{
+				(void)DS18B20_Ring_Push(driver->ring, &sample);
+			}
+
+			if (request->slot == DS18B20_ALL_SLOTS)
+			{
+				DS18B20_RTOS_Answer(request, slot, sample.value, sample.status, &result, reply);
+			}
+			else if (slot == request->slot)
+			{
+				DS18B20_RTOS_Answer(request, 0, sample.value, sample.status, &result, reply);
+			}
+
+			if (ROM_code != 0ULL)
+			{
+				break; // Only one sensor converted
+			}
+		}
+
+		DS18B20_STATS_HISTOGRAM(driver->sensor->stats, sweep_ms, HAL_GetTick() - start);
+	}
+
+	return result;	// returns a DS18B20_SampleStatus_t
+}
+
+/* Write resolution and alarm registers of the addressed sensors */
+uint8_t DS18B20_RTOS_ServeConfig(DS18B20_Driver_t *driver, const DS18B20_Request_t *request)
+{
+	uint8_t result = DS18B20_SAMPLE_OK;
+	uint64_t ROM_code = 0ULL;	// Broadcast when all the sensors are requested
+
+	if (request->slot != DS18B20_ALL_SLOTS)
+	{
+		ROM_code = driver->ROM_codes_array[request->slot];
+	}
+
+	if ((request->resolution < 9U) || (request->resolution > 12U))
+	{
+		result = DS18B20_SAMPLE_INVALID; // Invalid request, nothing written
+	}
+	else if (ROM_code == DS18B20_FREE_SLOT)
+	{
+		result = DS18B20_SAMPLE_NO_PRESENCE; // No sensor in this slot
+	}
+	else if (DS18B20_WriteScratchpad(driver->sensor, ROM_code, request->th, request->tl,
+	                                 DS18B20_RESOLUTION_TO_CONFIG(request->resolution)) != 0)
+	{
+		result = DS18B20_SAMPLE_NO_PRESENCE;
+	}
+	else
+	{
+		// The conversion time of the bus is the one of its slowest sensor
+		uint8_t bus_resolution = (driver->sensor->resolution == 0U) ? 12U : driver->sensor->resolution;
+
+		if ((request->slot == DS18B20_ALL_SLOTS) || (request->resolution > bus_resolution))
+		{
+			driver->sensor->resolution = request->resolution;
+		}
+	}
+
+	return result;	// returns a DS18B20_SampleStatus_t
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,247 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_scheduler.c                                                                       */
+/*                                                                                           */
+/* Earliest-deadline-first scheduler of DS18B20 sensors with their own sampling periods      */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_scheduler.h"
+
+//!\ Each sensor is only converted and read when its period requires it. When the earliest
+//!\ deadline is reached, all the sensors due within batch_window_ms form a batch:
+//!\ - a large batch shares one broadcast conversion,
+//!\ - a small batch is converted sensor by sensor with MATCH_ROM. On an externally powered
+//!\   bus these conversions overlap, so the batch still waits for one conversion time only.
+//!\   Polling only answers for the sensor addressed last: the sensors are started by
+//!\   increasing resolution, so that the last one started is also the last one to finish.
+//!\ Only the sensors of the batch are read out. Their samples take the end of the conversion
+//!\ of the batch as timestamp, not the time of their readout.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static void DS18B20_Scheduler_Read(DS18B20_Scheduler_t *scheduler, uint16_t index, uint8_t status,
+                                   uint32_t timestamp);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Write the resolution of each sensor and make them all due */
+//!\ Nothing is written if a resolution is not 9 to 12 bits.
+error_t DS18B20_Scheduler_Init(DS18B20_Scheduler_t *scheduler)
+{
+	error_t result = OK;
+	uint8_t scratchpad[DS18B20_SCRATCHPAD_SIZE] = {0};
+
+	if ((scheduler == NULL) || (scheduler->sensor == NULL) || (scheduler->entries == NULL)
+		|| (scheduler->ring == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		for (uint16_t i = 0; i < scheduler->count; i++)
+		{
+			if ((scheduler->entries[i].resolution < 9U) || (scheduler->entries[i].resolution > 12U))
+			{
+				result = ERROR_OTHER; // Nothing is written
+			}
+		}
+	}
+
+	if (result == OK)
+	{
+		uint32_t now = HAL_GetTick();
+
+		for (uint16_t i = 0; i < scheduler->count; i++)
+		{
+			DS18B20_ScheduleEntry_t *entry = &scheduler->entries[i];
+
+			// Keep the alarm registers, only the resolution changes
+			if ((DS18B20_ReadScratchpad(scheduler->sensor, entry->ROM_code, scratchpad) != DS18B20_SAMPLE_OK)
+				|| (DS18B20_WriteScratchpad(scheduler->sensor, entry->ROM_code, scratchpad[2], scratchpad[3],
+				                            DS18B20_RESOLUTION_TO_CONFIG(entry->resolution)) != 0))
+			{
+				result = ERROR_OTHER; // The sensor keeps its previous resolution
+			}
+
+			entry->next_due = now;
+			entry->due = false;
+		}
+	}
+
+	return result;
+}
+
+/* Convert and read the sensors whose deadline is reached */
+//!\ Returns the number of ms until the next deadline, 0 if a batch was just served.
+uint32_t DS18B20_Scheduler_Run(DS18B20_Scheduler_t *scheduler)
+{
+	uint32_t result = UINT32_MAX;
+	uint32_t now = HAL_GetTick();
+
+	// Earliest deadline
+	for (uint16_t i = 0; i < scheduler->count; i++)
+	{
+		int32_t remaining = (int32_t)(scheduler->entries[i].next_due - now);
+		uint32_t wait = (remaining > 0) ? (uint32_t)remaining : 0U;
+
+		if (wait < result)
+		{
+			result = wait;
+		}
+	}
+
+	if (result == 0U)
+	{
+		// Build the batch
+		uint16_t batch = 0;
+		uint8_t batch_resolution = 9U;	// Highest resolution of the batch
+		uint8_t bus_resolution = 9U;	// Highest resolution of the bus
+
+		for (uint16_t i = 0; i < scheduler->count; i++)
+		{
+			DS18B20_ScheduleEntry_t *entry = &scheduler->entries[i];
+			int32_t remaining = (int32_t)(entry->next_due - now);
+
+			entry->due = (remaining <= (int32_t)scheduler->batch_window_ms);
+			entry->status = DS18B20_SAMPLE_INVALID;	// Until its conversion is started
+
+			if (entry->due)
+			{
+				batch++;
+				batch_resolution = (entry->resolution > batch_resolution) ? entry->resolution : batch_resolution;
+			}
+			bus_resolution = (entry->resolution > bus_resolution) ? entry->resolution : bus_resolution;
+		}
+
+		if (((batch * DS18B20_BROADCAST_RATIO) >= scheduler->count)
+			&& (DS18B20_GroupSize(scheduler->sensor) >= scheduler->count))
+		{
+			// One conversion for the whole bus, all the sensors convert
+			uint8_t status = DS18B20_SAMPLE_OK;
+
+			if (DS18B20_StartConversion(scheduler->sensor, 0ULL) != 0)
+			{
+				status = DS18B20_SAMPLE_NO_PRESENCE;
+			}
+			else if (DS18B20_WaitConversion(scheduler->sensor, DS18B20_ResolutionTime(bus_resolution)) != 0)
+			{
+				status = DS18B20_SAMPLE_TIMEOUT;
+			}
+
+			uint32_t end = HAL_GetTick();
+
+			for (uint16_t i = 0; i < scheduler->count; i++)
+			{
+				DS18B20_Scheduler_Read(scheduler, i, status, end);
+			}
+		}
+		else if (scheduler->sensor->parasite == false)
+		{
+			// Overlapping conversions of the sensors of the batch, the longest ones last
+			bool started = false;
+
+			for (uint8_t bits = 9U; bits <= 12U; bits++)
+			{
+				for (uint16_t i = 0; i < scheduler->count; i++)
+				{
+					DS18B20_ScheduleEntry_t *entry = &scheduler->entries[i];
+
+					if ((entry->due) && (entry->resolution == bits))
+					{
+						if (DS18B20_StartConversion(scheduler->sensor, entry->ROM_code) != 0)
+						{
+							entry->status = DS18B20_SAMPLE_NO_PRESENCE;
+						}
+						else
+						{
+							entry->status = DS18B20_SAMPLE_OK;
+							started = true;
+						}
+					}
+				}
+			}
+
+			// Polls the last sensor started, which has the highest resolution of those converting
+			uint8_t status = DS18B20_SAMPLE_OK;
+
+			if ((started) && (DS18B20_WaitConversion(scheduler->sensor, DS18B20_ResolutionTime(batch_resolution)) != 0))
+			{
+				status = DS18B20_SAMPLE_TIMEOUT;
+			}
+
+			uint32_t end = HAL_GetTick();
+
+			for (uint16_t i = 0; i < scheduler->count; i++)
+			{
+				DS18B20_ScheduleEntry_t *entry = &scheduler->entries[i];
+
+				DS18B20_Scheduler_Read(scheduler, i, (entry->status == DS18B20_SAMPLE_OK) ? status : entry->status,
+				                       end);
+			}
+		}
+		else
+		{
+			// Parasite power: the bus cannot be used while a sensor converts
+			for (uint16_t i = 0; i < scheduler->count; i++)
+			{
+				uint8_t status = DS18B20_SAMPLE_OK;
+
+				if (scheduler->entries[i].due)
+				{
+					if (DS18B20_StartConversion(scheduler->sensor, scheduler->entries[i].ROM_code) != 0)
+					{
+						status = DS18B20_SAMPLE_NO_PRESENCE;
+					}
+					else if (DS18B20_WaitConversion(scheduler->sensor,
+					                                DS18B20_ResolutionTime(scheduler->entries[i].resolution)) != 0)
+					{
+						status = DS18B20_SAMPLE_TIMEOUT;
+					}
+				}
+
+				DS18B20_Scheduler_Read(scheduler, i, status, HAL_GetTick());
+			}
+		}
+
+		DS18B20_STATS_HISTOGRAM(scheduler->sensor->stats, sweep_ms, HAL_GetTick() - now);
+	}
+
+	return result;
+}
+
+/* Read one sensor of the batch, push its sample and compute its next deadline */
+//!\ timestamp is the HAL tick (ms) of the end of the conversion of the sensor.
+void DS18B20_Scheduler_Read(DS18B20_Scheduler_t *scheduler, uint16_t index, uint8_t status,
+                            uint32_t timestamp)
+{
+	DS18B20_ScheduleEntry_t *entry = &scheduler->entries[index];
+
+	if (entry->due)
+	{
+		DS18B20_Sample_t sample = {0};
+		sample.timestamp = timestamp;
+		sample.slot = index;
+		sample.status = status;
+
+		// Nothing read if the conversion failed
+		DS18B20_ReadSample(scheduler->sensor, entry->ROM_code, &sample);
+
+		(void)DS18B20_Ring_Push(scheduler->ring, &sample);
+
+		// Keep the period without drift, unless the deadline was missed by a whole period
+		entry->next_due += entry->period_ms;
+		if ((int32_t)(entry->next_due - sample.timestamp) <= 0)
+		{
+			entry->next_due = sample.timestamp + entry->period_ms;
+		}
+
+		entry->due = false;
+	}
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,61 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_stats.c                                                                           */
+/*                                                                                           */
+/* Runtime counters and latency histograms of a DS18B20 bus                                  */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_stats.h"
+
+#include <string.h>		// Required to use memcpy and memset
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Clear the counters, before the statistics are given to a bus */
+void DS18B20_Stats_Init(DS18B20_Stats_t *stats)
+{
+	atomic_init(&stats->sequence, 0U);
+	memset(&stats->counters, 0, sizeof(stats->counters));
+}
+
+/* Copy the counters of a bus while it keeps running (reader side) */
+//!\ Returns false if the driver was updating the counters during every attempt. This
+//!\ happens if the reader preempts the driver in the middle of an update: the driver
+//!\ cannot resume before the reader returns, so the snapshot shall be tried again later.
+bool DS18B20_Stats_Snapshot(DS18B20_Stats_t *stats, DS18B20_Counters_t *snapshot)
+{
+	bool result = false;
+
+	for (uint8_t attempt = 0; (attempt < DS18B20_STATS_ATTEMPTS) && (result == false); attempt++)
+	{
+		// Acquire pairs with the release of DS18B20_Stats_End: the counters are complete
+		uint32_t before = atomic_load_explicit(&stats->sequence, memory_order_acquire);
+
+		if ((before & 1U) == 0U)
+		{
+			memcpy(snapshot, &stats->counters, sizeof(*snapshot));
+
+			// The copy is done before the sequence is read again
+			atomic_thread_fence(memory_order_acquire);
+
+			result = (atomic_load_explicit(&stats->sequence, memory_order_relaxed) == before);
+		}
+	}
+
+	return result;
+}
+
+/* Nominal time the bus spent in resets, bytes and search bits, in µs */
+//!\ Compared to busy_wait_ms, this tells whether a slow bus has too many sensors (bus
+//!\ time) or is waiting for its conversions with the CPU spinning (busy-wait time).
+uint64_t DS18B20_Stats_BusTime(const DS18B20_Counters_t *counters)
+{
+	return ((uint64_t)counters->resets * DS18B20_STATS_RESET_US)
+		   + (((uint64_t)counters->bytes_written + counters->bytes_read) * DS18B20_STATS_BYTE_US)
+		   + ((uint64_t)counters->search_bits * DS18B20_STATS_SEARCH_BIT_US);
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,238 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_telemetry.c                                                                       */
+/*                                                                                           */
+/* Binary telemetry frames of DS18B20 samples, sent through a UART with DMA                  */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_telemetry.h"
+
+//!\ A sample costs 7 bytes instead of about 30 as text, and the CPU only builds the frames:
+//!\ the DMA sends them. The samples are added by the acquisition context, the frames are
+//!\ started by this context or by the transfer complete interrupt, whichever comes last.
+//!\ The busy flag is taken by an atomic exchange, so only one of them starts the DMA.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static void DS18B20_Telemetry_Close(DS18B20_Telemetry_t *telemetry);
+static void DS18B20_Telemetry_Start(DS18B20_Telemetry_t *telemetry);
+static void DS18B20_Telemetry_Put16(uint8_t data[], uint16_t value);
+static void DS18B20_Telemetry_Put32(uint8_t data[], uint32_t value);
+static uint32_t DS18B20_Telemetry_Get32(const uint8_t data[]);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Initialize the telemetry of a UART, whose DMA is already configured */
+error_t DS18B20_Telemetry_Init(DS18B20_Telemetry_t *telemetry, UART_HandleTypeDef *huart)
+{
+	error_t result = OK;
+
+	if ((telemetry == NULL) || (huart == NULL))
+	{
+		result = NULL_POINTER;
+	}
+	else
+	{
+		telemetry->huart = huart;
+		telemetry->filling = 0;
+		telemetry->count = 0;
+		telemetry->sequence = 0;
+		telemetry->frames = 0;
+		telemetry->overruns = 0;
+
+		atomic_init(&telemetry->ready, false);
+		atomic_init(&telemetry->busy, false);
+	}
+
+	return result;
+}
+
+/* Add a sample to the current frame, given as DS18B20_Deliver_t to DS18B20_Sweep */
+//!\ The frame is sent once it is full, or when a sample arrives out of its time window:
+//!\ more than DS18B20_TELEMETRY_WINDOW_MS after its first sample, or before it.
+void DS18B20_Telemetry_Deliver(void *context, const DS18B20_Sample_t *sample)
+{
+	DS18B20_Telemetry_t *telemetry = (DS18B20_Telemetry_t *)context;
+	uint8_t *frame = NULL;
+
+	// Frame of an older window in the filling buffer
+	if ((atomic_load_explicit(&telemetry->ready, memory_order_acquire) == false) && (telemetry->count != 0))
+	{
+		frame = telemetry->buffers[telemetry->filling];
+
+		uint32_t timestamp = DS18B20_Telemetry_Get32(&frame[6]);
+
+		// An earlier sample wraps to a large delta
+		if ((sample->timestamp - timestamp) > DS18B20_TELEMETRY_WINDOW_MS)
+		{
+			DS18B20_Telemetry_Close(telemetry);
+		}
+	}
+
+	// A complete frame may still wait for the DMA, e.g. after a failed start
+	if (atomic_load_explicit(&telemetry->ready, memory_order_acquire))
+	{
+		DS18B20_Telemetry_Start(telemetry);
+	}
+
+	if (atomic_load_explicit(&telemetry->ready, memory_order_acquire))
+	{
+		telemetry->overruns++; // Both buffers are in use, the host cannot keep up
+	}
+	else
+	{
+		frame = telemetry->buffers[telemetry->filling];
+
+		if (telemetry->count == 0)
+		{
+			DS18B20_Telemetry_Put32(&frame[6], sample->timestamp);
+		}
+
+		uint8_t *entry = &frame[DS18B20_TELEMETRY_HEADER_SIZE + (telemetry->count * DS18B20_TELEMETRY_ENTRY_SIZE)];
+		uint32_t timestamp = DS18B20_Telemetry_Get32(&frame[6]);
+
+		DS18B20_Telemetry_Put16(&entry[0], sample->slot);
+		DS18B20_Telemetry_Put16(&entry[2], (uint16_t)sample->value);
+		entry[4] = (uint8_t)((sample->bus << 4) | (sample->status & 0x0FU));
+		DS18B20_Telemetry_Put16(&entry[5], (uint16_t)(sample->timestamp - timestamp));
+
+		telemetry->count++;
+
+		if (telemetry->count == DS18B20_TELEMETRY_ENTRIES)
+		{
+			DS18B20_Telemetry_Close(telemetry);
+		}
+	}
+}
+
+/* Send the current frame now, even if it is not full */
+uint8_t DS18B20_Telemetry_Flush(DS18B20_Telemetry_t *telemetry)
+{
+	if ((atomic_load_explicit(&telemetry->ready, memory_order_acquire) == false) && (telemetry->count != 0))
+	{
+		DS18B20_Telemetry_Close(telemetry);
+	}
+	else if (atomic_load_explicit(&telemetry->ready, memory_order_acquire))
+	{
+		DS18B20_Telemetry_Start(telemetry);
+	}
+
+	// returns 0 if the frame is sent or empty, 1 if it still waits for the DMA
+	return atomic_load_explicit(&telemetry->ready, memory_order_acquire) ? 1U : 0U;
+}
+
+/* End of a transfer, to be called from HAL_UART_TxCpltCallback */
+void DS18B20_Telemetry_TxComplete(DS18B20_Telemetry_t *telemetry, UART_HandleTypeDef *huart)
+{
+	if (huart == telemetry->huart)
+	{
+		atomic_store_explicit(&telemetry->busy, false, memory_order_release);
+
+		// The next frame was completed during the transfer
+		if (atomic_load_explicit(&telemetry->ready, memory_order_acquire))
+		{
+			DS18B20_Telemetry_Start(telemetry);
+		}
+	}
+}
+
+/* Compute the CRC16 of a frame (CCITT polynomial 0x1021, initial value 0xFFFF) */
+uint16_t DS18B20_Telemetry_CRC(const uint8_t data[], uint16_t length)
+{
+	uint16_t crc = 0xFFFFU;
+
+	for (uint16_t i = 0; i < length; i++)
+	{
+		crc ^= (uint16_t)data[i] << 8;
+
+		for (uint8_t bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+/* Write the header and the CRC of the filling buffer, and send it if the DMA is free */
+void DS18B20_Telemetry_Close(DS18B20_Telemetry_t *telemetry)
+{
+	uint8_t *frame = telemetry->buffers[telemetry->filling];
+	uint16_t length = (uint16_t)(DS18B20_TELEMETRY_HEADER_SIZE - 4U + (telemetry->count * DS18B20_TELEMETRY_ENTRY_SIZE));
+
+	frame[0] = DS18B20_TELEMETRY_SYNC0;
+	frame[1] = DS18B20_TELEMETRY_SYNC1;
+	DS18B20_Telemetry_Put16(&frame[2], length);
+	DS18B20_Telemetry_Put16(&frame[4], telemetry->sequence);
+	frame[10] = telemetry->count;
+
+	// From the length to the last entry
+	DS18B20_Telemetry_Put16(&frame[4U + length], DS18B20_Telemetry_CRC(&frame[2], (uint16_t)(length + 2U)));
+
+	telemetry->sequence++;
+
+	// Release pairs with the acquire of DS18B20_Telemetry_Start: the frame is complete
+	atomic_store_explicit(&telemetry->ready, true, memory_order_release);
+
+	DS18B20_Telemetry_Start(telemetry);
+}
+
+/* Send the complete frame if the DMA is free, and swap the buffers */
+void DS18B20_Telemetry_Start(DS18B20_Telemetry_t *telemetry)
+{
+	// Only the winner of the exchange starts a transfer
+	if (atomic_exchange_explicit(&telemetry->busy, true, memory_order_acq_rel) == false)
+	{
+		bool sent = false;
+
+		if (atomic_load_explicit(&telemetry->ready, memory_order_acquire))
+		{
+			uint8_t *frame = telemetry->buffers[telemetry->filling];
+			uint16_t size = (uint16_t)(DS18B20_TELEMETRY_HEADER_SIZE + DS18B20_TELEMETRY_CRC_SIZE
+			                           + (telemetry->count * DS18B20_TELEMETRY_ENTRY_SIZE));
+
+			if (HAL_UART_Transmit_DMA(telemetry->huart, frame, size) == HAL_OK)
+			{
+				telemetry->filling ^= 1U;
+				telemetry->count = 0;
+				telemetry->frames++;
+				sent = true;
+
+				// The other buffer is free for the samples
+				atomic_store_explicit(&telemetry->ready, false, memory_order_release);
+			}
+		}
+
+		if (sent == false)
+		{
+			atomic_store_explicit(&telemetry->busy, false, memory_order_release);
+		}
+	}
+}
+
+/* Store a 16-bit value, little-endian */
+void DS18B20_Telemetry_Put16(uint8_t data[], uint16_t value)
+{
+	data[0] = (uint8_t)value;
+	data[1] = (uint8_t)(value >> 8);
+}
+
+/* Store a 32-bit value, little-endian */
+void DS18B20_Telemetry_Put32(uint8_t data[], uint32_t value)
+{
+	DS18B20_Telemetry_Put16(&data[0], (uint16_t)value);
+	DS18B20_Telemetry_Put16(&data[2], (uint16_t)(value >> 16));
+}
+
+/* Read a 32-bit value, little-endian */
+uint32_t DS18B20_Telemetry_Get32(const uint8_t data[])
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/********************************** END OF FILE ******************************************** */
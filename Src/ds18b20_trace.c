@@ -0,0 +1,52 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* DS18B20_trace.c                                                                           */
+/*                                                                                           */
+/* Optional trace of the 1-Wire bus transactions, with timer timestamps                      */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "ds18b20_trace.h"
+
+#ifdef DS18B20_TRACE
+
+#include <stdio.h>		// Required to use printf
+
+//!\ The records are printed through the console, one per line, and can be converted
+//!\ to a VCD file for GTKWave with Tools/ds18b20_trace2vcd.py.
+
+// Shared by all the buses, the records are tagged with the bus_id of their bus
+DS18B20_Trace_t DS18B20_trace;
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Print the records of the ring, oldest first */
+void DS18B20_Trace_Dump(void)
+{
+	uint32_t head = DS18B20_trace.head;
+	uint32_t first = (head > DS18B20_TRACE_SIZE) ? (head - DS18B20_TRACE_SIZE) : 0U;
+
+	printf("DS18B20 trace: %lu records, %lu lost\n\r", (unsigned long)(head - first), (unsigned long)first);
+
+	for (uint32_t i = first; i != head; i++)
+	{
+		const DS18B20_TraceRecord_t *record = &DS18B20_trace.records[i & (DS18B20_TRACE_SIZE - 1U)];
+
+		// timestamp bus type data
+		printf("%08lx %u %u %04x\n\r", (unsigned long)record->timestamp, record->bus, record->type, record->data);
+	}
+
+	printf("DS18B20 trace end\n\r");
+}
+
+/* Empty the ring */
+void DS18B20_Trace_Clear(void)
+{
+	DS18B20_trace.head = 0;
+}
+
+#endif /* DS18B20_TRACE */
+
+/********************************** END OF FILE ******************************************** */
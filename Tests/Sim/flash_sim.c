@@ -0,0 +1,226 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* flash_sim.c                                                                               */
+/*                                                                                           */
+/* Host emulator of a NOR flash in RAM or in a file, with power cuts, for DS18B20_Flash_t    */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <string.h>
+
+#include "flash_sim.h"
+
+//!\ A cut flash word gets some of its bits programmed, the others stay erased. A cut erase
+//!\ sets some of the words of the sector back to 0xFF and leaves the others as they were.
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static uint32_t Sim_FlashRandom(Sim_Flash_t *flash);
+static bool Sim_FlashCut(Sim_Flash_t *flash);
+static void Sim_FlashSave(Sim_Flash_t *flash, uint32_t address, uint32_t length);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Start with an erased memory, powered */
+void Sim_FlashInit(Sim_Flash_t *flash, uint8_t memory[], uint32_t sector_size, uint16_t sector_count)
+{
+	memset(flash, 0, sizeof(*flash));
+	flash->memory = memory;
+	flash->sector_size = sector_size;
+	flash->sector_count = sector_count;
+	flash->seed = 1U;
+
+	memset(memory, 0xFF, (size_t)sector_size * sector_count);
+	Sim_FlashPowerOn(flash, SIM_FLASH_NO_CUT);
+}
+
+/* Start with the memory kept in a file, or an erased one if the file is missing or of another size */
+bool Sim_FlashOpen(Sim_Flash_t *flash, uint8_t memory[], uint32_t sector_size, uint16_t sector_count,
+                   const char *name)
+{
+	size_t size = (size_t)sector_size * sector_count;
+
+	Sim_FlashInit(flash, memory, sector_size, sector_count);
+
+	flash->file = fopen(name, "r+b");
+	if ((flash->file != NULL) && ((fseek(flash->file, 0, SEEK_END) != 0) || (ftell(flash->file) != (long)size)
+		|| (fseek(flash->file, 0, SEEK_SET) != 0) || (fread(memory, 1, size, flash->file) != size)))
+	{
+		// Another geometry: the memory is erased
+		fclose(flash->file);
+		flash->file = NULL;
+		memset(memory, 0xFF, size);
+	}
+
+	if (flash->file == NULL)
+	{
+		flash->file = fopen(name, "w+b");
+		Sim_FlashSave(flash, 0, (uint32_t)size);
+	}
+
+	return (flash->file != NULL);	// returns false if the file cannot be written
+}
+
+/* Close the file of the memory, which keeps its content */
+void Sim_FlashClose(Sim_Flash_t *flash)
+{
+	if (flash->file != NULL)
+	{
+		fclose(flash->file);
+		flash->file = NULL;
+	}
+}
+
+/* Power the flash again, the next cut after cut flash words or erases */
+void Sim_FlashPowerOn(Sim_Flash_t *flash, uint32_t cut)
+{
+	flash->powered = true;
+	flash->cut = cut;
+}
+
+uint8_t Sim_FlashRead(void *context, uint32_t address, uint8_t data[], uint32_t length)
+{
+	Sim_Flash_t *flash = (Sim_Flash_t *)context;
+	uint8_t result = 1;
+
+	if ((flash->powered) && (address <= (flash->sector_size * flash->sector_count))
+		&& (length <= ((flash->sector_size * flash->sector_count) - address)))
+	{
+		memcpy(data, &flash->memory[address], length);
+		result = 0;
+	}
+
+	return result;
+}
+
+uint8_t Sim_FlashProgram(void *context, uint32_t address, const uint8_t data[], uint32_t length)
+{
+	Sim_Flash_t *flash = (Sim_Flash_t *)context;
+	uint8_t result = 0;
+
+	if ((!flash->powered) || (flash->fail_program) || ((address % SIM_FLASH_WORD_SIZE) != 0U)
+		|| ((length % SIM_FLASH_WORD_SIZE) != 0U) || (address > (flash->sector_size * flash->sector_count))
+		|| (length > ((flash->sector_size * flash->sector_count) - address)))
+	{
+		result = 1;
+	}
+
+	for (uint32_t offset = 0; (offset < length) && (result == 0U); offset += SIM_FLASH_WORD_SIZE)
+	{
+		uint8_t *word = &flash->memory[address + offset];
+
+		for (uint32_t i = 0; i < SIM_FLASH_WORD_SIZE; i++)
+		{
+			// A word is programmed once: the ECC of the STM32H7 forbids a second time
+			if (word[i] != 0xFFU)
+			{
+				result = 1;
+			}
+		}
+
+		if (result != 0U)
+		{
+			// Not programmed
+		}
+		else if (Sim_FlashCut(flash))
+		{
+			for (uint32_t i = 0; i < SIM_FLASH_WORD_SIZE; i++)
+			{
+				word[i] = (uint8_t)(data[offset + i] | (uint8_t)Sim_FlashRandom(flash));
+			}
+			result = 1;
+		}
+		else
+		{
+			memcpy(word, &data[offset], SIM_FLASH_WORD_SIZE);
+		}
+
+		// A word damaged by a cut is kept as it is, like on the chip
+		Sim_FlashSave(flash, address + offset, SIM_FLASH_WORD_SIZE);
+	}
+
+	flash->programs++;
+
+	return result;
+}
+
+uint8_t Sim_FlashErase(void *context, uint16_t sector)
+{
+	Sim_Flash_t *flash = (Sim_Flash_t *)context;
+	uint8_t result = 0;
+
+	if ((!flash->powered) || (sector >= flash->sector_count))
+	{
+		result = 1;
+	}
+	else
+	{
+		uint8_t *memory = &flash->memory[sector * flash->sector_size];
+
+		if (Sim_FlashCut(flash))
+		{
+			for (uint32_t offset = 0; offset < flash->sector_size; offset += SIM_FLASH_WORD_SIZE)
+			{
+				if ((Sim_FlashRandom(flash) & 1U) != 0U)
+				{
+					memset(&memory[offset], 0xFF, SIM_FLASH_WORD_SIZE);
+				}
+			}
+			result = 1;
+		}
+		else
+		{
+			memset(memory, 0xFF, flash->sector_size);
+		}
+
+		Sim_FlashSave(flash, sector * flash->sector_size, flash->sector_size);
+		flash->erases++;
+	}
+
+	return result;
+}
+
+/* Pseudo-random number, the same on every host */
+uint32_t Sim_FlashRandom(Sim_Flash_t *flash)
+{
+	flash->seed = (flash->seed * 1103515245U) + 12345U;
+
+	return flash->seed >> 16;
+}
+
+/* Count an operation, returns true if the power is cut during it */
+bool Sim_FlashCut(Sim_Flash_t *flash)
+{
+	bool result = false;
+
+	if (flash->cut == 0U)
+	{
+		flash->powered = false;
+		flash->cuts++;
+		result = true;
+	}
+	else if (flash->cut != SIM_FLASH_NO_CUT)
+	{
+		flash->cut--;
+	}
+
+	return result;
+}
+
+/* Write a range of the memory through to its file, if any */
+void Sim_FlashSave(Sim_Flash_t *flash, uint32_t address, uint32_t length)
+{
+	if ((flash->file != NULL) && ((fseek(flash->file, (long)address, SEEK_SET) != 0)
+		|| (fwrite(&flash->memory[address], 1, length, flash->file) != length) || (fflush(flash->file) != 0)))
+	{
+		// The file no longer follows the memory
+		fclose(flash->file);
+		flash->file = NULL;
+	}
+}
+
+/********************************** END OF FILE ******************************************** */
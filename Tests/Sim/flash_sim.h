@@ -0,0 +1,84 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* flash_sim.h                                                                               */
+/*                                                                                           */
+/* Host emulator of a NOR flash in RAM or in a file, with power cuts, for DS18B20_Flash_t    */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef TESTS_SIM_FLASH_SIM_H_
+// Header guard to prevent multiple inclusions
+#define TESTS_SIM_FLASH_SIM_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+//!\ The memory behaves as the internal flash of the STM32H7: it is programmed by flash
+//!\ words of 32 bytes, a word is programmed once between two erases, and an erased byte
+//!\ reads 0xFF. A power cut ends the flash word or the erase in progress half done, then
+//!\ every operation fails until Sim_FlashPowerOn.
+//!\ Opened with Sim_FlashOpen, the memory is also kept in a file: every program and erase,
+//!\ a cut one included, is written through to it, so the log survives the process.
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define SIM_FLASH_WORD_SIZE		32U
+
+// No power cut planned
+#define SIM_FLASH_NO_CUT		UINT32_MAX
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Emulated flash, context of the Sim_FlashXxx functions */
+typedef struct
+{
+	uint8_t *memory;			// sector_size * sector_count bytes
+	uint32_t sector_size;
+	uint16_t sector_count;
+	FILE *file;					// Copy of the memory, NULL if the flash is in RAM only
+
+	uint32_t cut;				// Flash words programmed or sectors erased until the power cut
+	bool powered;				// False after a power cut
+	bool fail_program;			// Every program fails, the memory is not changed
+	uint32_t seed;				// State of the random damage of a power cut
+
+	// Statistics
+	uint32_t programs;			// Program operations done
+	uint32_t erases;			// Sector erases done
+	uint32_t cuts;				// Power cuts
+
+} Sim_Flash_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+void Sim_FlashInit(Sim_Flash_t *flash, uint8_t memory[], uint32_t sector_size, uint16_t sector_count);
+
+bool Sim_FlashOpen(Sim_Flash_t *flash, uint8_t memory[], uint32_t sector_size, uint16_t sector_count,
+                   const char *name);
+
+void Sim_FlashClose(Sim_Flash_t *flash);
+
+void Sim_FlashPowerOn(Sim_Flash_t *flash, uint32_t cut);
+
+uint8_t Sim_FlashRead(void *context, uint32_t address, uint8_t data[], uint32_t length);
+
+uint8_t Sim_FlashProgram(void *context, uint32_t address, const uint8_t data[], uint32_t length);
+
+uint8_t Sim_FlashErase(void *context, uint16_t sector);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* TESTS_SIM_FLASH_SIM_H_ */
+
+/********************************** END OF FILE ******************************************** */
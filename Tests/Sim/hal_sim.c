@@ -0,0 +1,162 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* hal_sim.c                                                                                 */
+/*                                                                                           */
+/* Host stand-in for the low-power, LPTIM, UART and flash functions of the HAL               */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include "hal_sim.h"
+#include "onewire_sim.h"
+
+#include <string.h>
+
+//!\ The LPTIM counts the virtual time of the 1-Wire simulator at Sim_LptimHz. Stop mode
+//!\ lets the virtual time run up to the compare match, plus Sim_WakeupTicks of wake-up
+//!\ latency, then calls Sim_OnLptimMatch as the interrupt would. Sleep mode lasts 1 ms,
+//!\ until the next SysTick interrupt.
+//!\ A UART transfer reads its buffer when it ends, in Sim_UartComplete, as the DMA would
+//!\ read it during the transfer: a buffer changed while it is sent shows in the capture.
+
+uint32_t Sim_LptimHz;
+uint32_t Sim_WakeupTicks;
+void (*Sim_OnLptimMatch)(void);
+uint32_t Sim_StopPeriods;
+uint8_t Sim_UartCapture[SIM_UART_CAPTURE_SIZE];
+uint32_t Sim_UartLength;
+
+static bool sim_lptim_running;
+static uint64_t sim_lptim_start;
+static uint32_t sim_lptim_timeout;
+static const uint8_t *sim_uart_data;
+static uint16_t sim_uart_size;
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+void HAL_PWR_EnterSLEEPMode(uint32_t regulator, uint8_t entry)
+{
+	(void)regulator;
+	(void)entry;
+
+	Sim_Advance(1000U);
+}
+
+void HAL_PWR_EnterSTOPMode(uint32_t regulator, uint8_t entry)
+{
+	(void)regulator;
+	(void)entry;
+
+	if (sim_lptim_running && (Sim_LptimHz != 0U))
+	{
+		uint64_t ticks = (uint64_t)sim_lptim_timeout + Sim_WakeupTicks;
+		uint64_t wakeup = sim_lptim_start + (((ticks * 1000000U) + Sim_LptimHz - 1U) / Sim_LptimHz);
+
+		if (Sim_Micros() < wakeup)
+		{
+			Sim_Advance(wakeup - Sim_Micros());
+		}
+
+		Sim_StopPeriods++;
+		if (Sim_OnLptimMatch != NULL)
+		{
+			Sim_OnLptimMatch();
+		}
+	}
+}
+
+HAL_StatusTypeDef HAL_LPTIM_TimeOut_Start_IT(LPTIM_HandleTypeDef *handle, uint32_t period, uint32_t timeout)
+{
+	HAL_StatusTypeDef result = HAL_ERROR;
+	(void)period;
+
+	if ((handle != NULL) && (timeout <= 0xFFFFU))
+	{
+		sim_lptim_running = true;
+		sim_lptim_start = Sim_Micros();
+		sim_lptim_timeout = timeout;
+		result = HAL_OK;
+	}
+
+	return result;
+}
+
+HAL_StatusTypeDef HAL_LPTIM_TimeOut_Stop_IT(LPTIM_HandleTypeDef *handle)
+{
+	(void)handle;
+	sim_lptim_running = false;
+
+	return HAL_OK;
+}
+
+uint32_t HAL_LPTIM_ReadCounter(const LPTIM_HandleTypeDef *handle)
+{
+	(void)handle;
+
+	// Free-running up to 0xFFFF, then back to 0
+	return (uint32_t)((((Sim_Micros() - sim_lptim_start) * Sim_LptimHz) / 1000000U) & 0xFFFFU);
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *handle, const uint8_t *data, uint16_t size)
+{
+	HAL_StatusTypeDef result = HAL_ERROR;
+
+	if (sim_uart_data != NULL)
+	{
+		result = HAL_BUSY;
+	}
+	else if ((handle != NULL) && (data != NULL) && (size != 0U)
+	         && ((Sim_UartLength + size) <= SIM_UART_CAPTURE_SIZE))
+	{
+		sim_uart_data = data;
+		sim_uart_size = size;
+		result = HAL_OK;
+	}
+
+	return result;
+}
+
+bool Sim_UartComplete(void)
+{
+	bool result = false;
+
+	if (sim_uart_data != NULL)
+	{
+		memcpy(&Sim_UartCapture[Sim_UartLength], sim_uart_data, sim_uart_size);
+		Sim_UartLength += sim_uart_size;
+		sim_uart_data = NULL;
+		result = true;
+	}
+
+	return result;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t type, uint32_t address, uint32_t data)
+{
+	(void)type;
+	(void)address;
+	(void)data;
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *init, uint32_t *error)
+{
+	(void)init;
+	(void)error;
+
+	return HAL_ERROR;
+}
+
+/********************************** END OF FILE ******************************************** */
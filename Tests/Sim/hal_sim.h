@@ -0,0 +1,33 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* hal_sim.h                                                                                 */
+/*                                                                                           */
+/* Host stand-in for the low-power, LPTIM, UART and flash functions of the HAL               */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef TESTS_SIM_HAL_SIM_H_
+// Header guard to prevent multiple inclusions
+#define TESTS_SIM_HAL_SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "stm32h7xx_hal.h"
+
+#define SIM_UART_CAPTURE_SIZE	(256U * 1024U)
+
+extern uint32_t Sim_LptimHz;			// LPTIM counter frequency
+extern uint32_t Sim_WakeupTicks;		// LPTIM ticks between the compare match and the end of Stop mode
+extern void (*Sim_OnLptimMatch)(void);	// LPTIM interrupt
+extern uint32_t Sim_StopPeriods;		// Number of Stop mode entries ended by the LPTIM
+extern uint8_t Sim_UartCapture[];		// Bytes sent by the UART
+extern uint32_t Sim_UartLength;			// Number of bytes in Sim_UartCapture
+
+bool Sim_UartComplete(void);			// Ends the UART transfer, returns false if there was none
+
+#endif /* TESTS_SIM_HAL_SIM_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,598 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* onewire_sim.c                                                                             */
+/*                                                                                           */
+/* Host simulator of a 1-Wire bus of temperature sensors, behind the HAL stubs               */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "onewire_sim.h"
+
+//!\ Each device follows the 1-Wire protocol slot by slot: ROM command, 64-bit ROM code
+//!\ (MATCH_ROM, SEARCH_ROM), then function command and its data. The bus value of a read
+//!\ slot is the wired AND of the bits sent by the devices.
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+// Durations of the low pulses, in µs
+#define SIM_RESET_US		400U	// Longer: reset pulse
+#define SIM_WRITE0_US		30U		// Longer: write 0, shorter: write 1 or read slot
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+enum
+{
+	SIM_IDLE = 0,		// Waits for a reset
+	SIM_ROM,			// Receives the ROM command
+	SIM_MATCH,			// Receives the ROM code of MATCH_ROM
+	SIM_SEARCH,			// Sends and receives the bits of SEARCH_ROM
+	SIM_FUNCTION,		// Receives the function command
+	SIM_OUTPUT,			// Sends output[]
+	SIM_WRITE,			// Receives the bytes of WRITE_SCRATCHPAD
+	SIM_CONVERT,		// Sends 0 until the end of the conversion, then 1
+	SIM_POWER,			// Sends the power supply
+
+};
+
+/******************************** TYPEDEF END ********************************************** */
+
+GPIO_TypeDef Sim_BusPort;
+TIM_TypeDef Sim_Timer;
+DWT_Type Sim_DWT;
+volatile uint32_t uwTick;
+
+Sim_Device_t Sim_Devices[SIM_DEVICES_MAX];
+uint16_t Sim_DeviceCount;
+void (*Sim_OnConvert)(uint16_t index);
+
+static _Atomic uint64_t sim_time;		// Virtual µs
+static uint64_t sim_suspended;			// Virtual µs not counted by the HAL tick
+static uint64_t sim_suspended_since;
+static bool sim_tick_suspended;
+static uint64_t sim_counter_base;
+static uint64_t sim_low_since;
+static bool sim_low;
+static bool sim_presence;				// The next read of the pin gives the presence pulse
+static bool sim_slot_value;
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static uint8_t Sim_Crc(const uint8_t data[], uint8_t length);
+static bool Sim_RomBit(const Sim_Device_t *device, uint8_t bit);
+static void Sim_Convert(Sim_Device_t *device, uint16_t index);
+static bool Sim_Output(const Sim_Device_t *device);
+static void Sim_Command(Sim_Device_t *device, uint16_t index, uint8_t command);
+static void Sim_Slot(Sim_Device_t *device, uint16_t index, bool value);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+/* Remove all the devices and restart the virtual time */
+void Sim_Reset(void)
+{
+	memset(Sim_Devices, 0, sizeof(Sim_Devices));
+	Sim_DeviceCount = 0;
+	Sim_OnConvert = NULL;
+	sim_low = false;
+	sim_presence = false;
+	sim_tick_suspended = false;
+	sim_suspended = atomic_load(&sim_time);
+	uwTick = 0;
+}
+
+/* ROM code of a family and a serial number, with its CRC */
+uint64_t Sim_RomCode(uint8_t family, uint64_t serial)
+{
+	uint8_t rom[8];
+	uint64_t result = 0;
+
+	rom[0] = family;
+	for (uint8_t i = 0; i < 6U; i++)
+	{
+		rom[1 + i] = (uint8_t)(serial >> (8U * i));
+	}
+	rom[7] = Sim_Crc(rom, 7);
+
+	for (uint8_t i = 0; i < 8U; i++)
+	{
+		result |= (uint64_t)rom[i] << (8U * (7U - i));
+	}
+
+	return result;
+}
+
+/* Connect a device, with its power-on registers */
+uint16_t Sim_Add(uint64_t ROM_code, int16_t temperature)
+{
+	uint16_t index = Sim_DeviceCount++;
+	Sim_Device_t *device = &Sim_Devices[index];
+
+	memset(device, 0, sizeof(*device));
+	for (uint8_t i = 0; i < 8U; i++)
+	{
+		device->rom[i] = (uint8_t)(ROM_code >> (8U * (7U - i)));
+	}
+	device->present = true;
+	device->temperature = temperature;
+
+	// 85°C until the first conversion, TH 75°C, TL 70°C, 12 bits
+	uint8_t *scratchpad = device->scratchpad;
+	scratchpad[2] = 0x4B;
+	scratchpad[3] = 0x46;
+	scratchpad[4] = 0x7F;
+	scratchpad[5] = 0xFF;
+	scratchpad[6] = 0x0C;
+	scratchpad[7] = 0x10;
+
+	if (device->rom[0] == 0x10U)
+	{
+		scratchpad[0] = 0xAA;	// 0.5°C steps
+		scratchpad[1] = 0x00;
+		scratchpad[4] = 0xFF;
+	}
+	else
+	{
+		scratchpad[0] = 0x50;
+		scratchpad[1] = 0x05;
+	}
+
+	return index;
+}
+
+/* Virtual time, in µs */
+uint64_t Sim_Micros(void)
+{
+	return atomic_load(&sim_time);
+}
+
+/* Let the virtual time run */
+void Sim_Advance(uint64_t us)
+{
+	atomic_fetch_add(&sim_time, us);
+}
+
+/********************************** HAL FUNCTIONS ****************************************** */
+
+uint32_t Sim_GetCounter(void)
+{
+	return (uint32_t)(atomic_fetch_add(&sim_time, 1U) + 1U - sim_counter_base);
+}
+
+void Sim_SetCounter(uint32_t value)
+{
+	sim_counter_base = atomic_load(&sim_time) - value;
+}
+
+uint32_t HAL_GetTick(void)
+{
+	uint64_t now = atomic_fetch_add(&sim_time, 1U) + 1U;
+
+	// SysTick does not count while it is suspended (Stop mode)
+	if (sim_tick_suspended)
+	{
+		now = sim_suspended_since;
+	}
+
+	return (uint32_t)((now - sim_suspended) / 1000U) + uwTick;
+}
+
+void HAL_Delay(uint32_t delay)
+{
+	Sim_Advance((uint64_t)delay * 1000U);
+}
+
+void HAL_SuspendTick(void)
+{
+	sim_suspended_since = Sim_Micros();
+	sim_tick_suspended = true;
+}
+
+void HAL_ResumeTick(void)
+{
+	sim_suspended += Sim_Micros() - sim_suspended_since;
+	sim_tick_suspended = false;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init)
+{
+	(void)port;
+	(void)init;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+	uint64_t now = Sim_Micros();
+	(void)pin;
+
+	if (port != SIM_BUS_PORT)
+	{
+		// Strong pull-up or other pins
+	}
+	else if (state == GPIO_PIN_RESET)
+	{
+		if (sim_low == false)
+		{
+			sim_low = true;
+			sim_low_since = now;
+		}
+	}
+	else if (sim_low)
+	{
+		uint64_t low = now - sim_low_since;
+		sim_low = false;
+
+		if (low >= SIM_RESET_US)
+		{
+			sim_presence = true;
+			for (uint16_t i = 0; i < Sim_DeviceCount; i++)
+			{
+				Sim_Devices[i].state = SIM_ROM;
+				Sim_Devices[i].bit = 0;
+				Sim_Devices[i].shift = 0;
+			}
+		}
+		else
+		{
+			// A device can only pull the bus low during a slot left high by the master
+			bool value = (low < SIM_WRITE0_US);
+
+			for (uint16_t i = 0; (i < Sim_DeviceCount) && (value); i++)
+			{
+				if (Sim_Devices[i].present)
+				{
+					value = Sim_Output(&Sim_Devices[i]);
+				}
+			}
+
+			sim_presence = false;
+			sim_slot_value = value;
+
+			for (uint16_t i = 0; i < Sim_DeviceCount; i++)
+			{
+				if (Sim_Devices[i].present)
+				{
+					Sim_Slot(&Sim_Devices[i], i, value);
+				}
+			}
+		}
+	}
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin)
+{
+	GPIO_PinState result = GPIO_PIN_SET;
+	(void)pin;
+
+	if (port != SIM_BUS_PORT)
+	{
+		// Not the bus
+	}
+	else if (sim_presence)
+	{
+		for (uint16_t i = 0; i < Sim_DeviceCount; i++)
+		{
+			if (Sim_Devices[i].present)
+			{
+				result = GPIO_PIN_RESET;
+			}
+		}
+	}
+	else if (sim_slot_value == false)
+	{
+		result = GPIO_PIN_RESET;
+	}
+
+	return result;
+}
+
+void HAL_RCC_GetClockConfig(RCC_ClkInitTypeDef *clocks, uint32_t *latency)
+{
+	clocks->APB1CLKDivider = RCC_HCLK_DIV1;
+	*latency = 0;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+	return 100000000UL;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *handle)
+{
+	return (handle->Instance == NULL) ? HAL_ERROR : HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_ConfigClockSource(TIM_HandleTypeDef *handle, TIM_ClockConfigTypeDef *config)
+{
+	(void)handle;
+	(void)config;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *handle, TIM_MasterConfigTypeDef *config)
+{
+	(void)handle;
+	(void)config;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *handle)
+{
+	(void)handle;
+	return HAL_OK;
+}
+
+/******************************* IO FUNCTIONS END ****************************************** */
+
+/* CRC8 of the 1-Wire devices, polynomial X^8 + X^5 + X^4 + 1 */
+uint8_t Sim_Crc(const uint8_t data[], uint8_t length)
+{
+	uint8_t crc = 0;
+
+	for (uint8_t i = 0; i < length; i++)
+	{
+		uint8_t byte = data[i];
+
+		for (uint8_t bit = 0; bit < 8U; bit++)
+		{
+			uint8_t mix = (crc ^ byte) & 0x01U;
+			crc >>= 1;
+			if (mix != 0U)
+			{
+				crc ^= 0x8CU;
+			}
+			byte >>= 1;
+		}
+	}
+
+	return crc;
+}
+
+/* Bit of the ROM code of a device, in the order of the bus */
+bool Sim_RomBit(const Sim_Device_t *device, uint8_t bit)
+{
+	return ((device->rom[bit / 8U] >> (bit % 8U)) & 0x01U) != 0U;
+}
+
+/* Start a conversion: the temperature register gets the temperature of the device */
+void Sim_Convert(Sim_Device_t *device, uint16_t index)
+{
+	uint8_t *scratchpad = device->scratchpad;
+	uint8_t resolution = 12U;
+	int16_t value = 0;
+
+	device->conversions++;
+	if (Sim_OnConvert != NULL)
+	{
+		Sim_OnConvert(index);
+	}
+	value = device->temperature;
+
+	switch (device->rom[0])
+	{
+	case 0x10U:
+	{
+		// 0.5°C steps, and COUNT_REMAIN = 12 - sixteenths above the whole degree
+		int16_t whole = (int16_t)(value & ~15);
+		int16_t sixteenths = (int16_t)(value - whole);
+		int16_t halves = (int16_t)((whole / 8) + ((sixteenths >= 8) ? 1 : 0));
+
+		scratchpad[0] = (uint8_t)halves;
+		scratchpad[1] = (uint8_t)((uint16_t)halves >> 8);
+		scratchpad[6] = (uint8_t)((sixteenths <= 12) ? (12 - sixteenths) : 0);
+		scratchpad[7] = 0x10;
+		break;
+	}
+
+	case 0x3BU:
+		// MAX31850: thermocouple in 0.25°C steps, cold junction at 25°C, no fault
+		value = (int16_t)(value & ~3);
+		scratchpad[0] = (uint8_t)value;
+		scratchpad[1] = (uint8_t)((uint16_t)value >> 8);
+		scratchpad[2] = 0x00;
+		scratchpad[3] = 0x19;
+		break;
+
+	default:
+		resolution = (uint8_t)(9U + ((scratchpad[4] >> 5) & 0x03U));
+		value = (int16_t)(value & ~((1 << (12U - resolution)) - 1));
+		scratchpad[0] = (uint8_t)value;
+		scratchpad[1] = (uint8_t)((uint16_t)value >> 8);
+		break;
+	}
+
+	// 93.75 ms at 9 bits, doubled by each bit of resolution; 750 ms for the other families
+	device->busy_until = Sim_Micros() + (93750ULL << (resolution - 9U));
+	device->state = SIM_CONVERT;
+}
+
+/* Bit sent by a device during a read slot */
+bool Sim_Output(const Sim_Device_t *device)
+{
+	bool result = true;
+
+	switch (device->state)
+	{
+	case SIM_SEARCH:
+		// Bit of the ROM code, then its complement, then the direction chosen by the master
+		if (device->phase == 0U)
+		{
+			result = Sim_RomBit(device, device->bit);
+		}
+		else if (device->phase == 1U)
+		{
+			result = !Sim_RomBit(device, device->bit);
+		}
+		break;
+
+	case SIM_OUTPUT:
+		if (device->bit < (device->output_length * 8U))
+		{
+			result = ((device->output[device->bit / 8U] >> (device->bit % 8U)) & 0x01U) != 0U;
+		}
+		break;
+
+	case SIM_CONVERT:
+		result = (Sim_Micros() >= device->busy_until);
+		break;
+
+	case SIM_POWER:
+		result = !device->parasite;
+		break;
+
+	default:
+		break;
+	}
+
+	return result;
+}
+
+/* Function command received by a selected device */
+void Sim_Command(Sim_Device_t *device, uint16_t index, uint8_t command)
+{
+	switch (command)
+	{
+	case 0x44U:	// CONVERT_T
+		Sim_Convert(device, index);
+		break;
+
+	case 0xBEU:	// READ_SCRATCHPAD
+		memcpy(device->output, device->scratchpad, 8);
+		device->output[8] = Sim_Crc(device->scratchpad, 8);
+		device->output_length = 9;
+		device->state = SIM_OUTPUT;
+		break;
+
+	case 0x4EU:	// WRITE_SCRATCHPAD
+		device->written = 0;
+		device->state = SIM_WRITE;
+		break;
+
+	case 0x48U:	// COPY_SCRATCHPAD
+		device->copies++;
+		device->state = SIM_POWER;	// Answers 1 at once: the copy is done
+		break;
+
+	case 0xB4U:	// READ_PWR_SUPPLY
+		device->state = SIM_POWER;
+		break;
+
+	default:
+		device->state = SIM_IDLE;
+		break;
+	}
+}
+
+/* End of a slot, with the value of the bus */
+void Sim_Slot(Sim_Device_t *device, uint16_t index, bool value)
+{
+	switch (device->state)
+	{
+	case SIM_ROM:
+	case SIM_FUNCTION:
+		device->shift |= (uint8_t)((value ? 1U : 0U) << device->bit);
+		if (++device->bit == 8U)
+		{
+			uint8_t command = device->shift;
+			bool function = (device->state == SIM_FUNCTION);
+
+			device->bit = 0;
+			device->shift = 0;
+			device->phase = 0;
+
+			if (function)
+			{
+				Sim_Command(device, index, command);
+			}
+			else if (command == 0xF0U)	// SEARCH_ROM
+			{
+				device->state = SIM_SEARCH;
+			}
+			else if (command == 0x55U)	// MATCH_ROM
+			{
+				device->state = SIM_MATCH;
+			}
+			else if (command == 0xCCU)	// SKIP_ROM
+			{
+				device->state = SIM_FUNCTION;
+			}
+			else if (command == 0x33U)	// READ_ROM
+			{
+				memcpy(device->output, device->rom, 8);
+				device->output_length = 8;
+				device->state = SIM_OUTPUT;
+			}
+			else
+			{
+				device->state = SIM_IDLE;
+			}
+		}
+		break;
+
+	case SIM_MATCH:
+		if (value != Sim_RomBit(device, device->bit))
+		{
+			device->state = SIM_IDLE;	// Another device is addressed
+		}
+		else if (++device->bit == 64U)
+		{
+			device->bit = 0;
+			device->state = SIM_FUNCTION;
+		}
+		break;
+
+	case SIM_SEARCH:
+		if (device->phase < 2U)
+		{
+			device->phase++;
+		}
+		else if (value != Sim_RomBit(device, device->bit))
+		{
+			device->state = SIM_IDLE;	// The master took the other branch
+		}
+		else
+		{
+			device->phase = 0;
+			if (++device->bit == 64U)
+			{
+				device->state = SIM_IDLE;
+			}
+		}
+		break;
+
+	case SIM_OUTPUT:
+		device->bit++;
+		break;
+
+	case SIM_WRITE:
+	{
+		// TH, TL and configuration; a DS18S20 has no configuration register
+		uint8_t length = (device->rom[0] == 0x10U) ? 2U : 3U;
+
+		device->shift |= (uint8_t)((value ? 1U : 0U) << device->bit);
+		if (++device->bit == 8U)
+		{
+			if (device->written < length)
+			{
+				device->scratchpad[2U + device->written] = device->shift;
+			}
+			device->written++;
+			device->bit = 0;
+			device->shift = 0;
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,92 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* onewire_sim.h                                                                             */
+/*                                                                                           */
+/* Host simulator of a 1-Wire bus of temperature sensors, behind the HAL stubs               */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef TESTS_SIM_ONEWIRE_SIM_H_
+// Header guard to prevent multiple inclusions
+#define TESTS_SIM_ONEWIRE_SIM_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "stm32h7xx_hal.h"
+
+//!\ The bus pin is decoded from the durations of its low pulses, in virtual µs: the time
+//!\ advances by 1 µs on every read of the timer counter or of the HAL tick, so the busy
+//!\ waits of the driver run at full speed and the timings are still checked.
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define SIM_DEVICES_MAX		64U
+
+// Port and timer to give to the driver
+#define SIM_BUS_PORT		(&Sim_BusPort)
+#define SIM_TIMER			(&Sim_Timer)
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+/* Simulated device */
+typedef struct
+{
+	uint8_t rom[8];				// ROM code, family code first
+	bool present;				// Connected to the bus
+	bool parasite;				// Answers 0 to READ_PWR_SUPPLY
+	int16_t temperature;		// Temperature measured by the next conversion, Q12.4
+
+	// Registers
+	uint8_t scratchpad[9];		// Temperature LSB, MSB, TH, TL, configuration...
+	uint8_t written;			// Bytes received by the last WRITE_SCRATCHPAD, extra ones included
+	uint32_t conversions;		// CONVERT_T received
+	uint32_t copies;			// COPY_SCRATCHPAD received
+
+	// Protocol state
+	uint8_t state;
+	uint8_t bit;				// Bit of the ROM code, or of the data being read / written
+	uint8_t phase;				// SEARCH_ROM: bit, complement or direction
+	uint8_t shift;
+	uint8_t output[9];			// Bytes sent by READ_SCRATCHPAD or READ_ROM
+	uint8_t output_length;
+	uint64_t busy_until;		// End of a conversion, virtual µs
+
+} Sim_Device_t;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+extern GPIO_TypeDef Sim_BusPort;
+extern TIM_TypeDef Sim_Timer;
+
+extern Sim_Device_t Sim_Devices[SIM_DEVICES_MAX];
+extern uint16_t Sim_DeviceCount;
+
+// Called with the index of a device when it receives CONVERT_T, may change its temperature
+extern void (*Sim_OnConvert)(uint16_t index);
+
+void Sim_Reset(void);
+
+uint64_t Sim_RomCode(uint8_t family, uint64_t serial);
+
+uint16_t Sim_Add(uint64_t ROM_code, int16_t temperature);
+
+uint64_t Sim_Micros(void);
+
+void Sim_Advance(uint64_t us);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* TESTS_SIM_ONEWIRE_SIM_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,333 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* rtos_sim.c                                                                                */
+/*                                                                                           */
+/* Host stand-in for the FreeRTOS tasks, notifications and queues, on POSIX threads          */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "stm32h7xx_hal.h"
+
+//!\ The waits use the real time, 1 tick = 1 ms. vTaskDelay also lets the virtual time of
+//!\ the 1-Wire simulator run, so that the conversions started before it are complete.
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+struct tskTaskControlBlock
+{
+	pthread_t thread;
+	TaskFunction_t function;
+	void *argument;
+
+	pthread_mutex_t lock;
+	pthread_cond_t notified;
+	uint32_t value;
+	bool pending;
+};
+
+struct QueueDefinition
+{
+	pthread_mutex_t lock;
+	pthread_cond_t changed;
+	uint8_t *items;
+	UBaseType_t length;
+	UBaseType_t item_size;
+	UBaseType_t head;
+	UBaseType_t count;
+};
+
+/******************************** TYPEDEF END ********************************************** */
+
+static __thread struct tskTaskControlBlock *rtos_current;
+
+/******************************* STATIC FUNCTIONS BEGIN ************************************ */
+
+static struct tskTaskControlBlock *Rtos_NewTask(void);
+static void *Rtos_Thread(void *argument);
+static void Rtos_Deadline(TickType_t ticks, struct timespec *deadline);
+static bool Rtos_Wait(pthread_cond_t *condition, pthread_mutex_t *lock, TickType_t ticks,
+                      const struct timespec *deadline);
+
+/******************************* STATIC FUNCTIONS END ************************************** */
+
+/******************************* IO FUNCTIONS BEGIN **************************************** */
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, configSTACK_DEPTH_TYPE stack_depth,
+                       void *argument, UBaseType_t priority, TaskHandle_t *task)
+{
+	BaseType_t result = pdFAIL;
+	struct tskTaskControlBlock *created = Rtos_NewTask();
+	(void)name;
+	(void)stack_depth;
+	(void)priority;
+
+	if (created != NULL)
+	{
+		created->function = function;
+		created->argument = argument;
+
+		if (pthread_create(&created->thread, NULL, Rtos_Thread, created) == 0)
+		{
+			pthread_detach(created->thread);
+			if (task != NULL)
+			{
+				*task = created;
+			}
+			result = pdPASS;
+		}
+	}
+
+	return result;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+	// The threads not created by xTaskCreate (main) get a task on their first call
+	if (rtos_current == NULL)
+	{
+		rtos_current = Rtos_NewTask();
+	}
+
+	return rtos_current;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (TickType_t)(((uint64_t)now.tv_sec * 1000U) + ((uint64_t)now.tv_nsec / 1000000U));
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+	struct timespec delay = { .tv_sec = ticks / 1000U, .tv_nsec = (long)(ticks % 1000U) * 1000000L };
+
+	HAL_Delay(ticks);
+	nanosleep(&delay, NULL);
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+	pthread_mutex_lock(&task->lock);
+
+	switch (action)
+	{
+	case eSetBits:
+		task->value |= value;
+		break;
+	case eIncrement:
+		task->value++;
+		break;
+	case eSetValueWithOverwrite:
+	case eSetValueWithoutOverwrite:
+		task->value = value;
+		break;
+	default:
+		break;
+	}
+
+	task->pending = true;
+	pthread_cond_signal(&task->notified);
+	pthread_mutex_unlock(&task->lock);
+
+	return pdPASS;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks)
+{
+	BaseType_t result = pdFALSE;
+	TaskHandle_t task = xTaskGetCurrentTaskHandle();
+	struct timespec deadline;
+
+	Rtos_Deadline(ticks, &deadline);
+	pthread_mutex_lock(&task->lock);
+
+	if (task->pending == false)
+	{
+		task->value &= ~clear_on_entry;
+	}
+
+	while ((task->pending == false) && (Rtos_Wait(&task->notified, &task->lock, ticks, &deadline)))
+	{
+	}
+
+	if (value != NULL)
+	{
+		*value = task->value;
+	}
+	if (task->pending)
+	{
+		task->value &= ~clear_on_exit;
+		task->pending = false;
+		result = pdTRUE;
+	}
+
+	pthread_mutex_unlock(&task->lock);
+
+	return result;
+}
+
+BaseType_t xTaskNotifyStateClear(TaskHandle_t task)
+{
+	BaseType_t result = pdFALSE;
+
+	if (task == NULL)
+	{
+		task = xTaskGetCurrentTaskHandle();
+	}
+
+	pthread_mutex_lock(&task->lock);
+	result = task->pending ? pdTRUE : pdFALSE;
+	task->pending = false;
+	pthread_mutex_unlock(&task->lock);
+
+	return result;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+	struct QueueDefinition *queue = calloc(1, sizeof(*queue));
+
+	if (queue != NULL)
+	{
+		queue->items = calloc(length, item_size);
+		queue->length = length;
+		queue->item_size = item_size;
+		pthread_mutex_init(&queue->lock, NULL);
+		pthread_cond_init(&queue->changed, NULL);
+
+		if (queue->items == NULL)
+		{
+			free(queue);
+			queue = NULL;
+		}
+	}
+
+	return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+	BaseType_t result = pdFAIL;
+	struct timespec deadline;
+
+	Rtos_Deadline(ticks, &deadline);
+	pthread_mutex_lock(&queue->lock);
+
+	while ((queue->count == queue->length) && (Rtos_Wait(&queue->changed, &queue->lock, ticks, &deadline)))
+	{
+	}
+
+	if (queue->count < queue->length)
+	{
+		UBaseType_t tail = (queue->head + queue->count) % queue->length;
+
+		memcpy(&queue->items[tail * queue->item_size], item, queue->item_size);
+		queue->count++;
+		pthread_cond_broadcast(&queue->changed);
+		result = pdPASS;
+	}
+
+	pthread_mutex_unlock(&queue->lock);
+
+	return result;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+	BaseType_t result = pdFAIL;
+	struct timespec deadline;
+
+	Rtos_Deadline(ticks, &deadline);
+	pthread_mutex_lock(&queue->lock);
+
+	while ((queue->count == 0U) && (Rtos_Wait(&queue->changed, &queue->lock, ticks, &deadline)))
+	{
+	}
+
+	if (queue->count != 0U)
+	{
+		memcpy(item, &queue->items[queue->head * queue->item_size], queue->item_size);
+		queue->head = (queue->head + 1U) % queue->length;
+		queue->count--;
+		pthread_cond_broadcast(&queue->changed);
+		result = pdPASS;
+	}
+
+	pthread_mutex_unlock(&queue->lock);
+
+	return result;
+}
+
+/* Allocate a task control block */
+struct tskTaskControlBlock *Rtos_NewTask(void)
+{
+	struct tskTaskControlBlock *task = calloc(1, sizeof(*task));
+
+	if (task != NULL)
+	{
+		pthread_mutex_init(&task->lock, NULL);
+		pthread_cond_init(&task->notified, NULL);
+	}
+
+	return task;
+}
+
+/* Body of the thread of a task */
+void *Rtos_Thread(void *argument)
+{
+	rtos_current = (struct tskTaskControlBlock *)argument;
+	rtos_current->function(rtos_current->argument);
+
+	return NULL;
+}
+
+/* Real time after a number of ticks */
+void Rtos_Deadline(TickType_t ticks, struct timespec *deadline)
+{
+	clock_gettime(CLOCK_REALTIME, deadline);
+
+	if (ticks != portMAX_DELAY)
+	{
+		deadline->tv_sec += ticks / 1000U;
+		deadline->tv_nsec += (long)(ticks % 1000U) * 1000000L;
+		if (deadline->tv_nsec >= 1000000000L)
+		{
+			deadline->tv_sec++;
+			deadline->tv_nsec -= 1000000000L;
+		}
+	}
+}
+
+/* Wait for a condition until a deadline, returns false once the deadline is passed */
+bool Rtos_Wait(pthread_cond_t *condition, pthread_mutex_t *lock, TickType_t ticks, const struct timespec *deadline)
+{
+	bool result = false;
+
+	if (ticks == portMAX_DELAY)
+	{
+		result = (pthread_cond_wait(condition, lock) == 0);
+	}
+	else if (ticks != 0U)
+	{
+		result = (pthread_cond_timedwait(condition, lock, deadline) != ETIMEDOUT);
+	}
+
+	return result;
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,36 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* FreeRTOS.h                                                                                */
+/*                                                                                           */
+/* Host stand-in for the parts of the FreeRTOS API used by the driver, see Sim/rtos_sim.c    */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef TESTS_STUBS_FREERTOS_H_
+// Header guard to prevent multiple inclusions
+#define TESTS_STUBS_FREERTOS_H_
+
+#include <stdint.h>
+
+//!\ The tasks are POSIX threads and a tick is 1 ms of real time. Only the calls made by
+//!\ DS18B20_rtos.c and the tests are provided.
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define configSTACK_DEPTH_TYPE	uint16_t
+#define configMAX_PRIORITIES	8U
+
+#define pdFALSE					0
+#define pdTRUE					1
+#define pdFAIL					0
+#define pdPASS					1
+#define portMAX_DELAY			((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(ms)		((TickType_t)(ms))
+
+#endif /* TESTS_STUBS_FREERTOS_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,19 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* console.h                                                                                 */
+/*                                                                                           */
+/* Host stand-in for the console of the common driver files: printf to the standard output   */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef TESTS_STUBS_CONSOLE_H_
+// Header guard to prevent multiple inclusions
+#define TESTS_STUBS_CONSOLE_H_
+
+#include <stdio.h>
+
+#endif /* TESTS_STUBS_CONSOLE_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,25 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* errors.h                                                                                  */
+/*                                                                                           */
+/* Host stand-in for the error type of the common driver files                               */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef TESTS_STUBS_ERRORS_H_
+// Header guard to prevent multiple inclusions
+#define TESTS_STUBS_ERRORS_H_
+
+typedef enum
+{
+	OK = 0,
+	NULL_POINTER,
+	ERROR_OTHER,
+
+} error_t;
+
+#endif /* TESTS_STUBS_ERRORS_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,25 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* queue.h                                                                                   */
+/*                                                                                           */
+/* Host stand-in for the FreeRTOS queues                                                     */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef TESTS_STUBS_QUEUE_H_
+// Header guard to prevent multiple inclusions
+#define TESTS_STUBS_QUEUE_H_
+
+#include "FreeRTOS.h"
+
+typedef struct QueueDefinition *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks);
+
+#endif /* TESTS_STUBS_QUEUE_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,120 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* stm32h7xx_hal.h                                                                           */
+/*                                                                                           */
+/* Host stand-in for the parts of the STM32H7 HAL used by the driver, see Sim/onewire_sim.c  */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef TESTS_STUBS_STM32H7XX_HAL_H_
+// Header guard to prevent multiple inclusions
+#define TESTS_STUBS_STM32H7XX_HAL_H_
+
+/******************************* INCLUDES BEGIN ******************************************** */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************* INCLUDES END ********************************************** */
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define __IO	volatile
+
+#define GPIO_MODE_OUTPUT_OD				1U
+#define GPIO_MODE_OUTPUT_PP				2U
+#define GPIO_NOPULL						0U
+#define GPIO_SPEED_FREQ_HIGH			2U
+#define RCC_HCLK_DIV1					0U
+#define TIM_CLOCKDIVISION_DIV1			0U
+#define TIM_AUTORELOAD_PRELOAD_DISABLE	0U
+#define TIM_CLOCKSOURCE_INTERNAL		0U
+#define TIM_TRGO_RESET					0U
+#define TIM_MASTERSLAVEMODE_DISABLE		0U
+#define PWR_MAINREGULATOR_ON			0U
+#define PWR_LOWPOWERREGULATOR_ON		1U
+#define PWR_SLEEPENTRY_WFI				1U
+#define PWR_STOPENTRY_WFI				1U
+#define FLASH_BANK_1					1U
+#define FLASH_BANK_2					2U
+#define FLASH_NB_32BITWORD_IN_FLASHWORD	8U
+#define FLASH_TYPEPROGRAM_FLASHWORD		1U
+#define FLASH_TYPEERASE_SECTORS			0U
+#define FLASH_VOLTAGE_RANGE_3			2U
+#define FLASH_SECTOR_SIZE				0x20000U
+
+// The timer counts the virtual time of the simulator, in µs
+#define __HAL_TIM_SET_COUNTER(handle, value)	Sim_SetCounter(value)
+#define __HAL_TIM_GET_COUNTER(handle)			Sim_GetCounter()
+#define __HAL_TIM_GET_AUTORELOAD(handle)		((handle)->Init.Period)
+
+// Cycle counter, only read by the codec statistics
+#define DWT	(&Sim_DWT)
+
+/*********************************** DEFINE END ******************************************** */
+
+/******************************** TYPEDEF BEGIN ******************************************** */
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+typedef struct { uint32_t id; } TIM_TypeDef;
+typedef struct { uint32_t Prescaler, CounterMode, Period, ClockDivision, AutoReloadPreload; } TIM_Base_InitTypeDef;
+typedef struct { TIM_TypeDef *Instance; TIM_Base_InitTypeDef Init; } TIM_HandleTypeDef;
+typedef struct { uint32_t ClockSource; } TIM_ClockConfigTypeDef;
+typedef struct { uint32_t MasterOutputTrigger, MasterSlaveMode; } TIM_MasterConfigTypeDef;
+typedef struct { uint32_t APB1CLKDivider; } RCC_ClkInitTypeDef;
+typedef struct { volatile uint32_t OTYPER; } GPIO_TypeDef;
+typedef struct { uint32_t Pin, Mode, Pull, Speed; } GPIO_InitTypeDef;
+typedef struct { uint32_t id; } UART_HandleTypeDef;
+typedef struct { uint32_t id; } LPTIM_HandleTypeDef;
+typedef struct { uint32_t TypeErase, Banks, Sector, NbSectors, VoltageRange; } FLASH_EraseInitTypeDef;
+typedef struct { volatile uint32_t CYCCNT; } DWT_Type;
+
+/******************************** TYPEDEF END ********************************************** */
+
+/************************** FUNCTION PROTOTYPES BEGIN ************************************** */
+
+extern volatile uint32_t uwTick;
+extern DWT_Type Sim_DWT;
+
+uint32_t Sim_GetCounter(void);
+void Sim_SetCounter(uint32_t value);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+void HAL_SuspendTick(void);
+void HAL_ResumeTick(void);
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+
+void HAL_RCC_GetClockConfig(RCC_ClkInitTypeDef *clocks, uint32_t *latency);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *handle);
+HAL_StatusTypeDef HAL_TIM_ConfigClockSource(TIM_HandleTypeDef *handle, TIM_ClockConfigTypeDef *config);
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *handle, TIM_MasterConfigTypeDef *config);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *handle);
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *handle, const uint8_t *data, uint16_t size);
+
+void HAL_PWR_EnterSLEEPMode(uint32_t regulator, uint8_t entry);
+void HAL_PWR_EnterSTOPMode(uint32_t regulator, uint8_t entry);
+HAL_StatusTypeDef HAL_LPTIM_TimeOut_Start_IT(LPTIM_HandleTypeDef *handle, uint32_t period, uint32_t timeout);
+HAL_StatusTypeDef HAL_LPTIM_TimeOut_Stop_IT(LPTIM_HandleTypeDef *handle);
+uint32_t HAL_LPTIM_ReadCounter(const LPTIM_HandleTypeDef *handle);
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t type, uint32_t address, uint32_t data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *init, uint32_t *error);
+
+/************************** FUNCTION PROTOTYPES END **************************************** */
+
+#endif /* TESTS_STUBS_STM32H7XX_HAL_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,42 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* task.h                                                                                    */
+/*                                                                                           */
+/* Host stand-in for the FreeRTOS tasks and task notifications                               */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#ifndef TESTS_STUBS_TASK_H_
+// Header guard to prevent multiple inclusions
+#define TESTS_STUBS_TASK_H_
+
+#include "FreeRTOS.h"
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *argument);
+
+typedef enum
+{
+	eNoAction = 0,
+	eSetBits,
+	eIncrement,
+	eSetValueWithOverwrite,
+	eSetValueWithoutOverwrite,
+
+} eNotifyAction;
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, configSTACK_DEPTH_TYPE stack_depth,
+                       void *argument, UBaseType_t priority, TaskHandle_t *task);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks);
+BaseType_t xTaskNotifyStateClear(TaskHandle_t task);
+
+#endif /* TESTS_STUBS_TASK_H_ */
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,81 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_cache.c                                                                              */
+/*                                                                                           */
+/* Host test of the result cache on the 1-Wire simulator                                     */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20_cache.h"
+#include "onewire_sim.h"
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+
+int main(void)
+{
+	static DS18B20_t sensor = {0};
+	DS18B20_Cache_t cache;
+	DS18B20_CacheEntry_t entries[3];
+	uint64_t ROM_codes_array[4];
+	int16_t value = 0;
+
+	Sim_Reset();
+	ROM_codes_array[0] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 1);
+	ROM_codes_array[1] = DS18B20_FREE_SLOT;
+	ROM_codes_array[2] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 2);
+	ROM_codes_array[3] = 0;
+	Sim_Add(ROM_codes_array[0], 408);
+	uint16_t unplugged = Sim_Add(ROM_codes_array[2], 480);
+
+	sensor.timer_instance = SIM_TIMER;
+	sensor.gpio_port = SIM_BUS_PORT;
+	TEST_CHECK(DS18B20_Init(&sensor) == OK);
+	TEST_CHECK(DS18B20_Cache_Init(&cache, &sensor, ROM_codes_array, entries, 1000) == OK);
+	TEST_CHECK(cache.entry_count == 3U);
+
+	TEST_CHECK(DS18B20_Cache_Get(&cache, 0, &value) == DS18B20_SAMPLE_OK);
+	TEST_CHECK(value == 408);
+	TEST_CHECK(DS18B20_Cache_Get(&cache, 2, &value) == DS18B20_SAMPLE_OK);
+	TEST_CHECK(value == 480);
+	TEST_CHECK((cache.sweeps == 1U) && (cache.hits == 1U));
+
+	// A lookup alone is not a read served from the cache
+	TEST_CHECK((DS18B20_Cache_Lookup(&cache, 0, &value, NULL)) && (cache.hits == 1U));
+
+	// Free slot and slot out of the array: no sweep, and nothing read out of entries[]
+	value = -1;
+	TEST_CHECK(DS18B20_Cache_Get(&cache, 1, &value) == DS18B20_SAMPLE_NO_PRESENCE);
+	TEST_CHECK(DS18B20_Cache_Get(&cache, 3, &value) == DS18B20_SAMPLE_NO_PRESENCE);
+	TEST_CHECK(DS18B20_Cache_Get(&cache, 1000, &value) == DS18B20_SAMPLE_NO_PRESENCE);
+	TEST_CHECK(value == -1);
+	TEST_CHECK(cache.sweeps == 1U);
+
+	// A sensor that left the bus is reported by the next sweep
+	Sim_Devices[unplugged].present = false;
+	HAL_Delay(2000);
+	TEST_CHECK(DS18B20_Cache_Get(&cache, 2, &value) != DS18B20_SAMPLE_OK);
+	TEST_CHECK(cache.sweeps == 2U);
+
+	printf("test_cache: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,146 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_codec.c                                                                              */
+/*                                                                                           */
+/* Host test and benchmark of the sample encoding, on a simulated day of logging             */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "ds18b20_codec.h"
+
+//!\ The input is generated, always the same: TEST_SENSORS sensors in a building, read once
+//!\ a minute for a day. Each one starts between 18 and 26 °C and drifts by at most 1 LSB
+//!\ (1/16 °C) per minute, and 1 read in 1000 fails. The whole day is encoded, decoded
+//!\ back and compared; the size of the stream is the figure given in the README.
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+#define TEST_SENSORS	200U
+#define TEST_SWEEPS		(24U * 60U)
+#define TEST_PERIOD		60000U		// ms between two sweeps
+#define TEST_SAMPLES	(TEST_SENSORS * TEST_SWEEPS)
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static uint32_t test_seed = 1U;
+
+static DS18B20_Sample_t samples[TEST_SAMPLES];
+static uint8_t stream[TEST_SAMPLES * DS18B20_CODEC_MAX_SIZE];
+
+/* Pseudo-random number, the same on every host */
+static uint32_t test_random(void)
+{
+	test_seed = (test_seed * 1103515245U) + 12345U;
+
+	return test_seed >> 16;
+}
+
+/* Generate the day of samples */
+static void test_codec_generate(void)
+{
+	int16_t values[TEST_SENSORS];
+	uint32_t index = 0;
+
+	for (uint16_t slot = 0; slot < TEST_SENSORS; slot++)
+	{
+		values[slot] = (int16_t)(288 + (test_random() % 128U));
+	}
+
+	for (uint32_t sweep = 0; sweep < TEST_SWEEPS; sweep++)
+	{
+		for (uint16_t slot = 0; slot < TEST_SENSORS; slot++)
+		{
+			DS18B20_Sample_t *sample = &samples[index++];
+
+			values[slot] = (int16_t)(values[slot] + (int16_t)(test_random() % 3U) - 1);
+
+			sample->timestamp = 1000U + (sweep * TEST_PERIOD);
+			sample->slot = slot;
+
+			if ((test_random() % 1000U) == 0U)
+			{
+				sample->status = DS18B20_SAMPLE_CRC_ERROR;
+			}
+			else
+			{
+				sample->status = DS18B20_SAMPLE_OK;
+				sample->value = values[slot];
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	static int16_t encoder_references[TEST_SENSORS];
+	static int16_t decoder_references[TEST_SENSORS];
+	DS18B20_Codec_t encoder;
+	DS18B20_Codec_t decoder;
+	struct timespec start;
+	struct timespec end;
+	uint32_t length = 0;
+
+	test_codec_generate();
+
+	TEST_CHECK(DS18B20_Codec_Init(&encoder, encoder_references, TEST_SENSORS, 0) == OK);
+	TEST_CHECK(DS18B20_Codec_Init(&decoder, decoder_references, TEST_SENSORS, 0) == OK);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (uint32_t i = 0; i < TEST_SAMPLES; i++)
+	{
+		length += DS18B20_Codec_Encode(&encoder, &samples[i], &stream[length]);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	TEST_CHECK(encoder.samples == TEST_SAMPLES);
+	TEST_CHECK(encoder.bytes == length);
+
+	// Decoded back, every field as encoded
+	uint32_t position = 0;
+	uint32_t mismatches = 0;
+
+	for (uint32_t i = 0; (i < TEST_SAMPLES) && (position < length); i++)
+	{
+		DS18B20_Sample_t sample = {0};
+		uint8_t read = DS18B20_Codec_Decode(&decoder, &stream[position], length - position, &sample);
+
+		if ((read == 0U) || (sample.timestamp != samples[i].timestamp) || (sample.slot != samples[i].slot)
+			|| (sample.status != samples[i].status) || (sample.value != samples[i].value))
+		{
+			mismatches++;
+		}
+		position += (read == 0U) ? length : read;
+	}
+	TEST_CHECK(mismatches == 0U);
+	TEST_CHECK(position == length);
+
+	// Figure of the README: about 20 % of the raw size
+	TEST_CHECK(DS18B20_Codec_Ratio(&encoder) <= 20U);
+
+	double elapsed = (double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec);
+
+	printf("test_codec: %u samples, %lu bytes (%lu %% of %u), %lu keyframes, %.1f ns/sample, %u errors\n",
+	       (unsigned)TEST_SAMPLES, (unsigned long)length, (unsigned long)DS18B20_Codec_Ratio(&encoder),
+	       (unsigned)(TEST_SAMPLES * DS18B20_CODEC_RAW_SIZE), (unsigned long)encoder.keyframes,
+	       elapsed / TEST_SAMPLES, errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
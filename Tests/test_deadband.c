@@ -0,0 +1,135 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_deadband.c                                                                           */
+/*                                                                                           */
+/* Host test of the deadband, hysteresis and heartbeat of the delivery path                  */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20_deadband.h"
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+#define TEST_DEADBAND	16U			// 1 °C
+#define TEST_HYSTERESIS	8U			// 0.5 °C more when the change goes back
+#define TEST_HEARTBEAT	10000U
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static uint32_t delivered;
+static DS18B20_Sample_t last;
+
+static DS18B20_t sensor;
+static DS18B20_Channel_t channels[2];
+static DS18B20_Deadband_t deadband;
+
+/* Final delivery function */
+static void test_deadband_final(void *context, const DS18B20_Sample_t *sample)
+{
+	(void)context;
+
+	delivered++;
+	last = *sample;
+}
+
+/* Give a sample to the deadband stage, returns true if it was passed on */
+static bool test_deadband_send(uint16_t slot, uint32_t timestamp, int16_t value, uint8_t status)
+{
+	DS18B20_Sample_t sample = {0};
+	uint32_t before = delivered;
+
+	sample.slot = slot;
+	sample.timestamp = timestamp;
+	sample.value = value;
+	sample.status = status;
+	DS18B20_Deadband_Deliver(&deadband, &sample);
+
+	return (delivered != before);
+}
+
+int main(void)
+{
+	sensor.channels = channels;
+	sensor.channel_count = 1;
+	channels[0].deadband = TEST_DEADBAND;
+	channels[0].hysteresis = TEST_HYSTERESIS;
+	channels[0].heartbeat_ms = TEST_HEARTBEAT;
+	TEST_CHECK(DS18B20_Deadband_Init(&deadband, &sensor, test_deadband_final, NULL) == OK);
+	TEST_CHECK(DS18B20_Deadband_Init(&deadband, &sensor, NULL, NULL) == NULL_POINTER);
+	TEST_CHECK(DS18B20_Deadband_Init(&deadband, &sensor, test_deadband_final, NULL) == OK);
+
+	// First sample, then the upper edge of the band: just below, then on it
+	TEST_CHECK(test_deadband_send(0, 0, 320, DS18B20_SAMPLE_OK));
+	TEST_CHECK(test_deadband_send(0, 100, 320 + (int16_t)TEST_DEADBAND - 1, DS18B20_SAMPLE_OK) == false);
+	TEST_CHECK(test_deadband_send(0, 200, 320 + (int16_t)TEST_DEADBAND, DS18B20_SAMPLE_OK));
+	TEST_CHECK((last.value == 336) && (channels[0].trend == 1));
+
+	// A slow drift is compared with the last value delivered, not with the previous sample
+	TEST_CHECK(test_deadband_send(0, 300, 340, DS18B20_SAMPLE_OK) == false);
+	TEST_CHECK(test_deadband_send(0, 400, 345, DS18B20_SAMPLE_OK) == false);
+	TEST_CHECK(test_deadband_send(0, 500, 352, DS18B20_SAMPLE_OK));
+
+	// Turn-around: the band widens by the hysteresis
+	TEST_CHECK(test_deadband_send(0, 600, 352 - (int16_t)TEST_DEADBAND, DS18B20_SAMPLE_OK) == false);
+	TEST_CHECK(test_deadband_send(0, 700, 352 - (int16_t)(TEST_DEADBAND + TEST_HYSTERESIS) + 1,
+	                              DS18B20_SAMPLE_OK) == false);
+	TEST_CHECK(test_deadband_send(0, 800, 352 - (int16_t)(TEST_DEADBAND + TEST_HYSTERESIS), DS18B20_SAMPLE_OK));
+	TEST_CHECK((last.value == 328) && (channels[0].trend == -1));
+
+	// Still going down: the plain band again
+	TEST_CHECK(test_deadband_send(0, 900, 328 - (int16_t)TEST_DEADBAND, DS18B20_SAMPLE_OK));
+
+	// A flicker around the last value delivered never passes
+	for (uint16_t i = 0; i < 20U; i++)
+	{
+		int16_t flicker = (int16_t)(((i % 2U) == 0U) ? 1 : -1);
+
+		TEST_CHECK(test_deadband_send(0, 1000U + i, (int16_t)(312 + flicker), DS18B20_SAMPLE_OK) == false);
+	}
+
+	// Heartbeat: an unchanged sensor is delivered once the period is over, from its last delivery
+	TEST_CHECK(test_deadband_send(0, 900U + TEST_HEARTBEAT - 1U, 312, DS18B20_SAMPLE_OK) == false);
+	TEST_CHECK(test_deadband_send(0, 900U + TEST_HEARTBEAT, 312, DS18B20_SAMPLE_OK));
+	TEST_CHECK(last.timestamp == (900U + TEST_HEARTBEAT));
+	TEST_CHECK(test_deadband_send(0, 900U + TEST_HEARTBEAT + 1U, 312, DS18B20_SAMPLE_OK) == false);
+
+	// Across the wrap of the HAL tick
+	channels[0].reported_at = UINT32_MAX - 10U;
+	TEST_CHECK(test_deadband_send(0, TEST_HEARTBEAT - 12U, 312, DS18B20_SAMPLE_OK) == false);
+	TEST_CHECK(test_deadband_send(0, TEST_HEARTBEAT - 11U, 312, DS18B20_SAMPLE_OK));
+
+	// A failing sensor is delivered once, and again when it comes back
+	TEST_CHECK(test_deadband_send(0, TEST_HEARTBEAT, 312, DS18B20_SAMPLE_CRC_ERROR));
+	TEST_CHECK(test_deadband_send(0, TEST_HEARTBEAT + 1U, 312, DS18B20_SAMPLE_CRC_ERROR) == false);
+	TEST_CHECK(test_deadband_send(0, TEST_HEARTBEAT + 2U, 312, DS18B20_SAMPLE_OK));
+
+	// Full range of the Q12.4 values
+	TEST_CHECK(test_deadband_send(0, TEST_HEARTBEAT + 3U, INT16_MIN, DS18B20_SAMPLE_OK));
+	TEST_CHECK(test_deadband_send(0, TEST_HEARTBEAT + 4U, INT16_MAX, DS18B20_SAMPLE_OK));
+
+	// A slot without a channel always passes
+	TEST_CHECK(test_deadband_send(1, 0, 320, DS18B20_SAMPLE_OK));
+	TEST_CHECK(test_deadband_send(1, 0, 320, DS18B20_SAMPLE_OK));
+
+	TEST_CHECK((deadband.delivered == delivered) && (deadband.suppressed == 29U));
+
+	printf("test_deadband: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,161 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_filter.c                                                                             */
+/*                                                                                           */
+/* Host test of the median and moving average filters of the delivery path                   */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20_filter.h"
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+#define TEST_SHIFT		3U		// Weight of a new value 1/8
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static DS18B20_Sample_t last;
+
+static DS18B20_t sensor;
+static DS18B20_Channel_t channels[2];
+static DS18B20_Filter_t filter;
+
+/* Final delivery function */
+static void test_filter_final(void *context, const DS18B20_Sample_t *sample)
+{
+	(void)context;
+
+	last = *sample;
+}
+
+/* Filter a value of slot 0, returns the value delivered */
+static int16_t test_filter_send(int16_t value, uint8_t status)
+{
+	DS18B20_Sample_t sample = {0};
+
+	sample.value = value;
+	sample.status = status;
+	DS18B20_Filter_Deliver(&filter, &sample);
+
+	return last.value;
+}
+
+/* Median of the last 3 values */
+static void test_filter_median(void)
+{
+	channels[0].median = true;
+	channels[0].ema_shift = 0;
+	TEST_CHECK(DS18B20_Filter_Init(&filter, &sensor, test_filter_final, NULL) == OK);
+
+	// Window filling: the first two values are passed on raw
+	TEST_CHECK(test_filter_send(320, DS18B20_SAMPLE_OK) == 320);
+	TEST_CHECK(test_filter_send(900, DS18B20_SAMPLE_OK) == 900);
+	TEST_CHECK(test_filter_send(330, DS18B20_SAMPLE_OK) == 330);
+	TEST_CHECK(filter.spikes == 0U);
+
+	// A single spike, up or down, is replaced by a neighbour
+	TEST_CHECK(test_filter_send(332, DS18B20_SAMPLE_OK) == 332);
+	TEST_CHECK(test_filter_send(2000, DS18B20_SAMPLE_OK) == 332);
+	TEST_CHECK(test_filter_send(334, DS18B20_SAMPLE_OK) == 334);
+	TEST_CHECK(test_filter_send(-880, DS18B20_SAMPLE_OK) == 334);
+	TEST_CHECK(filter.spikes == 2U);
+
+	// The spike stays in the window for two more samples: the next value is bounded by it
+	TEST_CHECK(test_filter_send(336, DS18B20_SAMPLE_OK) == 334);
+
+	// A real step is only delayed by one sample
+	TEST_CHECK(test_filter_send(480, DS18B20_SAMPLE_OK) == 336);
+	TEST_CHECK(test_filter_send(480, DS18B20_SAMPLE_OK) == 480);
+
+	// A failed sample is passed on unchanged and does not enter the window
+	TEST_CHECK((test_filter_send(1360, DS18B20_SAMPLE_CRC_ERROR) == 1360) && (last.status == DS18B20_SAMPLE_CRC_ERROR));
+	TEST_CHECK(test_filter_send(481, DS18B20_SAMPLE_OK) == 480);
+	TEST_CHECK(filter.spikes == 5U);
+}
+
+/* Exponential moving average */
+static void test_filter_ema(void)
+{
+	int16_t value = 0;
+	int16_t previous = 0;
+	uint16_t steps = 0;
+
+	channels[0].median = false;
+	channels[0].ema_shift = TEST_SHIFT;
+	TEST_CHECK(DS18B20_Filter_Init(&filter, &sensor, test_filter_final, NULL) == OK);
+
+	// Starts at the first value, not at 0
+	TEST_CHECK(test_filter_send(320, DS18B20_SAMPLE_OK) == 320);
+	TEST_CHECK(test_filter_send(320, DS18B20_SAMPLE_OK) == 320);
+
+	// Step up: about 1 - 1/e of it after 2^shift samples, monotonic, then exactly the new value
+	for (steps = 1; steps <= (1U << TEST_SHIFT); steps++)
+	{
+		previous = value;
+		value = test_filter_send(480, DS18B20_SAMPLE_OK);
+		TEST_CHECK((steps == 1U) || (value >= previous));
+	}
+	TEST_CHECK((value > (320 + ((160 * 6) / 10))) && (value < (320 + ((160 * 7) / 10))));
+
+	for (steps = 0; (steps < 200U) && (value != 480); steps++)
+	{
+		value = test_filter_send(480, DS18B20_SAMPLE_OK);
+	}
+	TEST_CHECK(value == 480);
+
+	// Failed samples leave the average as it was
+	TEST_CHECK(test_filter_send(0, DS18B20_SAMPLE_TIMEOUT) == 0);
+	TEST_CHECK(test_filter_send(480, DS18B20_SAMPLE_OK) == 480);
+
+	// Step down to a negative value: within 1 LSB, the fraction of the average being kept
+	for (steps = 0; steps < 200U; steps++)
+	{
+		value = test_filter_send(-880, DS18B20_SAMPLE_OK);
+	}
+	TEST_CHECK((value >= -880) && (value <= -879));
+
+	// A shift too large for the int32 average is clamped, and the extremes still fit
+	channels[0].ema_shift = 20;
+	TEST_CHECK(DS18B20_Filter_Init(&filter, &sensor, test_filter_final, NULL) == OK);
+	TEST_CHECK(test_filter_send(INT16_MAX, DS18B20_SAMPLE_OK) == INT16_MAX);
+	TEST_CHECK(test_filter_send(INT16_MAX, DS18B20_SAMPLE_OK) == INT16_MAX);
+	TEST_CHECK(channels[0].ema == ((int32_t)INT16_MAX << DS18B20_FILTER_EMA_SHIFT_MAX));
+}
+
+int main(void)
+{
+	DS18B20_Sample_t sample = {0};
+
+	sensor.channels = channels;
+	sensor.channel_count = 1;
+	TEST_CHECK(DS18B20_Filter_Init(&filter, &sensor, NULL, NULL) == NULL_POINTER);
+
+	test_filter_median();
+	test_filter_ema();
+
+	// A slot without a channel is passed on unchanged
+	sample.slot = 1;
+	sample.value = 1234;
+	DS18B20_Filter_Deliver(&filter, &sample);
+	TEST_CHECK((last.slot == 1U) && (last.value == 1234));
+
+	printf("test_filter: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
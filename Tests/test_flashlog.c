@@ -0,0 +1,364 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_flashlog.c                                                                           */
+/*                                                                                           */
+/* Host test of the flash log on the flash emulator, with random power cuts                  */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ds18b20_flashlog.h"
+#include "flash_sim.h"
+
+//!\ The fuzzer appends numbered records of random lengths, and cuts the power after a random
+//!\ number of flash words or erases. After each cut, the log is started again on the same
+//!\ memory and read back: every record shall be whole, in order, and every record of a page
+//!\ whose program returned OK shall be there, unless the ring has overwritten it since.
+//!\ The log is also written to a file, and read back by a new start on a RAM that lost it.
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+#define TEST_SECTOR_SIZE	2048U
+#define TEST_SECTORS		4U
+#define TEST_PAGE_SIZE		256U
+
+#define TEST_CUTS			3000U		// Power cuts of the fuzzer
+#define TEST_RECORDS_MAX	4000000U	// Record numbers, 0 is not used
+
+// Record: length (uint8), number (uint32), then length - 5 bytes derived from the number
+#define TEST_RECORD_MIN		6U
+#define TEST_RECORD_MAX		40U
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static uint32_t test_seed = 7U;
+
+static uint8_t memory[TEST_SECTOR_SIZE * TEST_SECTORS];
+static uint32_t page[TEST_PAGE_SIZE / 4U];
+static uint8_t data[TEST_PAGE_SIZE];
+static Sim_Flash_t sim;
+static DS18B20_Flash_t flash = {Sim_FlashRead, Sim_FlashProgram, Sim_FlashErase, &sim,
+                                TEST_SECTOR_SIZE, TEST_SECTORS, TEST_PAGE_SIZE};
+static DS18B20_FlashLog_t flashlog;
+
+static uint32_t record_count;						// Records appended, the last number used
+static uint32_t page_first;							// Number of the first record of the page being filled
+static bool durable[TEST_RECORDS_MAX];				// Record of a page programmed
+static uint32_t seen[TEST_RECORDS_MAX];				// Check which read the record back
+static uint32_t check_count;
+
+/* Pseudo-random number, the same on every host */
+static uint32_t test_random(void)
+{
+	test_seed = (test_seed * 1103515245U) + 12345U;
+
+	return test_seed >> 16;
+}
+
+/* Start the log after a reset, the data in RAM being lost */
+static void test_flashlog_boot(void)
+{
+	memset(&flashlog, 0, sizeof(flashlog));
+	TEST_CHECK(DS18B20_FlashLog_Init(&flashlog, &flash, (uint8_t *)page, NULL) == OK);
+	page_first = record_count + 1U;
+}
+
+/* The records of the page just programmed are safe */
+static void test_flashlog_programmed(uint32_t last)
+{
+	for (uint32_t number = page_first; number <= last; number++)
+	{
+		durable[number] = true;
+	}
+	page_first = last + 1U;
+}
+
+/* Append the next record */
+static void test_flashlog_append(void)
+{
+	uint8_t record[TEST_RECORD_MAX];
+	uint8_t length = (uint8_t)(TEST_RECORD_MIN + (test_random() % (TEST_RECORD_MAX - TEST_RECORD_MIN + 1U)));
+	uint32_t number = ++record_count;
+	uint32_t pages = flashlog.pages;
+
+	record[0] = length;
+	memcpy(&record[1], &number, sizeof(number));
+	for (uint8_t i = 5; i < length; i++)
+	{
+		record[i] = (uint8_t)(number + i);
+	}
+
+	bool dropped = (DS18B20_FlashLog_Append(&flashlog, record, length) != 0U);
+
+	// A full page was programmed first
+	if (flashlog.pages != pages)
+	{
+		test_flashlog_programmed(number - 1U);
+	}
+	if (dropped)
+	{
+		page_first = number + 1U;
+	}
+}
+
+/* Write the page being filled */
+static uint8_t test_flashlog_flush(void)
+{
+	uint32_t pages = flashlog.pages;
+	uint8_t result = DS18B20_FlashLog_Flush(&flashlog);
+
+	if (flashlog.pages != pages)
+	{
+		test_flashlog_programmed(record_count);
+	}
+
+	return result;
+}
+
+/* Read the whole log back and check it, returns the number of records read */
+static uint32_t test_flashlog_check(void)
+{
+	DS18B20_FlashCursor_t cursor;
+	uint16_t length = 0;
+	uint32_t first = 0;
+	uint32_t previous = 0;
+	uint32_t count = 0;
+	uint32_t bad = 0;
+
+	check_count++;
+	DS18B20_FlashLog_Rewind(&flashlog, &cursor);
+
+	while (DS18B20_FlashLog_Read(&flashlog, &cursor, data, &length) == 0U)
+	{
+		for (uint16_t offset = 0; offset < length;)
+		{
+			uint8_t size = data[offset];
+			uint32_t number = 0;
+
+			if ((size < TEST_RECORD_MIN) || (size > TEST_RECORD_MAX) || ((offset + size) > length))
+			{
+				bad++;
+				break;
+			}
+
+			memcpy(&number, &data[offset + 1U], sizeof(number));
+			for (uint8_t i = 5; i < size; i++)
+			{
+				bad += (data[offset + i] != (uint8_t)(number + i)) ? 1U : 0U;
+			}
+
+			// In order, and never a record that was not appended
+			bad += ((number <= previous) || (number > record_count)) ? 1U : 0U;
+			if (number < TEST_RECORDS_MAX)
+			{
+				seen[number] = check_count;
+			}
+			first = (first == 0U) ? number : first;
+			previous = number;
+			count++;
+			offset = (uint16_t)(offset + size);
+		}
+	}
+	TEST_CHECK(bad == 0U);
+
+	// Every programmed record newer than the oldest one kept
+	uint32_t missing = 0;
+
+	for (uint32_t number = ((first != 0U) ? first : 1U); number <= record_count; number++)
+	{
+		missing += (durable[number] && (seen[number] != check_count)) ? 1U : 0U;
+	}
+	TEST_CHECK(missing == 0U);
+
+	return count;
+}
+
+/* Geometries refused by DS18B20_FlashLog_Init */
+static void test_flashlog_geometry(void)
+{
+	DS18B20_Flash_t geometry = flash;
+
+	Sim_FlashInit(&sim, memory, TEST_SECTOR_SIZE, TEST_SECTORS);
+
+	geometry.page_size = 100;		// Not a multiple of the flash word
+	TEST_CHECK(DS18B20_FlashLog_Init(&flashlog, &geometry, (uint8_t *)page, NULL) == ERROR_OTHER);
+	geometry.page_size = 96;		// Flash words, but not a divisor of the sector
+	TEST_CHECK(DS18B20_FlashLog_Init(&flashlog, &geometry, (uint8_t *)page, NULL) == ERROR_OTHER);
+	geometry.page_size = 4096;		// Larger than the sector
+	TEST_CHECK(DS18B20_FlashLog_Init(&flashlog, &geometry, (uint8_t *)page, NULL) == ERROR_OTHER);
+	geometry.page_size = 32;
+	geometry.sector_count = 1;
+	TEST_CHECK(DS18B20_FlashLog_Init(&flashlog, &geometry, (uint8_t *)page, NULL) == ERROR_OTHER);
+	geometry.sector_count = TEST_SECTORS;
+	TEST_CHECK(DS18B20_FlashLog_Init(&flashlog, &geometry, (uint8_t *)page, NULL) == OK);
+}
+
+/* Resets on a blank sector do not erase it */
+static void test_flashlog_erases(void)
+{
+	uint32_t pages_per_turn = (TEST_SECTOR_SIZE / TEST_PAGE_SIZE) * TEST_SECTORS;
+
+	Sim_FlashInit(&sim, memory, TEST_SECTOR_SIZE, TEST_SECTORS);
+	for (uint8_t boot = 0; boot < 3U; boot++)
+	{
+		test_flashlog_boot();
+	}
+	TEST_CHECK(sim.erases == 0U);
+
+	// A whole turn: the log comes back to sector 0, which is erased once
+	while (flashlog.pages < pages_per_turn)
+	{
+		test_flashlog_append();
+	}
+	TEST_CHECK(flashlog.position == 0U);
+	TEST_CHECK(sim.erases == 1U);
+
+	// Reset at the start of this blank sector
+	for (uint8_t boot = 0; boot < 3U; boot++)
+	{
+		test_flashlog_boot();
+		TEST_CHECK((flashlog.position == 0U) && (flashlog.erases == 0U));
+	}
+	TEST_CHECK(sim.erases == 1U);
+}
+
+/* Failed programs have their own counter, and the data stays in RAM */
+static void test_flashlog_program_errors(void)
+{
+	Sim_FlashInit(&sim, memory, TEST_SECTOR_SIZE, TEST_SECTORS);
+	memset(durable, 0, sizeof(durable));
+	record_count = 0;
+	test_flashlog_boot();
+
+	test_flashlog_append();
+	sim.fail_program = true;
+	TEST_CHECK(test_flashlog_flush() == 1U);
+	TEST_CHECK(test_flashlog_flush() == 1U);
+	TEST_CHECK((flashlog.program_errors == 2U) && (flashlog.errors == 0U) && (flashlog.pages == 0U));
+
+	// A record which needs a new page is dropped
+	while (flashlog.program_errors == 2U)
+	{
+		test_flashlog_append();
+	}
+	TEST_CHECK(flashlog.errors == 1U);
+
+	sim.fail_program = false;
+	TEST_CHECK(test_flashlog_flush() == 0U);
+	TEST_CHECK((flashlog.pages == 1U) && (flashlog.skipped == 0U));
+	TEST_CHECK(test_flashlog_check() == (record_count - 1U));
+}
+
+/* Random power cuts while the log is written */
+static void test_flashlog_power_cuts(void)
+{
+	uint32_t read = 0;
+
+	Sim_FlashInit(&sim, memory, TEST_SECTOR_SIZE, TEST_SECTORS);
+	memset(durable, 0, sizeof(durable));
+	record_count = 0;
+
+	for (uint32_t cut = 0; (cut < TEST_CUTS) && (errors == 0U); cut++)
+	{
+		Sim_FlashPowerOn(&sim, SIM_FLASH_NO_CUT);
+		test_flashlog_boot();
+		read += test_flashlog_check();
+
+		// Up to 3 turns of the ring before the cut
+		sim.cut = test_random() % (3U * (TEST_SECTOR_SIZE / SIM_FLASH_WORD_SIZE) * TEST_SECTORS);
+		while ((sim.powered) && (record_count < (TEST_RECORDS_MAX - 1U)))
+		{
+			test_flashlog_append();
+			if ((test_random() % 32U) == 0U)
+			{
+				(void)test_flashlog_flush();
+			}
+		}
+	}
+
+	TEST_CHECK(sim.cuts == TEST_CUTS);
+	TEST_CHECK(record_count < (TEST_RECORDS_MAX - 1U));
+
+	printf("test_flashlog: %lu power cuts, %lu records appended, %lu read back after the cuts\n",
+	       (unsigned long)sim.cuts, (unsigned long)record_count, (unsigned long)read);
+}
+
+/* A log kept in a file survives the process: it is found again on a RAM that lost it */
+static void test_flashlog_file(const char *name)
+{
+	uint32_t pages_per_turn = (TEST_SECTOR_SIZE / TEST_PAGE_SIZE) * TEST_SECTORS;
+
+	(void)remove(name);
+	TEST_CHECK(Sim_FlashOpen(&sim, memory, TEST_SECTOR_SIZE, TEST_SECTORS, name));
+	memset(durable, 0, sizeof(durable));
+	record_count = 0;
+	test_flashlog_boot();
+
+	// More than a turn of the ring, and a power cut in the middle of a page
+	while (flashlog.pages < (pages_per_turn + 3U))
+	{
+		test_flashlog_append();
+	}
+	TEST_CHECK(test_flashlog_flush() == 0U);
+	sim.cut = 2U;
+	while (sim.powered)
+	{
+		test_flashlog_append();
+		(void)test_flashlog_flush();
+	}
+	Sim_FlashClose(&sim);
+
+	// Next run: the memory comes from the file only
+	memset(memory, 0, sizeof(memory));
+	TEST_CHECK(Sim_FlashOpen(&sim, memory, TEST_SECTOR_SIZE, TEST_SECTORS, name));
+	test_flashlog_boot();
+	TEST_CHECK(test_flashlog_check() != 0U);
+
+	// The log goes on after the records found
+	test_flashlog_append();
+	TEST_CHECK(test_flashlog_flush() == 0U);
+	Sim_FlashClose(&sim);
+	memset(memory, 0, sizeof(memory));
+	TEST_CHECK(Sim_FlashOpen(&sim, memory, TEST_SECTOR_SIZE, TEST_SECTORS, name));
+	test_flashlog_boot();
+	TEST_CHECK(test_flashlog_check() != 0U);
+	TEST_CHECK(seen[record_count] == check_count);
+	Sim_FlashClose(&sim);
+
+	// A file of another geometry is an erased memory
+	memset(memory, 0, sizeof(memory));
+	TEST_CHECK(Sim_FlashOpen(&sim, memory, TEST_SECTOR_SIZE, TEST_SECTORS / 2U, name));
+	TEST_CHECK((memory[0] == 0xFFU) && (memory[(TEST_SECTORS / 2U) * TEST_SECTOR_SIZE] == 0U));
+	Sim_FlashClose(&sim);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *file_name = (argc > 1) ? argv[1] : "build/flashlog.bin";
+
+	test_flashlog_geometry();
+	test_flashlog_erases();
+	test_flashlog_program_errors();
+	test_flashlog_file(file_name);
+	test_flashlog_power_cuts();
+
+	printf("test_flashlog: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
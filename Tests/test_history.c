@@ -0,0 +1,196 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_history.c                                                                            */
+/*                                                                                           */
+/* Host test of the per-sensor history: raw timestamps and minute / hour aggregates          */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20_history.h"
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+#define TEST_CAPACITY	100U
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static uint32_t test_seed = 5U;
+
+static int16_t values[TEST_CAPACITY];
+static uint16_t deltas[TEST_CAPACITY];
+static DS18B20_Aggregate_t minutes[8];
+static DS18B20_Aggregate_t hours[4];
+static DS18B20_History_t history;
+static uint32_t timestamps[TEST_CAPACITY];	// Of the samples added, index 0 being the newest
+
+/* Pseudo-random number, the same on every host */
+static uint32_t test_random(void)
+{
+	test_seed = (test_seed * 1103515245U) + 12345U;
+
+	return test_seed >> 16;
+}
+
+/* Start an empty history */
+static void test_history_init(void)
+{
+	TEST_CHECK(DS18B20_History_Init(&history, values, deltas, TEST_CAPACITY, minutes, 8, hours, 4) == OK);
+}
+
+/* Add a sample, and keep its timestamp */
+static void test_history_add(uint32_t timestamp, int16_t value, uint8_t status)
+{
+	DS18B20_Sample_t sample = {0};
+
+	sample.timestamp = timestamp;
+	sample.value = value;
+	sample.status = status;
+	DS18B20_History_Add(&history, &sample);
+
+	if (status == DS18B20_SAMPLE_OK)
+	{
+		for (uint16_t i = TEST_CAPACITY - 1U; i > 0U; i--)
+		{
+			timestamps[i] = timestamps[i - 1U];
+		}
+		timestamps[0] = timestamp;
+	}
+}
+
+/* Largest error of the rebuilt timestamps, UINT32_MAX if one is lost or later than the real one */
+static uint32_t test_history_error(uint16_t count)
+{
+	uint32_t result = 0;
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		int16_t value = 0;
+		uint32_t timestamp = 0;
+
+		if ((DS18B20_History_Get(&history, i, &value, &timestamp) == false)
+			|| (timestamp == DS18B20_HISTORY_NO_TIME) || (timestamp > timestamps[i]))
+		{
+			result = UINT32_MAX;
+		}
+		else if ((timestamps[i] - timestamp) > result)
+		{
+			result = timestamps[i] - timestamp;
+		}
+	}
+
+	return result;
+}
+
+/* Samples every few seconds: exact timestamps */
+static void test_history_fast(void)
+{
+	uint32_t time = 5000U;
+
+	test_history_init();
+	for (uint16_t i = 0; i < 150U; i++)
+	{
+		time += 1000U + (test_random() % 31000U);
+		test_history_add(time, (int16_t)i, DS18B20_SAMPLE_OK);
+	}
+	TEST_CHECK(history.count == TEST_CAPACITY);
+	TEST_CHECK(test_history_error(TEST_CAPACITY) == 0U);
+}
+
+/* Slow sensors, up to hours apart: timestamps within a second, the error never adding up */
+static void test_history_slow(void)
+{
+	uint32_t time = 123456U;
+
+	test_history_init();
+	for (uint16_t i = 0; i < 150U; i++)
+	{
+		// Mixed with a few short deltas, and one just within the span
+		uint32_t delta = ((i % 7U) == 3U) ? (test_random() % 32000U) : (32768U + (test_random() * 97U));
+
+		time += (i == 120U) ? (DS18B20_HISTORY_SPAN_MS - 1U) : delta;
+		test_history_add(time, (int16_t)i, DS18B20_SAMPLE_OK);
+	}
+	TEST_CHECK(test_history_error(TEST_CAPACITY) < 1000U);
+
+	// Beyond the span, or a missing sample: the older times are lost
+	int16_t value = 0;
+	uint32_t timestamp = 0;
+
+	test_history_add(time + DS18B20_HISTORY_SPAN_MS, 1, DS18B20_SAMPLE_OK);
+	TEST_CHECK(test_history_error(1) == 0U);
+	TEST_CHECK((DS18B20_History_Get(&history, 1, &value, &timestamp)) && (timestamp == DS18B20_HISTORY_NO_TIME));
+
+	test_history_add(time + DS18B20_HISTORY_SPAN_MS + 60000U, 2, DS18B20_SAMPLE_CRC_ERROR);
+	test_history_add(time + DS18B20_HISTORY_SPAN_MS + 120000U, 3, DS18B20_SAMPLE_OK);
+	TEST_CHECK(test_history_error(1) == 0U);
+	TEST_CHECK((DS18B20_History_Get(&history, 1, &value, &timestamp)) && (value == 1));
+	TEST_CHECK(timestamp == DS18B20_HISTORY_NO_TIME);
+}
+
+/* Across the wrap of the HAL tick */
+static void test_history_wrap(void)
+{
+	int16_t value = 0;
+	uint32_t timestamp = 0;
+
+	test_history_init();
+	test_history_add(UINT32_MAX - 20000U, 1, DS18B20_SAMPLE_OK);
+	test_history_add(UINT32_MAX - 5000U, 2, DS18B20_SAMPLE_OK);
+	test_history_add(10000U, 3, DS18B20_SAMPLE_OK);			// 15 s later: exact
+	test_history_add(130000U, 4, DS18B20_SAMPLE_OK);		// 2 minutes later
+	TEST_CHECK(test_history_error(4) < 1000U);
+
+	test_history_init();
+	test_history_add(UINT32_MAX - 60000U, 1, DS18B20_SAMPLE_OK);
+	test_history_add(60000U, 2, DS18B20_SAMPLE_OK);			// 2 minutes, across the wrap
+	TEST_CHECK((DS18B20_History_Get(&history, 1, &value, &timestamp)) && (timestamp == DS18B20_HISTORY_NO_TIME));
+}
+
+/* Minute and hour aggregates */
+static void test_history_aggregates(void)
+{
+	DS18B20_Aggregate_t aggregate;
+
+	test_history_init();
+	for (uint32_t second = 0; second < 180U; second += 10U)
+	{
+		test_history_add(DS18B20_HISTORY_HOUR_MS + (second * 1000U), (int16_t)(second / 10U), DS18B20_SAMPLE_OK);
+	}
+
+	// Minutes 60 and 61 closed, 62 in progress
+	TEST_CHECK(DS18B20_History_Minute(&history, 0, &aggregate));
+	TEST_CHECK((aggregate.period == 62U) && (aggregate.count == 6U) && (aggregate.min == 12) && (aggregate.max == 17));
+	TEST_CHECK(DS18B20_History_Minute(&history, 2, &aggregate));
+	TEST_CHECK((aggregate.period == 60U) && (aggregate.mean == 3) && (aggregate.count == 6U));
+	TEST_CHECK(DS18B20_History_Minute(&history, 3, &aggregate) == false);
+	TEST_CHECK(DS18B20_History_Hour(&history, 0, &aggregate));
+	TEST_CHECK((aggregate.period == 1U) && (aggregate.count == 18U) && (aggregate.max == 17));
+}
+
+int main(void)
+{
+	test_history_fast();
+	test_history_slow();
+	test_history_wrap();
+	test_history_aggregates();
+
+	printf("test_history: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,150 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_hotplug.c                                                                            */
+/*                                                                                           */
+/* Host test of the hot-plug detection on the 1-Wire simulator                               */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20_hotplug.h"
+#include "onewire_sim.h"
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+#define TEST_CAPACITY	4U
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static uint32_t added;
+static uint32_t removed;
+static uint16_t event_slot;
+
+static DS18B20_t sensor;
+static DS18B20_Channel_t channels[TEST_CAPACITY];
+static uint64_t ROM_codes[TEST_CAPACITY + 1U];
+static uint16_t index[TEST_CAPACITY];
+static uint32_t seen[DS18B20_HOTPLUG_SEEN_WORDS(TEST_CAPACITY)];
+static DS18B20_RomTable_t table;
+static DS18B20_Hotplug_t hotplug;
+
+/* Count the events */
+static void test_hotplug_event(void *context, DS18B20_HotplugEvent_t event, uint16_t slot, uint64_t ROM_code)
+{
+	(void)context;
+	(void)ROM_code;
+
+	added += (event == DS18B20_DEVICE_ADDED) ? 1U : 0U;
+	removed += (event == DS18B20_DEVICE_REMOVED) ? 1U : 0U;
+	event_slot = slot;
+}
+
+/* Step until the end of a search pass, returns false if it does not end */
+static bool test_hotplug_pass(void)
+{
+	bool result = false;
+
+	for (uint16_t step = 0; (step < 100U) && (result == false); step++)
+	{
+		result = DS18B20_Hotplug_Step(&hotplug);
+	}
+
+	return result;
+}
+
+/* A new sensor in the slot of a removed one is provisioned, and inherits nothing from it */
+static void test_hotplug_reuse(void)
+{
+	Sim_Reset();
+	uint16_t a = Sim_Add(Sim_RomCode(DS18B20_FAMILY_DS18B20, 1), 400);
+	uint16_t b = Sim_Add(Sim_RomCode(DS18B20_FAMILY_DS18B20, 2), 400);
+
+	TEST_CHECK(test_hotplug_pass());
+	TEST_CHECK((added == 2U) && (table.count == 2U));
+	uint16_t slot = DS18B20_RomTable_Find(&table, Sim_RomCode(DS18B20_FAMILY_DS18B20, 2));
+
+	TEST_CHECK(DS18B20_Provision(&sensor, ROM_codes, 10, 20, 0x5F, false) == OK);
+	TEST_CHECK((Sim_Devices[a].scratchpad[2] == 10U) && (Sim_Devices[b].scratchpad[2] == 10U));
+	channels[slot].accepted = 400;
+	channels[slot].accepted_valid = true;
+	channels[slot].max_rate = 16;
+
+	Sim_Devices[b].present = false;
+	TEST_CHECK(test_hotplug_pass());
+	TEST_CHECK((removed == 1U) && (event_slot == slot));
+	TEST_CHECK((channels[slot].shadow_valid == false) && (channels[slot].accepted_valid == false));
+
+	uint16_t c = Sim_Add(Sim_RomCode(DS18B20_FAMILY_DS18B20, 3), -160);
+	TEST_CHECK(test_hotplug_pass());
+	TEST_CHECK((added == 3U) && (event_slot == slot));
+	TEST_CHECK(ROM_codes[slot] == Sim_RomCode(DS18B20_FAMILY_DS18B20, 3));
+	TEST_CHECK(channels[slot].max_rate == 16U);
+
+	// The shadow of the removed sensor would match: the new one shall still be written
+	TEST_CHECK(DS18B20_Provision(&sensor, ROM_codes, 10, 20, 0x5F, false) == OK);
+	TEST_CHECK((Sim_Devices[c].scratchpad[2] == 10U) && (Sim_Devices[c].scratchpad[3] == 20U));
+	TEST_CHECK(Sim_Devices[c].scratchpad[4] == 0x5FU);
+}
+
+/* A device whose ROM code always fails its CRC does not stop the passes */
+static void test_hotplug_crc(void)
+{
+	uint32_t removed_before = removed;
+	uint32_t added_before = added;
+
+	// The devices of the previous test leave, a good one and a damaged one arrive
+	Sim_Reset();
+	uint16_t d = Sim_Add(Sim_RomCode(DS18B20_FAMILY_DS18B20, 4), 400);
+	(void)Sim_Add(Sim_RomCode(DS18B20_FAMILY_DS18B20, 5) ^ 1ULL, 400);
+
+	TEST_CHECK(test_hotplug_pass());
+	TEST_CHECK((added == (added_before + 1U)) && (removed == (removed_before + 2U)));
+	TEST_CHECK((table.count == 1U) && (hotplug.skipped == 1U));
+	TEST_CHECK(DS18B20_RomTable_Find(&table, Sim_RomCode(DS18B20_FAMILY_DS18B20, 4)) != DS18B20_ROMTABLE_NONE);
+
+	// The good one leaves: still reported, the damaged one being skipped again
+	Sim_Devices[d].present = false;
+	TEST_CHECK(test_hotplug_pass());
+	TEST_CHECK((removed == (removed_before + 3U)) && (table.count == 0U));
+	TEST_CHECK(hotplug.skipped == 2U);
+	TEST_CHECK(hotplug.restarts == 0U);
+}
+
+int main(void)
+{
+	sensor.timer_instance = SIM_TIMER;
+	sensor.gpio_port = SIM_BUS_PORT;
+	sensor.channels = channels;
+	sensor.channel_count = TEST_CAPACITY;
+	TEST_CHECK(DS18B20_Init(&sensor) == OK);
+
+	ROM_codes[0] = 0;
+	TEST_CHECK(DS18B20_RomTable_Init(&table, ROM_codes, index, TEST_CAPACITY) == OK);
+	hotplug.sensor = &sensor;
+	hotplug.table = &table;
+	hotplug.seen = seen;
+	hotplug.callback = test_hotplug_event;
+	TEST_CHECK(DS18B20_Hotplug_Init(&hotplug) == OK);
+
+	test_hotplug_reuse();
+	test_hotplug_crc();
+
+	printf("test_hotplug: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
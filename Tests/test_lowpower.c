@@ -0,0 +1,107 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_lowpower.c                                                                           */
+/*                                                                                           */
+/* Host test of the Stop mode wait, on the simulated LPTIM                                   */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20_lowpower.h"
+#include "hal_sim.h"
+#include "onewire_sim.h"
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static LPTIM_HandleTypeDef hlptim;
+static DS18B20_LowPower_t low_power;
+
+/* LPTIM compare match interrupt */
+static void test_lowpower_match(void)
+{
+	DS18B20_LowPower_WakeUp(&low_power);
+}
+
+/* Wait, and check the time really spent and the time seen by the HAL tick */
+static void test_lowpower_wait(uint32_t hz, uint32_t ms, uint32_t periods)
+{
+	uint64_t start = Sim_Micros();
+	uint32_t tick = HAL_GetTick();
+
+	low_power.lptim_clock_hz = hz;
+	Sim_LptimHz = hz;
+	Sim_StopPeriods = 0;
+
+	DS18B20_StopWait(&low_power, ms);
+
+	uint32_t spent = (uint32_t)((Sim_Micros() - start) / 1000U);
+	uint32_t counted = HAL_GetTick() - tick;
+
+	if ((spent < ms) || (spent > (ms + 3U)) || (counted + 1U < spent) || (counted > spent + 1U)
+	    || (Sim_StopPeriods != periods))
+	{
+		printf("%lu Hz, %lu ms: %lu ms spent, %lu ms counted, %lu Stop periods\n", (unsigned long)hz,
+		       (unsigned long)ms, (unsigned long)spent, (unsigned long)counted, (unsigned long)Sim_StopPeriods);
+		errors++;
+	}
+}
+
+int main(void)
+{
+	static DS18B20_t sensor = {0};
+	uint64_t ROM_codes_array[2];
+	int16_t value = 0;
+
+	Sim_Reset();
+	Sim_OnLptimMatch = test_lowpower_match;
+	Sim_WakeupTicks = 2;
+	low_power.hlptim = &hlptim;
+
+	// LSI: one period is enough for a 12-bit conversion
+	test_lowpower_wait(32000U, 750U, 1U);
+
+	// Longer than the 16-bit counter: several periods, 751 ms / 61440 µs
+	test_lowpower_wait(1000000U, 750U, 13U);
+	test_lowpower_wait(32768U, 10000U, 6U);
+
+	// No LPTIM clock: Sleep mode
+	test_lowpower_wait(0U, 20U, 0U);
+
+	// Conversion wait of a bus
+	ROM_codes_array[0] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 1);
+	ROM_codes_array[1] = 0;
+	Sim_Add(ROM_codes_array[0], 408);
+	sensor.timer_instance = SIM_TIMER;
+	sensor.gpio_port = SIM_BUS_PORT;
+	sensor.conversion_wait = DS18B20_StopWait;
+	sensor.wait_context = &low_power;
+	low_power.lptim_clock_hz = 32000U;
+	Sim_LptimHz = 32000U;
+
+	TEST_CHECK(DS18B20_Init(&sensor) == OK);
+	TEST_CHECK(DS18B20_StartConversion(&sensor, 0ULL) == 0U);
+	TEST_CHECK(DS18B20_WaitConversion(&sensor, DS18B20_ConversionTime(&sensor)) == 0U);
+	TEST_CHECK(DS18B20_ReadTemperature(&sensor, ROM_codes_array[0], &value) == DS18B20_SAMPLE_OK);
+	TEST_CHECK(value == 408);
+
+	printf("test_lowpower: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
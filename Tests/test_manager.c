@@ -0,0 +1,204 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_manager.c                                                                            */
+/*                                                                                           */
+/* Host test of the manager of buses on the 1-Wire simulator                                 */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ds18b20_manager.h"
+#include "onewire_sim.h"
+
+//!\ The simulated devices all sit on one bus, so each case runs the manager with a single
+//!\ bus. Between two polls, the virtual time advances by 1 ms, as a task would sleep.
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+#define TEST_SENSORS	3U
+#define TEST_POLLS		20000U		// Polls of a case, 1 ms each
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static uint32_t overlaps;			// Conversions started while another one was running
+
+static DS18B20_t sensor;
+static DS18B20_Channel_t channels[TEST_SENSORS + 1U];
+static uint64_t ROM_codes[TEST_SENSORS + 2U];
+static DS18B20_Stats_t stats;
+static DS18B20_Sample_t buffer[64];
+static DS18B20_Ring_t ring;
+static DS18B20_Bus_t bus;
+static DS18B20_Manager_t manager;
+
+/* Check that no other device is converting when one starts */
+static void test_manager_convert(uint16_t index)
+{
+	for (uint16_t i = 0; i < Sim_DeviceCount; i++)
+	{
+		if ((i != index) && (Sim_Devices[i].busy_until > Sim_Micros()))
+		{
+			overlaps++;
+		}
+	}
+}
+
+/* Sensors of a bus, with a free slot between the first two */
+static void test_manager_bus(bool parasite, uint32_t pullup_current_ua)
+{
+	Sim_Reset();
+	Sim_OnConvert = test_manager_convert;
+	overlaps = 0;
+
+	ROM_codes[0] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 1);
+	ROM_codes[1] = DS18B20_FREE_SLOT;
+	ROM_codes[2] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 2);
+	ROM_codes[3] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 3);
+	ROM_codes[4] = 0;
+	for (uint16_t slot = 0; ROM_codes[slot] != 0U; slot++)
+	{
+		if (ROM_codes[slot] != DS18B20_FREE_SLOT)
+		{
+			uint16_t index = Sim_Add(ROM_codes[slot], (int16_t)(320 + slot));
+			Sim_Devices[index].parasite = parasite;
+		}
+	}
+
+	memset(&sensor, 0, sizeof(sensor));
+	memset(channels, 0, sizeof(channels));
+	DS18B20_Stats_Init(&stats);
+	sensor.timer_instance = SIM_TIMER;
+	sensor.gpio_port = SIM_BUS_PORT;
+	sensor.channels = channels;
+	sensor.channel_count = TEST_SENSORS + 1U;
+	sensor.pullup_current_ua = pullup_current_ua;
+	sensor.stats = &stats;
+	TEST_CHECK(DS18B20_Init(&sensor) == OK);
+	TEST_CHECK(sensor.parasite == parasite);
+
+	bus.sensor = &sensor;
+	bus.ROM_codes_array = ROM_codes;
+	TEST_CHECK(DS18B20_Ring_Init(&ring, buffer, 64U));
+	TEST_CHECK(DS18B20_Manager_Init(&manager, &bus, 1U, &ring) == OK);
+}
+
+/* Poll until the bus has done cycles cycles, returns the samples of the last one */
+static uint16_t test_manager_run(uint32_t cycles, DS18B20_Sample_t samples[])
+{
+	uint16_t count = 0;
+
+	for (uint32_t poll = 0; (poll < TEST_POLLS) && (bus.cycles < cycles); poll++)
+	{
+		DS18B20_Sample_t sample;
+
+		(void)DS18B20_Manager_Poll(&manager);
+		while (DS18B20_Ring_Pop(&ring, &sample))
+		{
+			count = (sample.slot == 0U) ? 0U : count;
+			samples[count++] = sample;
+		}
+		Sim_Advance(1000U);
+	}
+
+	return count;
+}
+
+/* Externally powered: one broadcast conversion per cycle, one timestamp for all the samples */
+static void test_manager_broadcast(void)
+{
+	DS18B20_Sample_t samples[TEST_SENSORS + 1U];
+
+	test_manager_bus(false, 0);
+	TEST_CHECK(test_manager_run(2, samples) == TEST_SENSORS);
+	TEST_CHECK(bus.cycles == 2U);
+	TEST_CHECK((Sim_Devices[0].conversions == 2U) && (Sim_Devices[2].conversions == 2U));
+	TEST_CHECK(overlaps == (TEST_SENSORS * (TEST_SENSORS - 1U)));
+	TEST_CHECK((samples[0].slot == 0U) && (samples[1].slot == 2U) && (samples[2].slot == 3U));
+	TEST_CHECK((samples[0].timestamp == samples[1].timestamp) && (samples[1].timestamp == samples[2].timestamp));
+	TEST_CHECK((samples[2].status == DS18B20_SAMPLE_OK) && (samples[2].value == 323));
+}
+
+/* Parasite power for one conversion at a time: the sensors are converted one after the other */
+static void test_manager_staggered(void)
+{
+	DS18B20_Sample_t samples[TEST_SENSORS + 1U];
+
+	test_manager_bus(true, DS18B20_CONVERSION_CURRENT_UA);
+	TEST_CHECK(DS18B20_GroupSize(&sensor) == 1U);
+	TEST_CHECK(test_manager_run(2, samples) == TEST_SENSORS);
+	TEST_CHECK(bus.cycles == 2U);
+	TEST_CHECK(overlaps == 0U);
+	for (uint16_t i = 0; i < TEST_SENSORS; i++)
+	{
+		TEST_CHECK(Sim_Devices[i].conversions == 2U);
+		TEST_CHECK(samples[i].status == DS18B20_SAMPLE_OK);
+	}
+	TEST_CHECK(samples[1].timestamp > samples[0].timestamp);
+	TEST_CHECK(bus.cycle_time_ms >= (TEST_SENSORS * DS18B20_ConversionTime(&sensor)));
+
+	// A missing sensor is reported as such, and the others are still read
+	Sim_Devices[1].present = false;
+	TEST_CHECK(test_manager_run(3, samples) == TEST_SENSORS);
+	TEST_CHECK((samples[1].slot == 2U) && (samples[1].status != DS18B20_SAMPLE_OK));
+	TEST_CHECK((samples[0].status == DS18B20_SAMPLE_OK) && (samples[2].status == DS18B20_SAMPLE_OK));
+
+	// Enough current for all of them: back to one broadcast conversion
+	test_manager_bus(true, TEST_SENSORS * DS18B20_CONVERSION_CURRENT_UA);
+	TEST_CHECK(test_manager_run(1, samples) == TEST_SENSORS);
+	TEST_CHECK(overlaps == ((TEST_SENSORS * (TEST_SENSORS - 1U)) / 2U));
+}
+
+/* No presence pulse: one retry per conversion time, not one per poll */
+static void test_manager_dead_bus(void)
+{
+	DS18B20_Sample_t samples[TEST_SENSORS + 1U];
+	DS18B20_Counters_t counters;
+
+	test_manager_bus(false, 0);
+	for (uint16_t i = 0; i < Sim_DeviceCount; i++)
+	{
+		Sim_Devices[i].present = false;
+	}
+
+	uint32_t start = HAL_GetTick();
+	TEST_CHECK(test_manager_run(1, samples) == 0U);
+	uint32_t elapsed = HAL_GetTick() - start;
+
+	TEST_CHECK(DS18B20_Stats_Snapshot(&stats, &counters));
+	TEST_CHECK(counters.retries != 0U);
+	TEST_CHECK(counters.retries <= ((elapsed / DS18B20_ConversionTime(&sensor)) + 1U));
+
+	// Back on the bus: the next retry converts
+	for (uint16_t i = 0; i < Sim_DeviceCount; i++)
+	{
+		Sim_Devices[i].present = true;
+	}
+	TEST_CHECK(test_manager_run(1, samples) == TEST_SENSORS);
+}
+
+int main(void)
+{
+	test_manager_broadcast();
+	test_manager_staggered();
+	test_manager_dead_bus();
+
+	printf("test_manager: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
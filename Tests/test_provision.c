@@ -0,0 +1,77 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_provision.c                                                                          */
+/*                                                                                           */
+/* Host test of the provisioning of a mixed bus on the 1-Wire simulator                      */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20.h"
+#include "onewire_sim.h"
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+
+int main(void)
+{
+	static DS18B20_t sensor = {0};
+	static DS18B20_Channel_t channels[2];
+	uint64_t ROM_codes_array[3];
+
+	Sim_Reset();
+	ROM_codes_array[0] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 1);
+	ROM_codes_array[1] = Sim_RomCode(DS18B20_FAMILY_DS18S20, 2);
+	ROM_codes_array[2] = 0;
+	uint16_t b = Sim_Add(ROM_codes_array[0], 400);
+	uint16_t s = Sim_Add(ROM_codes_array[1], 400);
+
+	sensor.timer_instance = SIM_TIMER;
+	sensor.gpio_port = SIM_BUS_PORT;
+	sensor.channels = channels;
+	sensor.channel_count = 2;
+	TEST_CHECK(DS18B20_Init(&sensor) == OK);
+
+	// Both differ: one broadcast write and copy
+	TEST_CHECK(DS18B20_Provision(&sensor, ROM_codes_array, 10, 20, 0x5F, true) == OK);
+	TEST_CHECK((Sim_Devices[b].copies == 1U) && (Sim_Devices[s].copies == 1U));
+	TEST_CHECK((Sim_Devices[s].scratchpad[2] == 10U) && (Sim_Devices[s].scratchpad[3] == 20U));
+	TEST_CHECK(Sim_Devices[s].scratchpad[4] == 0xFFU);
+	TEST_CHECK(Sim_Devices[b].scratchpad[4] == 0x5FU);
+
+	// Nothing changed: the reserved byte 4 of the DS18S20 does not count
+	TEST_CHECK(DS18B20_Provision(&sensor, ROM_codes_array, 10, 20, 0x5F, true) == OK);
+	channels[0].shadow_valid = false;
+	channels[1].shadow_valid = false;
+	TEST_CHECK(DS18B20_Provision(&sensor, ROM_codes_array, 10, 20, 0x5F, true) == OK);
+	TEST_CHECK((Sim_Devices[b].copies == 1U) && (Sim_Devices[s].copies == 1U));
+
+	// Written on its own: TH and TL only
+	TEST_CHECK(DS18B20_WriteSlotID(&sensor, ROM_codes_array[1], 0x1234) == DS18B20_SAMPLE_OK);
+	TEST_CHECK(Sim_Devices[s].written == 2U);
+	TEST_CHECK((Sim_Devices[s].scratchpad[2] == 0x12U) && (Sim_Devices[s].scratchpad[3] == 0x34U));
+	TEST_CHECK(DS18B20_WriteSlotID(&sensor, ROM_codes_array[0], 0x5678) == DS18B20_SAMPLE_OK);
+	TEST_CHECK(Sim_Devices[b].written == 3U);
+	TEST_CHECK(Sim_Devices[b].scratchpad[4] == 0x5FU);
+
+	printf("test_provision: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
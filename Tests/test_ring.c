@@ -0,0 +1,114 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_ring.c                                                                               */
+/*                                                                                           */
+/* Host test of the SPSC ring: one producer thread and one consumer thread                   */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#include "ds18b20_ring.h"
+
+//!\ The producer pushes a counter in the timestamp of the samples, and retries while the
+//!\ ring is full. The consumer checks that it pops every value once, in order. A small
+//!\ ring keeps both sides on the full / empty boundaries, where the races would be.
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_RING_SIZE		8U
+#define TEST_RING_SAMPLES	2000000UL
+
+/*********************************** DEFINE END ******************************************** */
+
+static DS18B20_Sample_t buffer[TEST_RING_SIZE];
+static DS18B20_Ring_t ring;
+
+/* Producer thread: pushes the counter, waits while the ring is full */
+static void *test_ring_producer(void *argument)
+{
+	(void)argument;
+
+	for (uint32_t count = 0; count < TEST_RING_SAMPLES; count++)
+	{
+		DS18B20_Sample_t sample = { .timestamp = count, .slot = (uint16_t)count,
+		                            .value = (int16_t)(count * 7U), .status = DS18B20_SAMPLE_OK };
+
+		while (DS18B20_Ring_Push(&ring, &sample) == false)
+		{
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+/* Consumer thread: pops the counter, checks order and content */
+static void *test_ring_consumer(void *argument)
+{
+	uint32_t *errors = (uint32_t *)argument;
+	uint32_t expected = 0;
+	DS18B20_Sample_t sample;
+
+	while (expected < TEST_RING_SAMPLES)
+	{
+		if (DS18B20_Ring_Pop(&ring, &sample))
+		{
+			if ((sample.timestamp != expected) || (sample.slot != (uint16_t)expected)
+			    || (sample.value != (int16_t)(expected * 7U)))
+			{
+				if (*errors < 10U)
+				{
+					printf("expected %lu, got %lu\n", (unsigned long)expected, (unsigned long)sample.timestamp);
+				}
+
+				(*errors)++;
+			}
+
+			// A lost or duplicated record shifts the sequence, only count it once
+			expected = sample.timestamp + 1U;
+		}
+		else
+		{
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+int main(void)
+{
+	uint32_t errors = 0;
+	pthread_t producer;
+	pthread_t consumer;
+	DS18B20_Sample_t sample;
+
+	if (DS18B20_Ring_Init(&ring, buffer, TEST_RING_SIZE) == false)
+	{
+		printf("init failed\n");
+		return 1;
+	}
+
+	pthread_create(&consumer, NULL, test_ring_consumer, &errors);
+	pthread_create(&producer, NULL, test_ring_producer, NULL);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+
+	if (DS18B20_Ring_Pop(&ring, &sample) || (DS18B20_Ring_Count(&ring) != 0U))
+	{
+		printf("ring not empty at the end\n");
+		errors++;
+	}
+
+	printf("test_ring: %lu samples, %lu full ring retries, %lu errors\n", (unsigned long)TEST_RING_SAMPLES,
+	       (unsigned long)ring.overruns, (unsigned long)errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
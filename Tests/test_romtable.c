@@ -0,0 +1,201 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_romtable.c                                                                           */
+/*                                                                                           */
+/* Host test of the sorted ROM tables, against the order of a search of the simulated bus    */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20_romtable.h"
+#include "onewire_sim.h"
+
+//!\ The reference order is the one of DS18B20_SearchNext on the simulated devices. The ROM
+//!\ codes are then inserted in this order and in a random one, in a full and in a compact
+//!\ table: the index shall always list them in search order.
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+#define TEST_DEVICES	48U
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static uint32_t test_seed = 3U;
+
+static uint64_t searched[TEST_DEVICES];		// ROM codes in search order
+static uint64_t ROM_codes[TEST_DEVICES + 1U];
+static uint8_t serials[TEST_DEVICES][DS18B20_SERIAL_SIZE];
+static uint16_t index[TEST_DEVICES];
+static DS18B20_RomTable_t table;
+
+/* Pseudo-random number, the same on every host */
+static uint32_t test_random(void)
+{
+	test_seed = (test_seed * 1103515245U) + 12345U;
+
+	return test_seed >> 16;
+}
+
+/* The index lists the ROM codes of the table in search order */
+static bool test_romtable_sorted(void)
+{
+	bool result = true;
+	uint16_t position = 0;
+
+	for (uint16_t i = 0; i < TEST_DEVICES; i++)
+	{
+		uint16_t handle = DS18B20_RomTable_Find(&table, searched[i]);
+
+		if (handle != DS18B20_ROMTABLE_NONE)
+		{
+			result = (result) && (position < table.count) && (table.index[position] == handle)
+					 && (DS18B20_RomTable_Get(&table, handle) == searched[i]);
+			position++;
+		}
+	}
+
+	return (result) && (position == table.count);
+}
+
+/* Random insertions, lookups and removals in an empty table */
+static void test_romtable_shuffled(void)
+{
+	uint16_t order[TEST_DEVICES];
+	uint16_t handles[TEST_DEVICES];
+
+	for (uint16_t i = 0; i < TEST_DEVICES; i++)
+	{
+		order[i] = i;
+	}
+	for (uint16_t i = TEST_DEVICES - 1U; i > 0U; i--)
+	{
+		uint16_t j = (uint16_t)(test_random() % (i + 1U));
+		uint16_t swap = order[i];
+
+		order[i] = order[j];
+		order[j] = swap;
+	}
+
+	// Out of order: the handles follow the insertions, the index the search order
+	for (uint16_t i = 0; i < TEST_DEVICES; i++)
+	{
+		handles[order[i]] = DS18B20_RomTable_Add(&table, searched[order[i]]);
+		TEST_CHECK(handles[order[i]] == i);
+	}
+	TEST_CHECK(table.count == TEST_DEVICES);
+	TEST_CHECK(test_romtable_sorted());
+
+	// Already there, and table full
+	TEST_CHECK(DS18B20_RomTable_Add(&table, searched[5]) == handles[5]);
+	TEST_CHECK(DS18B20_RomTable_Add(&table, Sim_RomCode(DS18B20_FAMILY_DS18B20, 0xABCDEFULL))
+	           == DS18B20_ROMTABLE_NONE);
+
+	// One in three removed: the others keep their handle
+	for (uint16_t i = 0; i < TEST_DEVICES; i += 3U)
+	{
+		TEST_CHECK(DS18B20_RomTable_Remove(&table, handles[i]));
+		TEST_CHECK(DS18B20_RomTable_Remove(&table, handles[i]) == false);
+	}
+	for (uint16_t i = 0; i < TEST_DEVICES; i++)
+	{
+		uint16_t expected = ((i % 3U) == 0U) ? DS18B20_ROMTABLE_NONE : handles[i];
+
+		TEST_CHECK(DS18B20_RomTable_Find(&table, searched[i]) == expected);
+	}
+	TEST_CHECK(table.count == (TEST_DEVICES - ((TEST_DEVICES + 2U) / 3U)));
+	TEST_CHECK(test_romtable_sorted());
+
+	// Inserted again in reverse order: each takes the lowest free handle
+	for (uint16_t i = TEST_DEVICES; i > 0U; i--)
+	{
+		if (((i - 1U) % 3U) == 0U)
+		{
+			uint16_t lowest = 0;
+
+			while (DS18B20_RomTable_Get(&table, lowest) != DS18B20_FREE_SLOT)
+			{
+				lowest++;
+			}
+			TEST_CHECK(DS18B20_RomTable_Add(&table, searched[i - 1U]) == lowest);
+		}
+	}
+	TEST_CHECK(table.count == TEST_DEVICES);
+	TEST_CHECK(test_romtable_sorted());
+}
+
+int main(void)
+{
+	onewire_search_state_t search;
+	DS18B20_t sensor = {0};
+	uint64_t ROM_code = 0;
+	uint16_t found = 0;
+
+	Sim_Reset();
+	for (uint16_t i = 0; i < TEST_DEVICES; i++)
+	{
+		uint64_t serial = ((uint64_t)test_random() << 32) | ((uint64_t)test_random() << 16) | test_random();
+
+		(void)Sim_Add(Sim_RomCode(DS18B20_FAMILY_DS18B20, serial & 0xFFFFFFFFFFFFULL), 400);
+	}
+
+	sensor.timer_instance = SIM_TIMER;
+	sensor.gpio_port = SIM_BUS_PORT;
+	TEST_CHECK(DS18B20_Init(&sensor) == OK);
+	DS18B20_SearchInit(&search);
+	while ((found < TEST_DEVICES) && (DS18B20_SearchNext(&sensor, &search, &ROM_code) == DS18B20_SEARCH_FOUND))
+	{
+		searched[found++] = ROM_code;
+	}
+	TEST_CHECK(found == TEST_DEVICES);
+
+	// Full table initialized with the result of a search, then with a duplicate
+	for (uint16_t i = 0; i < TEST_DEVICES; i++)
+	{
+		ROM_codes[i] = searched[i];
+	}
+	TEST_CHECK(DS18B20_RomTable_Init(&table, ROM_codes, index, TEST_DEVICES) == OK);
+	TEST_CHECK((table.count == TEST_DEVICES) && (ROM_codes[TEST_DEVICES] == 0ULL));
+	for (uint16_t i = 0; i < TEST_DEVICES; i++)
+	{
+		TEST_CHECK((DS18B20_RomTable_Find(&table, searched[i]) == i) && (index[i] == i));
+	}
+	TEST_CHECK(DS18B20_RomTable_Find(&table, Sim_RomCode(DS18B20_FAMILY_DS18B20, 0xABCDEFULL))
+	           == DS18B20_ROMTABLE_NONE);
+
+	ROM_codes[7] = searched[3];
+	ROM_codes[9] = 0;
+	TEST_CHECK(DS18B20_RomTable_Init(&table, ROM_codes, index, TEST_DEVICES) == OK);
+	TEST_CHECK((table.count == 8U) && (ROM_codes[7] == DS18B20_FREE_SLOT));
+	TEST_CHECK((ROM_codes[9] == DS18B20_FREE_SLOT) && (ROM_codes[TEST_DEVICES] == 0ULL));
+	TEST_CHECK(test_romtable_sorted());
+
+	// Empty full table
+	ROM_codes[0] = 0;
+	TEST_CHECK(DS18B20_RomTable_Init(&table, ROM_codes, index, TEST_DEVICES) == OK);
+	TEST_CHECK(table.count == 0U);
+	test_romtable_shuffled();
+
+	// Compact table, which computes the CRC again, and holds a single family
+	TEST_CHECK(DS18B20_RomTable_InitCompact(&table, serials, index, TEST_DEVICES, DS18B20_FAMILY_DS18B20) == OK);
+	TEST_CHECK(DS18B20_RomTable_Add(&table, Sim_RomCode(DS18B20_FAMILY_DS18S20, 1)) == DS18B20_ROMTABLE_NONE);
+	test_romtable_shuffled();
+
+	printf("test_romtable: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,137 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_rtos.c                                                                               */
+/*                                                                                           */
+/* Host test of the driver task, on the FreeRTOS stand-in and the 1-Wire simulator           */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20_rtos.h"
+#include "onewire_sim.h"
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+
+int main(void)
+{
+	static DS18B20_t sensor = {0};
+	static DS18B20_Stats_t stats;
+	static DS18B20_Driver_t driver = {0};
+	DS18B20_Counters_t counters;
+	uint64_t ROM_codes_array[4];
+	int16_t value = 0;
+	int16_t values[3] = {0};
+	uint8_t statuses[3] = {0};
+
+	Sim_Reset();
+	ROM_codes_array[0] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 1);
+	ROM_codes_array[1] = DS18B20_FREE_SLOT;
+	ROM_codes_array[2] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 2);
+	ROM_codes_array[3] = 0;
+	Sim_Add(ROM_codes_array[0], 408);	// 25.5°C
+	Sim_Add(ROM_codes_array[2], 480);	// 30°C
+
+	sensor.timer_instance = SIM_TIMER;
+	sensor.gpio_port = SIM_BUS_PORT;
+	DS18B20_Stats_Init(&stats);
+	sensor.stats = &stats;
+	TEST_CHECK(DS18B20_Init(&sensor) == OK);
+
+	driver.sensor = &sensor;
+	driver.ROM_codes_array = ROM_codes_array;
+	TEST_CHECK(DS18B20_RTOS_Start(&driver, 1, 256, 4) == OK);
+	TEST_CHECK(driver.slot_count == 3U);
+
+	// 9 bits, so that a conversion takes 94 ms
+	DS18B20_Request_t config = { .type = DS18B20_REQUEST_CONFIG, .client = xTaskGetCurrentTaskHandle(),
+	                             .sequence = 0xA5, .slot = DS18B20_ALL_SLOTS, .resolution = 9, .th = 75, .tl = 70 };
+	uint32_t notification = 0;
+	TEST_CHECK(DS18B20_RTOS_Post(&driver, &config, portMAX_DELAY) == pdPASS);
+	TEST_CHECK(xTaskNotifyWait(0, UINT32_MAX, &notification, 1000) == pdTRUE);
+	TEST_CHECK(DS18B20_RTOS_SEQUENCE(notification) == 0xA5U);
+	TEST_CHECK(DS18B20_RTOS_STATUS(notification) == DS18B20_SAMPLE_OK);
+	TEST_CHECK(sensor.resolution == 9U);
+
+	// One sensor, the conversion is counted in the statistics
+	TEST_CHECK(DS18B20_RTOS_Read(&driver, 0, &value, 1000) == DS18B20_SAMPLE_OK);
+	TEST_CHECK(value == 408);
+	TEST_CHECK(DS18B20_Stats_Snapshot(&stats, &counters));
+	TEST_CHECK(counters.conversions == 1U);
+	TEST_CHECK(counters.conversion_wait_ms >= 94U);
+	TEST_CHECK(counters.busy_wait_ms == 0U);
+
+	// Free slot and slot out of the array: answered without a conversion
+	TEST_CHECK(DS18B20_RTOS_Read(&driver, 1, &value, 1000) == DS18B20_SAMPLE_NO_PRESENCE);
+	TEST_CHECK(DS18B20_RTOS_Read(&driver, 3, &value, 1000) == DS18B20_SAMPLE_INVALID);
+	TEST_CHECK(DS18B20_RTOS_Read(&driver, 200, &value, 1000) == DS18B20_SAMPLE_INVALID);
+	TEST_CHECK(DS18B20_Stats_Snapshot(&stats, &counters));
+	TEST_CHECK(counters.conversions == 1U);
+
+	// Timeout: the late answer neither writes the value nor is taken by the next read
+	value = -1;
+	TEST_CHECK(DS18B20_RTOS_Read(&driver, 2, &value, 5) == DS18B20_SAMPLE_TIMEOUT);
+	TEST_CHECK(value == -1);
+	TEST_CHECK(DS18B20_RTOS_Read(&driver, 0, &value, 1000) == DS18B20_SAMPLE_OK);
+	TEST_CHECK(value == 408);
+
+	// Whole bus, into arrays that outlive the request
+	DS18B20_Request_t all = { .type = DS18B20_REQUEST_READ, .client = xTaskGetCurrentTaskHandle(),
+	                          .sequence = 7, .slot = DS18B20_ALL_SLOTS, .value = values, .status = statuses };
+	TEST_CHECK(DS18B20_RTOS_Post(&driver, &all, portMAX_DELAY) == pdPASS);
+	TEST_CHECK(xTaskNotifyWait(0, UINT32_MAX, &notification, 1000) == pdTRUE);
+	TEST_CHECK(DS18B20_RTOS_SEQUENCE(notification) == 7U);
+	TEST_CHECK(DS18B20_RTOS_STATUS(notification) == DS18B20_SAMPLE_OK);
+	TEST_CHECK((values[0] == 408) && (statuses[0] == DS18B20_SAMPLE_OK));
+	TEST_CHECK((values[2] == 480) && (statuses[2] == DS18B20_SAMPLE_OK));
+
+	// The notification holds a 12-bit sequence number, and the one of DS18B20_RTOS_Read wraps
+	notification = DS18B20_RTOS_NOTIFICATION(0xABCU, DS18B20_SAMPLE_FAULT, -880);
+	TEST_CHECK((DS18B20_RTOS_SEQUENCE(notification) == 0xABCU) && (DS18B20_RTOS_VALUE(notification) == -880));
+	TEST_CHECK(DS18B20_RTOS_STATUS(notification) == DS18B20_SAMPLE_FAULT);
+	atomic_store(&driver.sequence, DS18B20_RTOS_SEQUENCE_MASK - 1U);
+	for (uint8_t i = 0; i < 3U; i++)
+	{
+		TEST_CHECK((DS18B20_RTOS_Read(&driver, 2, &value, 1000) == DS18B20_SAMPLE_OK) && (value == 480));
+	}
+	TEST_CHECK(atomic_load(&driver.sequence) == (DS18B20_RTOS_SEQUENCE_MASK + 2U));
+
+	// With a cache: a hit is counted only for a request served from it, not for a partial one
+	static DS18B20_Cache_t cache;
+	static DS18B20_CacheEntry_t entries[3];
+	TEST_CHECK(DS18B20_Cache_Init(&cache, &sensor, ROM_codes_array, entries, 10000) == OK);
+	driver.cache = &cache;
+	TEST_CHECK((DS18B20_RTOS_Read(&driver, 0, &value, 1000) == DS18B20_SAMPLE_OK) && (cache.hits == 0U));
+	TEST_CHECK((DS18B20_RTOS_Read(&driver, 2, &value, 1000) == DS18B20_SAMPLE_OK) && (value == 480));
+	TEST_CHECK(cache.hits == 1U);
+
+	entries[2].valid = false;
+	TEST_CHECK(DS18B20_RTOS_Post(&driver, &all, portMAX_DELAY) == pdPASS);
+	TEST_CHECK(xTaskNotifyWait(0, UINT32_MAX, &notification, 1000) == pdTRUE);
+	TEST_CHECK((entries[2].valid) && (cache.hits == 1U));
+	TEST_CHECK(DS18B20_RTOS_Post(&driver, &all, portMAX_DELAY) == pdPASS);
+	TEST_CHECK(xTaskNotifyWait(0, UINT32_MAX, &notification, 1000) == pdTRUE);
+	TEST_CHECK(cache.hits == 2U);
+	driver.cache = NULL;
+
+	printf("test_rtos: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
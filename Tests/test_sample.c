@@ -0,0 +1,153 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_sample.c                                                                             */
+/*                                                                                           */
+/* Host test of DS18B20_GetTemp and of the sanity checks of DS18B20_ReadSample               */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20.h"
+#include "onewire_sim.h"
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static uint32_t waits;
+static DS18B20_Sample_t delivered;
+static uint16_t brownout_device;
+static uint16_t brownouts;
+
+/* Conversion wait hook, sleeping as a task would */
+static void test_sample_wait(void *context, uint32_t ms)
+{
+	(void)context;
+
+	waits++;
+	Sim_Advance(((uint64_t)ms + 1U) * 1000U);
+}
+
+/* Keep the sample of a sweep */
+static void test_sample_deliver(void *context, const DS18B20_Sample_t *sample)
+{
+	(void)context;
+
+	delivered = *sample;
+}
+
+/* Conversion hook: the device browns out during the next conversions, and reads 85°C */
+static void test_sample_brownout(uint16_t index)
+{
+	if ((index == brownout_device) && (brownouts != 0U))
+	{
+		brownouts--;
+		Sim_Devices[index].temperature = DS18B20_POWER_ON_VALUE;
+	}
+	else if (index == brownout_device)
+	{
+		Sim_Devices[index].temperature = 21 * 16;
+	}
+}
+
+int main(void)
+{
+	static DS18B20_t sensor = {0};
+	static DS18B20_Channel_t channels[3];
+	uint64_t ROM_codes_array[4];
+	uint16_t temperature[3] = {0xFFFFU, 0xFFFFU, 0xFFFFU};
+
+	Sim_Reset();
+	ROM_codes_array[0] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 1);
+	ROM_codes_array[1] = DS18B20_FREE_SLOT;
+	ROM_codes_array[2] = Sim_RomCode(DS18B20_FAMILY_DS18B20, 2);
+	ROM_codes_array[3] = 0;
+	uint16_t a = Sim_Add(ROM_codes_array[0], 21 * 16);
+	uint16_t b = Sim_Add(ROM_codes_array[2], -5 * 16);
+
+	sensor.timer_instance = SIM_TIMER;
+	sensor.gpio_port = SIM_BUS_PORT;
+	sensor.channels = channels;
+	sensor.channel_count = 3;
+	TEST_CHECK(DS18B20_Init(&sensor) == OK);
+
+	// One conversion per sensor, waited through the hook, and nothing sent for the free slot
+	sensor.conversion_wait = test_sample_wait;
+	TEST_CHECK(DS18B20_GetTemp(&sensor, ROM_codes_array, temperature) == 0U);
+	TEST_CHECK((temperature[0] == 21U) && (temperature[1] == 0U) && (temperature[2] == (uint16_t)-5));
+	TEST_CHECK((Sim_Devices[a].conversions == 1U) && (Sim_Devices[b].conversions == 1U));
+	TEST_CHECK(waits == 2U);
+	sensor.conversion_wait = NULL;
+
+	// Rate check: 1 °C/s at most. A step of 1.5 °C one second after the last value is suspect,
+	// but the retry ends about 1.75 s after it, and its own timestamp makes the step plausible.
+	ROM_codes_array[1] = 0;
+	Sim_Devices[a].temperature = 400;
+	TEST_CHECK(DS18B20_Sweep(&sensor, ROM_codes_array, test_sample_deliver, NULL) == OK);
+	TEST_CHECK((delivered.status == DS18B20_SAMPLE_OK) && (delivered.value == 400));
+	uint32_t first = delivered.timestamp;
+	channels[0].max_rate = 16;
+
+	Sim_Advance((1000U - DS18B20_ConversionTime(&sensor)) * 1000U);
+	Sim_Devices[a].temperature = 424;
+	TEST_CHECK(DS18B20_Sweep(&sensor, ROM_codes_array, test_sample_deliver, NULL) == OK);
+	TEST_CHECK((delivered.status == DS18B20_SAMPLE_OK) && (delivered.value == 424));
+	TEST_CHECK((delivered.timestamp - first) > 1500U);
+	TEST_CHECK(Sim_Devices[a].conversions == 4U);
+	TEST_CHECK((channels[0].accepted == 424) && (channels[0].accepted_at == delivered.timestamp));
+
+	// A step still too fast after the retry is rejected
+	Sim_Devices[a].temperature = 800;
+	TEST_CHECK(DS18B20_Sweep(&sensor, ROM_codes_array, test_sample_deliver, NULL) == OK);
+	TEST_CHECK(delivered.status == DS18B20_SAMPLE_INVALID);
+
+	// 85°C from a brownout, the retry reads the real value
+	channels[0].max_rate = 0;
+	brownout_device = a;
+	brownouts = 1;
+	Sim_OnConvert = test_sample_brownout;
+	uint32_t conversions = Sim_Devices[a].conversions;
+	TEST_CHECK(DS18B20_Sweep(&sensor, ROM_codes_array, test_sample_deliver, NULL) == OK);
+	TEST_CHECK((delivered.status == DS18B20_SAMPLE_OK) && (delivered.value == 21 * 16));
+	TEST_CHECK(Sim_Devices[a].conversions == (conversions + 2U));
+	Sim_OnConvert = NULL;
+
+	// A real first reading of 85°C, read again by the retry, is accepted
+	channels[0].accepted_valid = false;
+	Sim_Devices[a].temperature = DS18B20_POWER_ON_VALUE;
+	TEST_CHECK(DS18B20_Sweep(&sensor, ROM_codes_array, test_sample_deliver, NULL) == OK);
+	TEST_CHECK((delivered.status == DS18B20_SAMPLE_OK) && (delivered.value == DS18B20_POWER_ON_VALUE));
+	TEST_CHECK((channels[0].accepted_valid) && (channels[0].accepted == DS18B20_POWER_ON_VALUE));
+
+	// Then 85°C is close to the last accepted value: no retry
+	conversions = Sim_Devices[a].conversions;
+	TEST_CHECK(DS18B20_Sweep(&sensor, ROM_codes_array, test_sample_deliver, NULL) == OK);
+	TEST_CHECK((delivered.status == DS18B20_SAMPLE_OK) && (Sim_Devices[a].conversions == (conversions + 1U)));
+
+	// A confirmed step to 85°C faster than the max_rate loses one sample, like any other step
+	channels[0].accepted = 21 * 16;
+	channels[0].max_rate = 16;
+	TEST_CHECK(DS18B20_Sweep(&sensor, ROM_codes_array, test_sample_deliver, NULL) == OK);
+	TEST_CHECK((delivered.status == DS18B20_SAMPLE_INVALID) && (channels[0].accepted == DS18B20_POWER_ON_VALUE));
+	TEST_CHECK(DS18B20_Sweep(&sensor, ROM_codes_array, test_sample_deliver, NULL) == OK);
+	TEST_CHECK((delivered.status == DS18B20_SAMPLE_OK) && (delivered.value == DS18B20_POWER_ON_VALUE));
+
+	printf("test_sample: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
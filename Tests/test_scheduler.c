@@ -0,0 +1,153 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_scheduler.c                                                                          */
+/*                                                                                           */
+/* Host test of the earliest-deadline-first scheduler on the 1-Wire simulator                */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20_scheduler.h"
+#include "onewire_sim.h"
+
+//!\ The HAL tick is the virtual time of the simulator: the test sleeps until the deadline
+//!\ returned by DS18B20_Scheduler_Run with Sim_Advance. Entry i is simulated device i.
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+// More entries than DS18B20_BROADCAST_RATIO times the small batches
+#define TEST_ENTRIES	13U
+#define TEST_WINDOW		50U
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static uint16_t order[TEST_ENTRIES];	// Devices in the order of their conversions
+static uint16_t converted;
+
+static DS18B20_t sensor;
+static DS18B20_ScheduleEntry_t entries[TEST_ENTRIES];
+static DS18B20_Sample_t buffer[32];
+static DS18B20_Ring_t ring;
+static DS18B20_Scheduler_t scheduler;
+
+/* Record the order of the conversions */
+static void test_scheduler_convert(uint16_t index)
+{
+	if (converted < TEST_ENTRIES)
+	{
+		order[converted] = index;
+	}
+	converted++;
+}
+
+/* Sleep until the next deadline if needed and serve it, returns the number of samples of the batch */
+static uint16_t test_scheduler_batch(DS18B20_Sample_t samples[], uint32_t *start)
+{
+	DS18B20_Sample_t sample;
+	uint16_t count = 0;
+
+	converted = 0;
+	*start = HAL_GetTick();
+	uint32_t wait = DS18B20_Scheduler_Run(&scheduler);
+
+	// Nothing was due yet
+	if (wait != 0U)
+	{
+		Sim_Advance((uint64_t)wait * 1000U);
+		converted = 0;
+		*start = HAL_GetTick();
+		TEST_CHECK(DS18B20_Scheduler_Run(&scheduler) == 0U);
+	}
+
+	while ((count < TEST_ENTRIES) && (DS18B20_Ring_Pop(&ring, &sample)))
+	{
+		samples[count++] = sample;
+	}
+
+	return count;
+}
+
+int main(void)
+{
+	DS18B20_Sample_t samples[TEST_ENTRIES];
+	uint32_t start = 0;
+
+	Sim_Reset();
+	for (uint16_t i = 0; i < TEST_ENTRIES; i++)
+	{
+		entries[i].ROM_code = Sim_RomCode(DS18B20_FAMILY_DS18B20, (uint64_t)i + 1U);
+		entries[i].period_ms = 600000U;
+		entries[i].resolution = 12U;
+		(void)Sim_Add(entries[i].ROM_code, (int16_t)(320 + (16 * i)));
+	}
+
+	// Entries 0 to 2 share a deadline within the window, 3 comes later on its own
+	entries[0].period_ms = 2000U;
+	entries[1].period_ms = 2000U;
+	entries[1].resolution = 9U;
+	entries[2].period_ms = 2000U + (TEST_WINDOW / 2U);
+	entries[2].resolution = 10U;
+	entries[3].period_ms = 3000U;
+	entries[3].resolution = 11U;
+
+	sensor.timer_instance = SIM_TIMER;
+	sensor.gpio_port = SIM_BUS_PORT;
+	TEST_CHECK(DS18B20_Init(&sensor) == OK);
+	TEST_CHECK(DS18B20_Ring_Init(&ring, buffer, 32U));
+	scheduler.sensor = &sensor;
+	scheduler.entries = entries;
+	scheduler.count = TEST_ENTRIES;
+	scheduler.batch_window_ms = TEST_WINDOW;
+	scheduler.ring = &ring;
+	TEST_CHECK(DS18B20_Scheduler_Init(&scheduler) == OK);
+	TEST_CHECK(Sim_Devices[1].scratchpad[4] == DS18B20_RESOLUTION_TO_CONFIG(9U));
+	Sim_OnConvert = test_scheduler_convert;
+
+	// All due: one broadcast conversion, every sample stamped at its end
+	TEST_CHECK(test_scheduler_batch(samples, &start) == TEST_ENTRIES);
+	TEST_CHECK(converted == TEST_ENTRIES);
+	for (uint16_t i = 0; i < TEST_ENTRIES; i++)
+	{
+		TEST_CHECK((samples[i].slot == i) && (samples[i].status == DS18B20_SAMPLE_OK));
+		TEST_CHECK(samples[i].value == (int16_t)(320 + (16 * i)));
+		TEST_CHECK(samples[i].timestamp == samples[0].timestamp);
+	}
+	TEST_CHECK((samples[0].timestamp - start) >= DS18B20_ResolutionTime(12U));
+
+	// Earliest deadline, with the entry due within the window: started by increasing
+	// resolution, and stamped at the end of the longest conversion
+	TEST_CHECK(test_scheduler_batch(samples, &start) == 3U);
+	TEST_CHECK(converted == 3U);
+	TEST_CHECK((order[0] == 1U) && (order[1] == 2U) && (order[2] == 0U));
+	TEST_CHECK((samples[0].slot == 0U) && (samples[1].slot == 1U) && (samples[2].slot == 2U));
+	TEST_CHECK((samples[0].timestamp == samples[1].timestamp) && (samples[1].timestamp == samples[2].timestamp));
+	TEST_CHECK((samples[0].timestamp - start) >= DS18B20_ResolutionTime(12U));
+	TEST_CHECK((samples[0].timestamp - start) < (DS18B20_ResolutionTime(12U) + DS18B20_ResolutionTime(9U)));
+
+	// Then the entry with the longer period, alone
+	TEST_CHECK(test_scheduler_batch(samples, &start) == 1U);
+	TEST_CHECK((converted == 1U) && (order[0] == 3U) && (samples[0].slot == 3U));
+	TEST_CHECK((samples[0].timestamp - start) >= DS18B20_ResolutionTime(11U));
+
+	// The deadlines keep their period from the first one
+	TEST_CHECK((entries[3].next_due - entries[0].next_due) == 2000U);
+
+	printf("test_scheduler: %u errors\n", errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
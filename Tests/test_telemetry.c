@@ -0,0 +1,191 @@
+/******************************************************************************************* */
+/*                                                                                           */
+/* test_telemetry.c                                                                          */
+/*                                                                                           */
+/* Host test of the telemetry frames, decoded by Tools/ds18b20_telemetry.py                  */
+/*                                                                                           */
+/* Florian TOPEZA & Merlin KOOSHMANIAN - 2025                                                */
+/*                                                                                           */
+/******************************************************************************************* */
+
+#include <stdio.h>
+
+#include "ds18b20_telemetry.h"
+#include "hal_sim.h"
+
+//!\ The frames built by DS18B20_telemetry.c are written to a capture file, and the samples
+//!\ they shall hold to a text file, in the format printed by the decoder: "make test" runs
+//!\ ds18b20_telemetry.py on the capture and compares its output with the text file.
+
+/******************************* DEFINE BEGIN ********************************************** */
+
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+			errors++; \
+		} \
+	} while (0)
+
+// Near the end of the uint32 range, to check the byte order of the timestamps
+#define TEST_TIMESTAMP	4294000000UL
+
+/*********************************** DEFINE END ******************************************** */
+
+static unsigned errors;
+static UART_HandleTypeDef huart;
+static DS18B20_Telemetry_t telemetry;
+static uint32_t transfers;
+
+static const char *const test_status[] = {"OK", "NO_PRESENCE", "CRC_ERROR", "TIMEOUT", "INVALID", "FAULT"};
+
+/* End of a DMA transfer, as HAL_UART_TxCpltCallback */
+static void test_telemetry_complete(void)
+{
+	if (Sim_UartComplete())
+	{
+		transfers++;
+		DS18B20_Telemetry_TxComplete(&telemetry, &huart);
+	}
+}
+
+/* Deliver a sample, and write the line the decoder shall print for it if it was not dropped */
+static void test_telemetry_deliver(FILE *expected, const DS18B20_Sample_t *sample)
+{
+	uint32_t overruns = telemetry.overruns;
+
+	DS18B20_Telemetry_Deliver(&telemetry, sample);
+
+	if (telemetry.overruns == overruns)
+	{
+		// The frame of the sample was closed if it became full
+		bool closed = (telemetry.count == 0U) || atomic_load(&telemetry.ready);
+		uint16_t sequence = closed ? (uint16_t)(telemetry.sequence - 1U) : telemetry.sequence;
+
+		fprintf(expected, "%5u %10.3f bus %u slot %3u %8.4f %s\n", (unsigned)sequence,
+		        (double)sample->timestamp / 1000.0, (unsigned)sample->bus, (unsigned)sample->slot,
+		        (double)sample->value / 16.0, test_status[sample->status]);
+	}
+}
+
+/* Sweeps of sample_count samples 1 s apart, the DMA ending every period samples */
+static void test_telemetry_sweeps(FILE *expected, uint32_t first, uint32_t sweeps, uint32_t period)
+{
+	uint32_t delivered = 0;
+
+	for (uint32_t sweep = first; sweep < (first + sweeps); sweep++)
+	{
+		uint16_t sample_count = (uint16_t)(((sweep * 37U) % 120U) + 1U);
+
+		for (uint16_t slot = 0; slot < sample_count; slot++)
+		{
+			DS18B20_Sample_t sample = {0};
+
+			sample.timestamp = TEST_TIMESTAMP + (sweep * 1000U) + 7U;
+			sample.slot = (uint16_t)(slot * 5U);
+			sample.value = (int16_t)((((int32_t)sweep * 131) + ((int32_t)slot * 29)) % 2880 - 880);
+			sample.status = (uint8_t)((sweep + slot) % 6U);
+			sample.bus = (uint8_t)(slot % 16U);
+
+			test_telemetry_deliver(expected, &sample);
+
+			if ((++delivered % period) == 0U)
+			{
+				test_telemetry_complete();
+			}
+		}
+	}
+}
+
+/* Single samples 1 s apart across the wrap of the HAL tick: one frame per time window */
+static void test_telemetry_window(FILE *expected)
+{
+	DS18B20_Sample_t sample = {0};
+	uint32_t first = UINT32_MAX - 4000U;
+	uint16_t sequence = 0;
+
+	// Previous frames sent
+	for (uint8_t tries = 0; (tries < 3U) && (DS18B20_Telemetry_Flush(&telemetry) != 0U); tries++)
+	{
+		test_telemetry_complete();
+	}
+	test_telemetry_complete();
+	sequence = telemetry.sequence;
+
+	for (uint32_t delta = 0; delta <= DS18B20_TELEMETRY_WINDOW_MS; delta += 1000U)
+	{
+		sample.timestamp = first + delta;
+		sample.slot = (uint16_t)(delta / 1000U);
+		sample.value = (int16_t)(320 + sample.slot);
+		test_telemetry_deliver(expected, &sample);
+	}
+	TEST_CHECK((telemetry.count == ((DS18B20_TELEMETRY_WINDOW_MS / 1000U) + 1U)) && (telemetry.sequence == sequence));
+
+	// Out of the window, then earlier than the first sample of the frame
+	sample.timestamp = first + DS18B20_TELEMETRY_WINDOW_MS + 1U;
+	test_telemetry_deliver(expected, &sample);
+	TEST_CHECK((telemetry.count == 1U) && (telemetry.sequence == (uint16_t)(sequence + 1U)));
+	test_telemetry_complete();
+
+	sample.timestamp = first;
+	test_telemetry_deliver(expected, &sample);
+	TEST_CHECK((telemetry.count == 1U) && (telemetry.sequence == (uint16_t)(sequence + 2U)));
+	test_telemetry_complete();
+}
+
+int main(int argc, char *argv[])
+{
+	const char *capture_name = (argc > 1) ? argv[1] : "build/telemetry.bin";
+	const char *expected_name = (argc > 2) ? argv[2] : "build/telemetry.txt";
+	FILE *expected = fopen(expected_name, "w");
+	FILE *capture = NULL;
+
+	TEST_CHECK(expected != NULL);
+	if (expected == NULL)
+	{
+		return 1;
+	}
+
+	TEST_CHECK(DS18B20_Telemetry_Init(&telemetry, &huart) == OK);
+	TEST_CHECK(DS18B20_Telemetry_Init(&telemetry, NULL) == NULL_POINTER);
+
+	// Fast host: the DMA ends after each sample, nothing is dropped
+	test_telemetry_sweeps(expected, 0, 30, 1);
+	TEST_CHECK(telemetry.overruns == 0U);
+
+	// Slow host: both buffers are in use, samples are dropped but the frames stay whole
+	test_telemetry_sweeps(expected, 30, 30, 150);
+	TEST_CHECK(telemetry.overruns != 0U);
+
+	test_telemetry_window(expected);
+
+	// Last frame, which may wait for the transfer of the previous one
+	for (uint8_t tries = 0; (tries < 3U) && (DS18B20_Telemetry_Flush(&telemetry) != 0U); tries++)
+	{
+		test_telemetry_complete();
+	}
+	test_telemetry_complete();
+
+	TEST_CHECK(DS18B20_Telemetry_Flush(&telemetry) == 0U);
+	TEST_CHECK(telemetry.count == 0U);
+	TEST_CHECK(telemetry.frames == transfers);
+	TEST_CHECK(telemetry.frames == telemetry.sequence);
+
+	fclose(expected);
+
+	capture = fopen(capture_name, "wb");
+	TEST_CHECK(capture != NULL);
+	if (capture != NULL)
+	{
+		TEST_CHECK(fwrite(Sim_UartCapture, 1, Sim_UartLength, capture) == Sim_UartLength);
+		fclose(capture);
+	}
+
+	printf("test_telemetry: %u frames, %lu samples dropped, %u errors\n", (unsigned)telemetry.frames,
+	       (unsigned long)telemetry.overruns, errors);
+
+	return (errors == 0U) ? 0 : 1;
+}
+
+/********************************** END OF FILE ******************************************** */
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+#
+# ds18b20_logdecode.py
+#
+# Decode the binary records sent by DS18B20_Log_Drain back to the driver messages
+#
+# Florian TOPEZA & Merlin KOOSHMANIAN - 2025
+#
+# The formats are read from DS18B20_LOG_FORMATS and the <ID>_FMT macros of
+# Inc/ds18b20_log.h, so that the decoder always matches the firmware it was built
+# with. A record is 32-bit words, little-endian: sync (0xDB) | count | ID, HAL tick (ms),
+# then count arguments. If the bytes do not start a valid record, the decoder skips one
+# byte and looks for a sync again.
+#
+# Usage: ds18b20_logdecode.py capture.bin [--header Inc/ds18b20_log.h]
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SYNC = 0xDB
+
+IDENTIFIER = re.compile(r'X\(\s*(\w+)\s*\)')
+FORMAT = re.compile(r'#define\s+(\w+)_FMT\s+"((?:[^"\\]|\\.)*)"')
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(l{0,2})([diuxXc%])')
+
+
+def read_formats(path):
+    """List of the formats, in the order of DS18B20_LogId_t"""
+    with open(path) as header:
+        text = header.read()
+    start = text.index('#define DS18B20_LOG_FORMATS')
+    end = text.index('\n\n', start)
+    strings = dict(FORMAT.findall(text))
+    formats = []
+    for identifier in IDENTIFIER.findall(text[start:end]):
+        formats.append(strings[identifier].encode().decode('unicode_escape'))
+    return formats
+
+
+def render(string, arguments):
+    """printf with 32-bit arguments: %d and %i are signed, the other ones unsigned"""
+    values = iter(arguments)
+
+    def convert(match):
+        flags, _, kind = match.group(1), match.group(2), match.group(3)
+        if kind == '%':
+            return '%'
+        value = next(values, 0)
+        if kind in 'di':
+            value = value - (1 << 32) if value & 0x80000000 else value
+            kind = 'd'
+        elif kind == 'u':
+            kind = 'd'
+        return ('%' + flags + kind) % value
+
+    return CONVERSION.sub(convert, string)
+
+
+def decode(data, formats, output):
+    index = 0
+    skipped = 0
+    while index + 8 <= len(data):
+        header, tick = struct.unpack_from('<II', data, index)
+        identifier, count = header & 0xFF, (header >> 8) & 0xFF
+        if (header >> 24) != SYNC or (header >> 16) & 0xFF or identifier >= len(formats) \
+                or index + 4 * (2 + count) > len(data):
+            index += 1
+            skipped += 1
+            continue
+        arguments = struct.unpack_from('<%dI' % count, data, index + 8)
+        message = render(formats[identifier], arguments).rstrip('\r\n')
+        output.write('%10.3f %s\n' % (tick / 1000.0, message))
+        index += 4 * (2 + count)
+    if skipped:
+        sys.stderr.write('%d bytes skipped\n' % skipped)
+
+
+def main():
+    default = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'Inc', 'ds18b20_log.h')
+    parser = argparse.ArgumentParser(description='Decode the DS18B20 deferred log')
+    parser.add_argument('input', help='binary capture of the output of DS18B20_Log_Drain')
+    parser.add_argument('--header', default=default, help='ds18b20_log.h of the firmware')
+    args = parser.parse_args()
+
+    formats = read_formats(args.header)
+    with open(args.input, 'rb') as capture:
+        decode(capture.read(), formats, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+#
+# ds18b20_telemetry.py
+#
+# Decode the binary telemetry frames sent by DS18B20_telemetry.c
+#
+# Florian TOPEZA & Merlin KOOSHMANIAN - 2025
+#
+# Frame, little-endian: sync (A5 5A), length, seq, timestamp, count, count entries of
+# slot / value (Q12.4) / bus << 4 | status / delta (ms from the timestamp), CRC16 CCITT
+# (initial value 0xFFFF) over length to the last entry. The decoder looks for the sync bytes, and skips one byte whenever the
+# length or the CRC is wrong. A gap in the sequence numbers means frames were lost.
+#
+# Usage: ds18b20_telemetry.py capture.bin
+#        ds18b20_telemetry.py /dev/ttyACM0 --baud 115200   (needs pyserial)
+#        ds18b20_telemetry.py --loopback                   (encode and decode test frames)
+#        ds18b20_telemetry.py capture.bin --expect samples.txt
+#                                   (compare the decoded samples, see Tests/test_telemetry.c)
+
+import argparse
+import io
+import random
+import struct
+import sys
+
+SYNC = b'\xa5\x5a'
+HEADER = struct.Struct('<2sHHIB')   # sync, length, seq, timestamp, count
+ENTRY = struct.Struct('<HhBH')       # slot, value, bus << 4 | status, delta
+CRC_SIZE = 2
+
+STATUS = ('OK', 'NO_PRESENCE', 'CRC_ERROR', 'TIMEOUT', 'INVALID', 'FAULT')
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def encode(seq, timestamp, entries):
+    """Build a frame like DS18B20_Telemetry_Close, entries are (slot, value, status, bus, delta)"""
+    body = b''.join(ENTRY.pack(slot, value, (bus << 4) | status, delta)
+                    for slot, value, status, bus, delta in entries)
+    length = HEADER.size - 4 + len(body)
+    frame = HEADER.pack(SYNC, length, seq, timestamp, len(entries)) + body
+    return frame + struct.pack('<H', crc16(frame[2:]))
+
+
+class Decoder:
+    """Incremental decoder: feed bytes, get (seq, timestamp, entries) frames
+
+    The time of an entry is (timestamp + delta) & 0xFFFFFFFF, the HAL tick wrapping."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.skipped = 0
+        self.lost = 0
+        self.last_seq = None
+
+    def feed(self, data):
+        self.buffer.extend(data)
+        frames = []
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                keep = 1 if self.buffer.endswith(SYNC[:1]) else 0
+                self.skipped += len(self.buffer) - keep
+                del self.buffer[:len(self.buffer) - keep]
+                break
+            self.skipped += start
+            del self.buffer[:start]
+            if len(self.buffer) < HEADER.size:
+                break
+            _, length, seq, timestamp, count = HEADER.unpack_from(self.buffer)
+            if length != HEADER.size - 4 + count * ENTRY.size:
+                del self.buffer[:1]
+                self.skipped += 1
+                continue
+            size = 4 + length + CRC_SIZE
+            if len(self.buffer) < size:
+                break
+            (crc,) = struct.unpack_from('<H', self.buffer, 4 + length)
+            if crc != crc16(self.buffer[2:4 + length]):
+                del self.buffer[:1]
+                self.skipped += 1
+                continue
+            entries = []
+            for i in range(count):
+                slot, value, byte, delta = ENTRY.unpack_from(self.buffer, HEADER.size + i * ENTRY.size)
+                entries.append((slot, value, byte & 0x0F, byte >> 4, delta))
+            if self.last_seq is not None:
+                self.lost += (seq - self.last_seq - 1) & 0xFFFF
+            self.last_seq = seq
+            frames.append((seq, timestamp, entries))
+            del self.buffer[:size]
+        return frames
+
+
+def show(frames, output):
+    for seq, timestamp, entries in frames:
+        for slot, value, status, bus, delta in entries:
+            name = STATUS[status] if status < len(STATUS) else str(status)
+            output.write('%5d %10.3f bus %d slot %3d %8.4f %s\n' % (
+                seq, ((timestamp + delta) & 0xFFFFFFFF) / 1000.0, bus, slot, value / 16.0, name))
+
+
+def loopback():
+    """Encode random frames with noise in between, decode them and compare"""
+    rng = random.Random(1)
+    sent = []
+    stream = bytearray()
+    for seq in range(200):
+        entries = [(rng.randrange(64), rng.randrange(-880, 2000), rng.randrange(6), rng.randrange(4),
+                    rng.randrange(10001)) for _ in range(rng.randrange(49))]
+        frame = encode(seq, 1000 * seq, entries)
+        if seq % 50 == 7:
+            frame = frame[:-1] + bytes([frame[-1] ^ 0xFF])   # corrupted: must be dropped
+        else:
+            sent.append((seq, 1000 * seq, entries))
+        stream += bytes(rng.randrange(256) for _ in range(rng.randrange(4))) + frame
+
+    decoder = Decoder()
+    received = []
+    for i in range(0, len(stream), 37):   # arbitrary chunks, as from a serial port
+        received += decoder.feed(stream[i:i + 37])
+
+    ok = received == sent and decoder.lost == 4
+    sys.stdout.write('loopback: %d frames sent, %d received, %d lost, %d bytes skipped: %s\n' % (
+        len(sent), len(received), decoder.lost, decoder.skipped, 'OK' if ok else 'FAILED'))
+    return 0 if ok else 1
+
+
+def expect(name, capture, decoder):
+    """Decode a capture of the C encoder and compare it with the samples it shall hold"""
+    output = io.StringIO()
+    show(decoder.feed(capture), output)
+    with open(name) as expected:
+        wanted = expected.read()
+    ok = output.getvalue() == wanted and decoder.lost == 0 and decoder.skipped == 0 and not decoder.buffer
+    if not ok:
+        for number, (got, line) in enumerate(zip(output.getvalue().splitlines() + [''], wanted.splitlines() + [''])):
+            if got != line:
+                sys.stdout.write('line %d: decoded "%s", expected "%s"\n' % (number + 1, got, line))
+                break
+    sys.stdout.write('telemetry: %d samples decoded, %d frames lost, %d bytes skipped: %s\n' % (
+        output.getvalue().count('\n'), decoder.lost, decoder.skipped, 'OK' if ok else 'FAILED'))
+    return 0 if ok else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode the DS18B20 telemetry frames')
+    parser.add_argument('input', nargs='?', help='binary capture, or serial port with --baud')
+    parser.add_argument('--baud', type=int, help='read a serial port at this baud rate')
+    parser.add_argument('--loopback', action='store_true', help='check the encoder and the decoder')
+    parser.add_argument('--expect', help='compare the decoded samples with this text file')
+    args = parser.parse_args()
+
+    if args.loopback:
+        return loopback()
+    if args.input is None:
+        parser.error('an input is required')
+
+    decoder = Decoder()
+    if args.expect:
+        with open(args.input, 'rb') as capture:
+            return expect(args.expect, capture.read(), decoder)
+    if args.baud:
+        import serial
+        with serial.Serial(args.input, args.baud, timeout=1) as port:
+            while True:
+                show(decoder.feed(port.read(256)), sys.stdout)
+                sys.stdout.flush()
+    else:
+        with open(args.input, 'rb') as capture:
+            show(decoder.feed(capture.read()), sys.stdout)
+    sys.stderr.write('%d frames lost, %d bytes skipped\n' % (decoder.lost, decoder.skipped))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
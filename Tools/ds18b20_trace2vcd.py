@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+#
+# ds18b20_trace2vcd.py
+#
+# Convert a trace printed by DS18B20_Trace_Dump to a VCD file for GTKWave
+#
+# Florian TOPEZA & Merlin KOOSHMANIAN - 2025
+#
+# The line level is rebuilt from the start of each operation and the nominal slot
+# timings of the driver. For each bus, the "slack" signal gives the idle time between
+# the end of an operation and the start of the next one: a long slack inside a
+# transaction shows that the driver was preempted.
+#
+# Usage: ds18b20_trace2vcd.py capture.txt [-o trace.vcd] [--bits 32]
+
+import argparse
+import re
+import sys
+
+# Record types, as in DS18B20_TraceType_t
+RESET, WRITE, READ, SEARCH, CRC = range(5)
+
+SEARCH_BIT = 0x0100
+SEARCH_CONFLICT = 0x0200
+SEARCH_ERROR = 0x0400
+
+# Nominal timings of the driver, in µs (DS18B20_Start, DS18B20_write0/1, DS18B20_read)
+RESET_LOW, RESET_TOTAL = 480, 960
+SLOT = 65
+WRITE1_LOW, WRITE0_LOW, READ_LOW, READ_SAMPLE = 5, 60, 3, 13
+
+RECORD = re.compile(r'^([0-9a-fA-F]{8}) (\d+) (\d+) ([0-9a-fA-F]{4})\s*$')
+
+
+def read_records(lines, bits):
+    """Parse the dump, and unwrap the timer counter"""
+    records = []
+    wrap = 1 << bits
+    offset = 0
+    last = None
+    for line in lines:
+        match = RECORD.match(line.strip())
+        if match is None:
+            continue
+        raw = int(match.group(1), 16) & (wrap - 1)
+        if last is not None and raw < last:
+            offset += wrap
+        last = raw
+        records.append((raw + offset, int(match.group(2)), int(match.group(3)), int(match.group(4), 16)))
+    return records
+
+
+def slots(kind, data):
+    """Master slots of an operation: list of (offset, low time, bit read or None)"""
+    result = []
+    if kind in (WRITE, READ):
+        for i in range(8):
+            bit = (data >> i) & 1
+            if kind == WRITE:
+                result.append((i * SLOT, WRITE1_LOW if bit else WRITE0_LOW, None))
+            else:
+                result.append((i * SLOT, READ_LOW, bit))
+    elif kind == SEARCH:
+        direction = 1 if data & SEARCH_BIT else 0
+        result.append((0, READ_LOW, None))
+        result.append((SLOT, READ_LOW, None))
+        if not data & SEARCH_ERROR:
+            result.append((2 * SLOT, WRITE1_LOW if direction else WRITE0_LOW, None))
+    return result
+
+
+def duration(kind, data):
+    if kind == RESET:
+        return RESET_TOTAL
+    if kind in (WRITE, READ):
+        return 8 * SLOT
+    if kind == SEARCH:
+        return 2 * SLOT if data & SEARCH_ERROR else 3 * SLOT
+    return 0
+
+
+def convert(records, output):
+    buses = sorted({bus for _, bus, _, _ in records})
+    changes = []  # (time, identifier, value)
+    ids = {}
+    for index, bus in enumerate(buses):
+        base = chr(33 + 6 * index)
+        ids[bus] = {name: chr(ord(base) + k) for k, name in
+                    enumerate(('line', 'rx', 'byte', 'presence', 'crc_error', 'slack'))}
+
+    end = {}
+    for time, bus, kind, data in records:
+        sig = ids[bus]
+        if bus in end:
+            changes.append((time, sig['slack'], 'r%d' % max(0, time - end[bus])))
+        end[bus] = time + duration(kind, data)
+
+        if kind == RESET:
+            changes.append((time, sig['line'], '0'))
+            changes.append((time + RESET_LOW, sig['line'], '1'))
+            changes.append((time + RESET_LOW, sig['presence'], str(data & 1)))
+        elif kind == CRC:
+            changes.append((time, sig['crc_error'], str(data & 1)))
+        else:
+            for offset, low, bit in slots(kind, data):
+                changes.append((time + offset, sig['line'], '0'))
+                changes.append((time + offset + low, sig['line'], '1'))
+                if bit is not None:
+                    changes.append((time + offset + READ_SAMPLE, sig['rx'], str(bit)))
+            if kind in (WRITE, READ):
+                changes.append((time, sig['byte'], 'b{:08b}'.format(data & 0xFF)))
+
+    output.write('$timescale 1us $end\n')
+    for bus in buses:
+        sig = ids[bus]
+        output.write('$scope module bus%d $end\n' % bus)
+        output.write('$var wire 1 %s line $end\n' % sig['line'])
+        output.write('$var wire 1 %s rx $end\n' % sig['rx'])
+        output.write('$var wire 8 %s byte $end\n' % sig['byte'])
+        output.write('$var wire 1 %s presence $end\n' % sig['presence'])
+        output.write('$var wire 1 %s crc_error $end\n' % sig['crc_error'])
+        output.write('$var real 64 %s slack $end\n' % sig['slack'])
+        output.write('$upscope $end\n')
+    output.write('$enddefinitions $end\n')
+
+    start = records[0][0] if records else 0
+    output.write('#0\n$dumpvars\n')
+    for bus in buses:
+        sig = ids[bus]
+        output.write('1%s\nx%s\nbxxxxxxxx %s\nx%s\n0%s\nr0 %s\n' % (
+            sig['line'], sig['rx'], sig['byte'], sig['presence'], sig['crc_error'], sig['slack']))
+    output.write('$end\n')
+
+    current = None
+    for time, identifier, value in sorted(changes, key=lambda change: change[0]):
+        if time != current:
+            output.write('#%d\n' % (time - start))
+            current = time
+        if value[0] in 'br':
+            output.write('%s %s\n' % (value, identifier))
+        else:
+            output.write('%s%s\n' % (value, identifier))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a DS18B20 trace dump to VCD')
+    parser.add_argument('input', help='console capture holding the output of DS18B20_Trace_Dump')
+    parser.add_argument('-o', '--output', help='VCD file, standard output by default')
+    parser.add_argument('--bits', type=int, default=32, help='width of the timer counter (16 or 32)')
+    args = parser.parse_args()
+
+    with open(args.input) as capture:
+        records = read_records(capture, args.bits)
+
+    if args.output:
+        with open(args.output, 'w') as output:
+            convert(records, output)
+    else:
+        convert(records, sys.stdout)
+
+    worst = {}
+    for (time, bus, kind, data), (next_time, next_bus, next_kind, _) in zip(records, records[1:]):
+        # Only within a transaction: a reset may follow a conversion wait
+        if bus == next_bus and kind != CRC and next_kind != RESET:
+            slack = next_time - time - duration(kind, data)
+            worst[bus] = max(worst.get(bus, 0), slack)
+    for bus, slack in sorted(worst.items()):
+        sys.stderr.write('bus %d: %d records, largest slack %d us\n' % (
+            bus, sum(1 for record in records if record[1] == bus), slack))
+
+
+if __name__ == '__main__':
+    main()